@@ -63,6 +63,7 @@ Character2D::Character2D(Context *context) :
     // Set true once hit ground
     isReady_ = false;
     doJump_ = true;
+    jumpPressed_ = false;
 
 }
 
@@ -148,56 +149,7 @@ void Character2D::Update(float timeStep) {
     bool idle = (!currState_.walk && !currState_.jump);
 
     // Set animation state
-    auto *cache = GetSubsystem<ResourceCache>();
-    auto *model = node_->GetComponent<AnimatedModel>(true);
-
-    String walkAnimStr = "";
-    String idleAnimStr = "";
-    String jumpAnimStr = "";
-    String attackAnimStr = "";
-
-    //sprite1_0008_Walking0010017_WushuKicks001.ani
-    //sprite1_0008_Walking0010008_Walking001.ani
-    //sprite1_0008_Walking0010018_DanceTurns001.ani
-
-    switch (type_) {
-        case 1:
-
-            ///code/dev/MayaSpace/src/Urho3D/bin/Data/Models/spriteBase/Models/0008_Walking001_0008_Walking001_0018_DanceTurns001_0008_Walking.ani
-            walkAnimStr = "Models/spriteBase/Models/Movements.ani";
-
-            idleAnimStr = jumpAnimStr = attackAnimStr = walkAnimStr;
-            //  walkAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
-//            idleAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
-            //           jumpAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010018_DanceTurns001.ani";
-            //          attackAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010017_WushuKicks001.ani";
-            break;
-        case 2:
-//            walkAnimStr = "Models/spriteBase/Models/0008_Walking001_0008_Walking001_0018_DanceTurns001_0008_Walking.ani";
-            walkAnimStr = "Models/spriteBase/Models/Movements.ani";
-
-            idleAnimStr = jumpAnimStr = attackAnimStr = walkAnimStr;
-
-            // walkAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
-//            idleAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
-//            jumpAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010018_DanceTurns001.ani";
-            //           attackAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010017_WushuKicks001.ani";
-            break;
-
-    }
-
-    auto *walkAnimation = cache->GetResource<Animation>(walkAnimStr);
-    auto *idleAnimation = cache->GetResource<Animation>(idleAnimStr);
-    auto *jumpAnimation = cache->GetResource<Animation>(jumpAnimStr);
-    auto *kickAnimation = cache->GetResource<Animation>(attackAnimStr);
-
-    // model->RemoveAllAnimationStates(); // -> this clears the timesteps also
-
-    // AddAnimationState includes an existence check
-    walkState_ = model->AddAnimationState(walkAnimation);
-    idleState_ = model->AddAnimationState(idleAnimation);
-    jumpState_ = model->AddAnimationState(jumpAnimation);
-    kickState_ = model->AddAnimationState(kickAnimation);
+    InitAnimationStates();
 
 
     if (currState_.walk) {
@@ -323,6 +275,59 @@ void Character2D::Update(float timeStep) {
     }
 }
 
+void Character2D::InitAnimationStates() {
+    auto *cache = GetSubsystem<ResourceCache>();
+    auto *model = node_->GetComponent<AnimatedModel>(true);
+
+    String walkAnimStr = "";
+    String idleAnimStr = "";
+    String jumpAnimStr = "";
+    String attackAnimStr = "";
+
+    //sprite1_0008_Walking0010017_WushuKicks001.ani
+    //sprite1_0008_Walking0010008_Walking001.ani
+    //sprite1_0008_Walking0010018_DanceTurns001.ani
+
+    switch (type_) {
+        case 1:
+
+            ///code/dev/MayaSpace/src/Urho3D/bin/Data/Models/spriteBase/Models/0008_Walking001_0008_Walking001_0018_DanceTurns001_0008_Walking.ani
+            walkAnimStr = "Models/spriteBase/Models/Movements.ani";
+
+            idleAnimStr = jumpAnimStr = attackAnimStr = walkAnimStr;
+            //  walkAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
+//            idleAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
+            //           jumpAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010018_DanceTurns001.ani";
+            //          attackAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010017_WushuKicks001.ani";
+            break;
+        case 2:
+//            walkAnimStr = "Models/spriteBase/Models/0008_Walking001_0008_Walking001_0018_DanceTurns001_0008_Walking.ani";
+            walkAnimStr = "Models/spriteBase/Models/Movements.ani";
+
+            idleAnimStr = jumpAnimStr = attackAnimStr = walkAnimStr;
+
+            // walkAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
+//            idleAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010008_Walking001.ani";
+//            jumpAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010018_DanceTurns001.ani";
+            //           attackAnimStr = "Models/spritePlayerA/sprite1_0008_Walking0010017_WushuKicks001.ani";
+            break;
+
+    }
+
+    auto *walkAnimation = cache->GetResource<Animation>(walkAnimStr);
+    auto *idleAnimation = cache->GetResource<Animation>(idleAnimStr);
+    auto *jumpAnimation = cache->GetResource<Animation>(jumpAnimStr);
+    auto *kickAnimation = cache->GetResource<Animation>(attackAnimStr);
+
+    // model->RemoveAllAnimationStates(); // -> this clears the timesteps also
+
+    // AddAnimationState includes an existence check
+    walkState_ = model->AddAnimationState(walkAnimation);
+    idleState_ = model->AddAnimationState(idleAnimation);
+    jumpState_ = model->AddAnimationState(jumpAnimation);
+    kickState_ = model->AddAnimationState(kickAnimation);
+}
+
 PlayerState Character2D::HandleP1Controller(float timeStep) {
     auto *input = GetSubsystem<Input>();
 
@@ -394,8 +399,9 @@ PlayerState Character2D::HandleP1Controller(float timeStep) {
 
         // Jump
         if ((currState_.onGround || aboveClimbable_) &&
-            (input->GetKeyPress('W') || input->GetKeyPress(KEY_UP) || controls_.IsDown(BUTTON_A)))
+            (jumpPressed_ || controls_.IsDown(BUTTON_A)))
             currState_.jump = true;
+        jumpPressed_ = false;
 
         // END GAME CONTROLS
 
@@ -564,8 +570,9 @@ PlayerState Character2D::HandleAIController(float timeStep) {
 
             // Jump
             if ((currState_.onGround || aboveClimbable_) &&
-                (input->GetKeyPress('W') || input->GetKeyPress(KEY_UP) || controls_.IsDown(BUTTON_A)))
+                (jumpPressed_ || controls_.IsDown(BUTTON_A)))
                 currState_.jump = true;
+            jumpPressed_ = false;
 
             // END GAME CONTROLS
         }
@@ -58,6 +58,8 @@ public:
 
     /// Handle update. Called by LogicComponent base class.
     void Update(float timeStep) override;
+    /// Look up the character's animations and make sure their states exist on the model.
+    void InitAnimationStates();
     /// Handle player state/behavior when wounded.
     void HandleWoundedState(float timeStep);
     /// Handle death of the player.
@@ -85,6 +87,8 @@ public:
     int life_;
 
     bool doJump_;
+    /// Jump key pressed since the last controller update. Latched once per frame before the scene update, so that a press is consumed by exactly one simulation step.
+    bool jumpPressed_;
     AnimationState* walkState_; 
     AnimationState* idleState_;
     AnimationState* jumpState_;
@@ -0,0 +1,353 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Graphics/AnimatedModel.h>
+#include <Urho3D/Graphics/AnimationState.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+#include <Urho3D/Urho2D/PhysicsWorld2D.h>
+#include <Urho3D/Urho2D/RigidBody2D.h>
+
+#include <MayaSpace/ai/evolution_manager.h>
+
+#include "Character2DBatch.h"
+
+Character2DBatch::Character2DBatch(Context* context) :
+    Object(context)
+{
+}
+
+void Character2DBatch::SetScene(Scene* scene)
+{
+    if (scene == scene_)
+        return;
+
+    if (scene_)
+        UnsubscribeFromEvent(scene_, E_SCENEUPDATE);
+
+    scene_ = scene;
+
+    if (scene_)
+        SubscribeToEvent(scene_, E_SCENEUPDATE, URHO3D_TYPED_HANDLER(Character2DBatch, HandleSceneUpdate));
+}
+
+void Character2DBatch::AddCharacter(Character2D* character)
+{
+    if (!character || !character->GetNode())
+        return;
+
+    // The batch takes over the per-instance update
+    character->SetUpdateEventMask(character->GetUpdateEventMask() & ~USE_UPDATE);
+    character->InitAnimationStates();
+
+    const PlayerState& playerState = character->currState_;
+    AgentState2D state;
+    state.position_ = character->GetNode()->GetWorldPosition();
+    state.playerPos_ = character->playerPos_;
+    state.moveDir_ = playerState.moveDir;
+    state.flags_ = 0;
+    if (playerState.onGround)
+        state.flags_ |= AGENT_ON_GROUND;
+    if (playerState.walk)
+        state.flags_ |= AGENT_WALK;
+    if (playerState.kick)
+        state.flags_ |= AGENT_KICK;
+    if (character->forward_)
+        state.flags_ |= AGENT_FORWARD;
+    if (character->chooseMove_)
+        state.flags_ |= AGENT_CHOOSE_MOVE;
+    if (character->doMove_)
+        state.flags_ |= AGENT_DO_MOVE;
+    if (character->doJump_)
+        state.flags_ |= AGENT_DO_JUMP;
+    if (character->isReady_)
+        state.flags_ |= AGENT_READY;
+    state.currMove_ = character->currMove_;
+    state.lastMove_ = character->lastMove_;
+    state.lastWalk_ = playerState.lastWalk;
+    state.lastJump_ = playerState.lastJump;
+    state.lastKick_ = playerState.lastKick;
+    state.heading_ = character->heading_;
+    state.agentIndex_ = character->agentIndex;
+
+    characters_.Push(WeakPtr<Character2D>(character));
+    bodies_.Push(character->GetComponent<RigidBody2D>());
+    models_.Push(character->GetNode()->GetComponent<AnimatedModel>(true));
+    states_.Push(state);
+}
+
+void Character2DBatch::Clear()
+{
+    for (unsigned i = 0; i < characters_.Size(); ++i)
+    {
+        if (characters_[i])
+            characters_[i]->SetUpdateEventMask(characters_[i]->GetUpdateEventMask() | USE_UPDATE);
+    }
+
+    characters_.Clear();
+    bodies_.Clear();
+    models_.Clear();
+    states_.Clear();
+}
+
+void Character2DBatch::Update(float timeStep)
+{
+    if (!scene_)
+        return;
+
+    URHO3D_PROFILE(UpdateCharacter2DBatch);
+
+    RemoveExpired();
+    Gather();
+    Simulate(timeStep);
+    WriteBack(timeStep);
+}
+
+void Character2DBatch::HandleSceneUpdate(StringHash eventType, SceneUpdateEventData& eventData)
+{
+    Update(eventData.timeStep_);
+}
+
+void Character2DBatch::RemoveExpired()
+{
+    for (unsigned i = characters_.Size() - 1; i < characters_.Size(); --i)
+    {
+        if (!characters_[i] || !characters_[i]->GetNode())
+        {
+            characters_.Erase(i);
+            bodies_.Erase(i);
+            models_.Erase(i);
+            states_.Erase(i);
+        }
+    }
+}
+
+void Character2DBatch::Gather()
+{
+    auto* physicsWorld = scene_->GetComponent<PhysicsWorld2D>();
+    const Vector2 characterHalfSize(0.05f, 0.05f);
+
+    for (unsigned i = 0; i < characters_.Size(); ++i)
+    {
+        Character2D* character = characters_[i];
+        AgentState2D& state = states_[i];
+
+        state.position_ = character->GetNode()->GetWorldPosition();
+        state.playerPos_ = character->playerPos_;
+
+        unsigned flags = state.flags_ & ~(AGENT_CLIMBING | AGENT_INACTIVE);
+        if (character->isClimbing_)
+            flags |= AGENT_CLIMBING;
+        if (character->killed_ || character->wounded_ || !character->IsEnabledEffective())
+            flags |= AGENT_INACTIVE;
+
+        // Collision detection (AABB query), the query result is reused between characters
+        if (!(flags & AGENT_INACTIVE) && physicsWorld)
+        {
+            Vector2 position2D(state.position_.x_, state.position_.y_);
+            groundQuery_.Clear();
+            physicsWorld->GetRigidBodies(groundQuery_, Rect(position2D - characterHalfSize - Vector2(0.0f, 0.1f),
+                position2D + characterHalfSize));
+            if (groundQuery_.Size() > 1 && !(flags & AGENT_CLIMBING))
+                flags |= AGENT_ON_GROUND;
+        }
+
+        state.flags_ = flags;
+    }
+}
+
+void Character2DBatch::Simulate(float timeStep)
+{
+    const std::vector<AgentController*>& controllers = EvolutionManager::getInstance()->getAgentControllers();
+
+    for (unsigned i = 0; i < states_.Size(); ++i)
+    {
+        AgentState2D& state = states_[i];
+        unsigned flags = state.flags_;
+        if (flags & AGENT_INACTIVE)
+            continue;
+
+        // Store previous state and reset the per-frame state
+        flags &= ~(AGENT_PREV_WALK | AGENT_JUMP);
+        if (flags & AGENT_WALK)
+            flags = (flags & ~AGENT_WALK) | AGENT_PREV_WALK;
+
+        // Process sensor inputs through ffn and apply calculated inputs
+        if (state.agentIndex_ >= 0 && (unsigned)state.agentIndex_ < controllers.size())
+        {
+            AgentController* controller = controllers[state.agentIndex_];
+            controller->update(timeStep);
+            // Set agent evaluation (affects fitness calculation)
+            controller->setCurrentCompletionReward(controller->getCurrentCompletionReward() + Random(0.0f, 1.0f));
+        }
+
+        // Let kick stay for 2 seconds
+        if (state.currMove_ - state.lastKick_ > 2.0f)
+            flags &= ~AGENT_KICK;
+        state.moveDir_ = Vector3::ZERO;
+        state.currMove_ += timeStep;
+
+        if (timeStep > 0.0f)
+        {
+            // Update AI timer for next move
+            if (state.currMove_ - state.lastMove_ > 2.0f)
+            {
+                flags |= AGENT_CHOOSE_MOVE;
+                state.lastMove_ = state.currMove_;
+            }
+
+            // Face the player
+            if (state.playerPos_.x_ < state.position_.x_)
+                flags &= ~AGENT_FORWARD;
+            else
+                flags |= AGENT_FORWARD;
+
+            if (flags & AGENT_CHOOSE_MOVE)
+            {
+                switch (Random(1, 5))
+                {
+                case 1:
+                    flags |= AGENT_WALK;
+                    state.lastWalk_ = state.currMove_;
+                    // Walking also kicks
+                case 2:
+                    flags |= AGENT_KICK;
+                    state.lastKick_ = state.currMove_;
+                    break;
+
+                case 3:
+                    flags |= AGENT_DO_JUMP;
+                    state.lastJump_ = state.currMove_;
+                    break;
+
+                default:
+                    break;
+                }
+                flags = (flags & ~AGENT_CHOOSE_MOVE) | AGENT_DO_MOVE;
+            }
+
+            // Wait for move to complete
+            if (state.currMove_ - state.lastMove_ > 2.0f)
+            {
+                state.lastMove_ = state.currMove_;
+                flags &= ~AGENT_DO_MOVE;
+            }
+            else
+            {
+                if (flags & AGENT_PREV_WALK)
+                    flags |= AGENT_WALK;
+                // If the AI is close enough, put the AI in idle mode
+                if (Abs(state.position_.x_ - state.playerPos_.x_) < 0.02f)
+                    flags &= ~AGENT_WALK;
+            }
+
+            // Slow down AI
+            if (flags & AGENT_WALK)
+                state.moveDir_ = -Vector3::FORWARD * 0.3f;
+        }
+
+        if (flags & AGENT_ON_GROUND)
+        {
+            if (flags & AGENT_DO_JUMP)
+                flags = (flags & ~AGENT_DO_JUMP) | AGENT_JUMP;
+            // Ready when near ground
+            if (state.position_.y_ < 2.0f)
+                flags |= AGENT_READY;
+        }
+
+        state.heading_ = (flags & AGENT_FORWARD) ? 270.0f : 90.0f;
+        state.flags_ = flags;
+    }
+}
+
+void Character2DBatch::WriteBack(float timeStep)
+{
+    for (unsigned i = 0; i < characters_.Size(); ++i)
+    {
+        Character2D* character = characters_[i];
+        const AgentState2D& state = states_[i];
+        const unsigned flags = state.flags_;
+
+        if (flags & AGENT_INACTIVE)
+        {
+            if (character->wounded_ && !character->killed_ && character->IsEnabledEffective())
+                character->HandleWoundedState(timeStep);
+            continue;
+        }
+
+        // Mirror the results to the component for code reading it, e.g. the contact handlers and billboards
+        character->prevState_ = character->currState_;
+        PlayerState& playerState = character->currState_;
+        playerState.onGround = (flags & AGENT_ON_GROUND) != 0;
+        playerState.jump = (flags & AGENT_JUMP) != 0;
+        playerState.walk = (flags & AGENT_WALK) != 0;
+        playerState.kick = (flags & AGENT_KICK) != 0;
+        playerState.lastWalk = state.lastWalk_;
+        playerState.lastJump = state.lastJump_;
+        playerState.lastKick = state.lastKick_;
+        playerState.moveDir = state.moveDir_;
+        character->forward_ = (flags & AGENT_FORWARD) != 0;
+        character->chooseMove_ = (flags & AGENT_CHOOSE_MOVE) != 0;
+        character->doMove_ = (flags & AGENT_DO_MOVE) != 0;
+        character->doJump_ = (flags & AGENT_DO_JUMP) != 0;
+        character->isReady_ = (flags & AGENT_READY) != 0;
+        character->currMove_ = state.currMove_;
+        character->lastMove_ = state.lastMove_;
+        character->heading_ = state.heading_;
+
+        // Update frame
+        AnimatedModel* model = models_[i];
+        if (model && timeStep > 0.0f)
+        {
+            for (AnimationState* animationState : model->GetAnimationStates())
+                animationState->AddTime(timeStep);
+        }
+
+        AnimationState* walkState = character->walkState_;
+        if (walkState)
+        {
+            if (flags & AGENT_WALK)
+            {
+                walkState->SetWeight(1.0f);
+                walkState->AddTime(timeStep);
+                walkState->SetLooped(true);
+            }
+            else
+            {
+                walkState->SetWeight(0.0f);
+                walkState->SetTime(0.0f);
+            }
+        }
+
+        // Move character
+        if (!state.moveDir_.Equals(Vector3::ZERO) || (flags & AGENT_JUMP))
+        {
+            character->GetNode()->Translate(state.moveDir_ * timeStep * 1.8f);
+
+            RigidBody2D* body = bodies_[i];
+            if ((flags & AGENT_JUMP) && body)
+                body->ApplyLinearImpulse(Vector2(0.0f, 0.005f) * MOVE_SPEED, body->GetMassCenter(), true);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <Urho3D/Core/Object.h>
+
+#include "Character2D.h"
+
+namespace Urho3D
+{
+
+class AnimatedModel;
+class RigidBody2D;
+class Scene;
+class SceneUpdateEventData;
+
+}
+
+// All Urho3D classes reside in namespace Urho3D
+using namespace Urho3D;
+
+/// Character is touching the ground.
+static const unsigned AGENT_ON_GROUND = 0x1;
+/// Character jumps this frame.
+static const unsigned AGENT_JUMP = 0x2;
+/// Character walks this frame.
+static const unsigned AGENT_WALK = 0x4;
+/// Character is kicking.
+static const unsigned AGENT_KICK = 0x8;
+/// Character walked in the previous frame.
+static const unsigned AGENT_PREV_WALK = 0x10;
+/// Character faces forward (right).
+static const unsigned AGENT_FORWARD = 0x20;
+/// A new move should be chosen.
+static const unsigned AGENT_CHOOSE_MOVE = 0x40;
+/// A chosen move is in progress.
+static const unsigned AGENT_DO_MOVE = 0x80;
+/// A jump is requested for the next time the character is on the ground.
+static const unsigned AGENT_DO_JUMP = 0x100;
+/// Character has reached the ground once and may be hit.
+static const unsigned AGENT_READY = 0x200;
+/// Character is climbing.
+static const unsigned AGENT_CLIMBING = 0x400;
+/// Character is killed or wounded and is not driven by the batch this frame.
+static const unsigned AGENT_INACTIVE = 0x800;
+
+/// AI character state packed for the batched update.
+struct AgentState2D
+{
+    /// World position.
+    Vector3 position_;
+    /// Position of the player being chased.
+    Vector3 playerPos_;
+    /// Movement direction chosen this frame.
+    Vector3 moveDir_;
+    /// State flags.
+    unsigned flags_;
+    /// Running move timer.
+    float currMove_;
+    /// Time of the last move choice.
+    float lastMove_;
+    /// Time of the last walk.
+    float lastWalk_;
+    /// Time of the last jump.
+    float lastJump_;
+    /// Time of the last kick.
+    float lastKick_;
+    /// Model heading.
+    float heading_;
+    /// Index of the agent controller driving this character.
+    int agentIndex_;
+};
+
+/// Updates all AI controlled Character2D components in one pass over packed state, replacing their per-instance LogicComponent update.
+class Character2DBatch : public Object
+{
+    URHO3D_OBJECT(Character2DBatch, Object);
+
+public:
+    /// Construct.
+    explicit Character2DBatch(Context* context);
+    /// Destruct.
+    ~Character2DBatch() override = default;
+
+    /// Set the scene whose update drives the batch.
+    void SetScene(Scene* scene);
+    /// Add an AI character. Its own per-instance update is disabled.
+    void AddCharacter(Character2D* character);
+    /// Remove all characters, restoring their per-instance update.
+    void Clear();
+    /// Update all characters.
+    void Update(float timeStep);
+
+    /// Return number of characters.
+    unsigned GetNumCharacters() const { return characters_.Size(); }
+
+private:
+    /// Handle the scene update event.
+    void HandleSceneUpdate(StringHash eventType, SceneUpdateEventData& eventData);
+    /// Drop characters whose component has been destroyed.
+    void RemoveExpired();
+    /// Read node, body and component state into the packed arrays.
+    void Gather();
+    /// Run the AI and movement logic on the packed state only.
+    void Simulate(float timeStep);
+    /// Write the results back to components, nodes, rigid bodies and animation states.
+    void WriteBack(float timeStep);
+
+    /// Scene.
+    WeakPtr<Scene> scene_;
+    /// Character components.
+    Vector<WeakPtr<Character2D> > characters_;
+    /// Rigid bodies, parallel to characters_.
+    PODVector<RigidBody2D*> bodies_;
+    /// Animated models, parallel to characters_.
+    PODVector<AnimatedModel*> models_;
+    /// Packed state, parallel to characters_.
+    PODVector<AgentState2D> states_;
+    /// Reused ground query result.
+    PODVector<RigidBody2D*> groundQuery_;
+};
@@ -33,9 +33,9 @@ class Controls;
 
 //=============================================================================
 //=============================================================================
-const StringHash VAR_AXIS_0("VAR_AXIS_0");
-const StringHash VAR_AXIS_1("VAR_AXIS_1");
-const StringHash VAR_AXIS_2("VAR_AXIS_2");
+const StringHash VAR_AXIS_0(URHO3D_STRINGHASH("VAR_AXIS_0"));
+const StringHash VAR_AXIS_1(URHO3D_STRINGHASH("VAR_AXIS_1"));
+const StringHash VAR_AXIS_2(URHO3D_STRINGHASH("VAR_AXIS_2"));
 
 const unsigned BUTTON_A             = (1 << SDL_CONTROLLER_BUTTON_A            );
 const unsigned BUTTON_B             = (1 << SDL_CONTROLLER_BUTTON_B            );
@@ -34,10 +34,13 @@
 #include <Urho3D/Urho2D/CollisionCircle2D.h>
 #include <Urho3D/Urho2D/CollisionPolygon2D.h>
 #include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Profiler.h>
 #include <Urho3D/Graphics/DebugRenderer.h>
 #include <Urho3D/Engine/Engine.h>
 #include <Urho3D/UI/Font.h>
 #include <Urho3D/Input/Input.h>
+#include <Urho3D/Input/InputEvents.h>
 #include <Urho3D/IO/MemoryBuffer.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Graphics/AnimatedModel.h>
@@ -85,6 +88,7 @@
 
 #include "GameController.h"
 #include "Character2D.h"
+#include "Character2DBatch.h"
 #include "Object2D.h"
 #include "Sample2D.h"
 #include "Utilities2D/Mover.h"
@@ -109,6 +113,15 @@ MayaSpace::MayaSpace(Context *context) :
 
 void MayaSpace::Setup() {
     Game::Setup();
+
+    // Fixed simulation rate: higher for training, lower for constrained machines, 0 to simulate on the render timestep
+    const Vector<String>& arguments = GetArguments();
+    for (unsigned i = 0; i + 1 < arguments.Size(); ++i) {
+        if (arguments[i].ToLower() == "-simrate") {
+            int rate = ToInt(arguments[i + 1]);
+            fixedTimeStep_ = rate > 0 ? 1.0f / (float) rate : 0.0f;
+        }
+    }
 }
 
 void MayaSpace::InitEvolutionSpriteGenerator() {
@@ -269,11 +282,6 @@ void MayaSpace::ShowEvolutionManagerStats() {
 
 void MayaSpace::Start() {
 
-    for (int i = 0; i < sizeof(particlePool_) / sizeof(*particlePool_); i++) {
-        particlePool_[i].used = false;
-        particlePool_[i].usedBy = -1;
-    }
-
     // Execute base class startup
     Game::Start();
 
@@ -322,6 +330,9 @@ void MayaSpace::CreateScene() {
     scene_->CreateComponent<DebugRenderer>();
     /*PhysicsWorld2D* physicsWorld =*/ scene_->CreateComponent<PhysicsWorld2D>();
 
+    // Create the recycled particle emitters
+    InitParticlePool();
+
     // Create camera
     cameraNode_ = scene_->CreateChild("Camera");
     auto *camera = cameraNode_->CreateComponent<Camera>();
@@ -454,6 +465,7 @@ void MayaSpace::CreateScene() {
 //    auto* tileMap3d = tileMapNode->CreateComponent<TileMap3D>();
 //    tileMap3d->SetTmxFile(cache->GetResource<TmxFile2D>("Urho2D/Tilesets/Ortho.tmx"
 
+    SetEntityTag(tileMapNode, ET_TILEMAP);
     TileMap3D *tileMap = tileMapNode->CreateComponent<TileMap3D>();
     URHO3D_LOGINFOF("tileMap=%x", tileMap);
 
@@ -488,6 +500,7 @@ void MayaSpace::CreateScene() {
         auto *obj_ = pumpkinNode->CreateComponent<Object2D>(); // Create a logic component to handle character behavior
         String name = String("Pumpkin-P") + String(i);
         obj_->GetNode()->SetName(name.CString());
+        SetEntityTag(obj_->GetNode(), ET_PICKUP);
         obj_->id_ = i;
         obj_->type_ = 3;
     }
@@ -498,11 +511,16 @@ void MayaSpace::CreateScene() {
     Node *modelNode = sample2D_->CreateCharacter(info, 0.0f, Vector3(2.5f, 2.0f, 0.0f), 0.1f, 1);
     player_ = modelNode->CreateComponent<Character2D>(); // Create a logic component to handle character behavior
     player_->GetNode()->SetName("Bear-P1");
+    SetEntityTag(player_->GetNode(), ET_PLAYER);
     player_->isAI_ = false;
     player_->life_ = 100;
     player_->id_ = 0;
     player_->type_ = 1;
 
+    // AI characters are updated together by the batch instead of one LogicComponent update each
+    agentBatch_ = new Character2DBatch(context_);
+    agentBatch_->SetScene(scene_);
+
     for (int i = 0; i < EvolutionManager::getInstance()->getAgents().size(); i++) {
 
         // Create AI player character
@@ -511,6 +529,7 @@ void MayaSpace::CreateScene() {
         agents_[i]->agentIndex = i;
         String name = String("AI-Bear-P") + String(i);
         agents_[i]->GetNode()->SetName(name.CString());
+        SetEntityTag(agents_[i]->GetNode(), ET_ENEMY);
         agents_[i]->isAI_ = true;
         agents_[i]->playerPos_ = player_->GetNode()->GetPosition();
         agents_[i]->id_ = 1 + i;
@@ -519,6 +538,7 @@ void MayaSpace::CreateScene() {
         agents_[i]->doMove_ = false;
         agents_[i]->chooseMove_ = false;
         agents_[i]->lastMove_ = agents_[i]->currMove_ = 0;
+        agentBatch_->AddCharacter(agents_[i]);
 
         agents_[i]->genotypeNode_ = scene_->CreateChild("Genotype " + i);
         agents_[i]->powerbarNode_ = scene_->CreateChild("Powerbar " + i);
@@ -645,8 +665,9 @@ void MayaSpace::CreateScene() {
     }
 
 // Generate physics collision shapes from the tmx file's objects located in "Physics" (top) layer
+    // Adjacent solids are merged into as few static shapes as possible to keep the broadphase small
     TileMapLayer3D *tileMapLayer = tileMap->GetLayer(tileMap->GetNumLayers() - 1);
-    sample2D_->CreateCollisionShapesFromTMXObjects(tileMapNode, tileMapLayer, info);
+    sample2D_->CreateMergedCollisionShapesFromTMXObjects(tileMapNode, tileMapLayer, info);
 
     // Create a directional light to the world so that we can see something. The light scene node's orientation controls the
     // light direction; we will use the SetDirection() function which calculates the orientation from a forward direction vector.
@@ -676,7 +697,9 @@ void MayaSpace::CreateScene() {
     // Create background
     sample2D_->CreateBackgroundSprite(info, 6.0, "Textures/HeightMap.png", true);
 
-
+    // Render the characters interpolated between fixed simulation steps
+    InitInterpolatedNodes();
+    SetSimulationEnabled(true);
 
     // Check when scene is rendered
     SubscribeToEvent(E_ENDRENDERING, URHO3D_HANDLER(MayaSpace, HandleSceneRendered));
@@ -684,25 +707,29 @@ void MayaSpace::CreateScene() {
 
 void MayaSpace::HandleSceneRendered(StringHash eventType, VariantMap &eventData) {
     UnsubscribeFromEvent(E_ENDRENDERING);
-    // Save the scene so we can reload it later
+    // Save the scene so we can reload it later, with the characters' models at rest
+    RestoreInterpolatedNodes();
     sample2D_->SaveScene(true);
     // Pause the scene as long as the UI is hiding it
-    scene_->SetUpdateEnabled(false);
+    SetSimulationEnabled(false);
 }
 
 void MayaSpace::SubscribeToEvents() {
+    // Subscribe HandleInputEnd() function for latching input before the scene update
+    SubscribeToEvent(E_INPUTEND, URHO3D_HANDLER(MayaSpace, HandleInputEnd));
+
     // Subscribe HandleUpdate() function for processing update events
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(MayaSpace, HandleUpdate));
+    SubscribeToEvent(E_UPDATE, URHO3D_TYPED_HANDLER(MayaSpace, HandleUpdate));
 
     // Subscribe HandlePostUpdate() function for processing post update events
-    SubscribeToEvent(E_POSTUPDATE, URHO3D_HANDLER(MayaSpace, HandlePostUpdate));
+    SubscribeToEvent(E_POSTUPDATE, URHO3D_TYPED_HANDLER(MayaSpace, HandlePostUpdate));
 
     // Subscribe to PostRenderUpdate to draw debug geometry
-    SubscribeToEvent(E_POSTRENDERUPDATE, URHO3D_HANDLER(MayaSpace, HandlePostRenderUpdate));
+    SubscribeToEvent(E_POSTRENDERUPDATE, URHO3D_TYPED_HANDLER(MayaSpace, HandlePostRenderUpdate));
 
     // Subscribe to Box2D contact listeners
-    SubscribeToEvent(E_PHYSICSBEGINCONTACT2D, URHO3D_HANDLER(MayaSpace, HandleCollisionBegin));
-    SubscribeToEvent(E_PHYSICSENDCONTACT2D, URHO3D_HANDLER(MayaSpace, HandleCollisionEnd));
+    SubscribeToEvent(E_PHYSICSBEGINCONTACT2D, URHO3D_TYPED_HANDLER(MayaSpace, HandleCollisionBegin));
+    SubscribeToEvent(E_PHYSICSENDCONTACT2D, URHO3D_TYPED_HANDLER(MayaSpace, HandleCollisionEnd));
 
     // If the node pointer is non-null, this component has been created into a scene node. Subscribe to physics collisions that
     // concern this scene node
@@ -744,238 +771,167 @@ void MayaSpace::HandleNodeCollision(StringHash eventType, VariantMap& eventData)
 
 }*/
 
-void MayaSpace::HandleCollisionBegin(StringHash eventType, VariantMap &eventData) {
-    // Get colliding node
-    auto *hitNode = static_cast<Node *>(eventData[PhysicsBeginContact2D::P_NODEA].GetPtr());
-    if (hitNode->GetName() == "Bear-P1")
-        hitNode = static_cast<Node *>(eventData[PhysicsBeginContact2D::P_NODEB].GetPtr());
-    String nodeName = hitNode->GetName();
-    Node *character2DNode = scene_->GetChild("Bear-P1", true);
+void MayaSpace::HandleCollisionBegin(StringHash eventType, PhysicsContact2DEventData &eventData) {
+    Node *character2DNode = player_ ? player_->GetNode() : nullptr;
+    if (!character2DNode)
+        return;
 
-//Pumpkin-P
-    Node *p1Node = scene_->GetChild("Bear-P1", true);
-    Node *p2Node = scene_->GetChild("Bear-P2", true);
+    // Get colliding nodes, only contacts involving the player drive gameplay
+    Node *hitNodeA = eventData.nodeA_;
+    Node *hitNodeB = eventData.nodeB_;
+    if (hitNodeA != character2DNode && hitNodeB != character2DNode)
+        return;
 
-    // Get colliding node
-    auto *hitNodeA = static_cast<Node *>(eventData[PhysicsBeginContact2D::P_NODEA].GetPtr());
-    auto *hitNodeB = static_cast<Node *>(eventData[PhysicsBeginContact2D::P_NODEB].GetPtr());
+    // The hit node is the one that is not the player. Its entity tag was resolved at creation, so no name compares
+    Node *hitNode = hitNodeA == character2DNode ? hitNodeB : hitNodeA;
+    // An earlier receiver may have removed it, in which case the payload's weak pointer is null
+    if (!hitNode)
+        return;
+    EntityTag2D hitTag = GetEntityTag(hitNode);
 
     // Skip tile map collisions
-    if (!hitNodeA->GetName().Contains("TileMap")) {
-
-
-        //hitNodeA id=Pumpkin-P4, hitNodeB id=Bear-P1
-/*
-        URHO3D_LOGINFOF("hitNodeA=%d, hitNodeB=%d", hitNodeA, hitNodeB);
-        URHO3D_LOGINFOF("hitNodeA id=%s, hitNodeB id=%s", hitNodeA->GetName().CString(), hitNodeB->GetName().CString());*/
-
+    if (hitTag != ET_TILEMAP) {
         Vector2 contactPosition;
-        //
-        MemoryBuffer contacts(eventData[PhysicsBeginContact2D::P_CONTACTS].GetBuffer());
+        MemoryBuffer contacts(*eventData.contacts_);
         while (!contacts.IsEof()) {
             contactPosition = contacts.ReadVector2();
-            auto contactNormal = contacts.ReadVector2();
-            auto contactDistance = contacts.ReadFloat();
-            auto contactImpulse = contacts.ReadFloat();
-            //     std::cout << "contact position " << contactPosition.ToString().CString() << std::endl;
-            //     std::cout << "contact normal " << contactNormal.ToString().CString() << std::endl;
-            //     std::cout << "contact distance " << contactDistance << std::endl;
-            //     std::cout << "contact impulse " << contactImpulse << std::endl;
+            contacts.ReadVector2(); // Normal
+            contacts.ReadFloat(); // Distance
+            contacts.ReadFloat(); // Impulse
         }
 
-        std::cout << std::endl;
-
-        String a1, a2, b1, b2;
+        // Contact events carry no time step
+        float timeStep = 0.0f;
 
-        a1 = "Pumpkin";
-        b1 = "Bear-P1";
-        a2 = "Bear-P1";
-        b2 = "Pumpkin";
-
-        bool hit1 = hitNodeA->GetName().Contains(a1) && hitNodeB->GetName().Contains(b1);
-        bool hit2 = hitNodeA->GetName().Contains(a2) && hitNodeB->GetName().Contains(b2);
-
-        if (hit1 || hit2) {
+        if (hitTag == ET_PICKUP) {
             // Bear P1 collides with pumpkin
-            //URHO3D_LOGINFOF("hit1=%d, hit2=%d", hit1, hit2);
-
-            if (hit1) {
-                String nodeName = hitNode->GetName();
-                Node *pumpkinNode = scene_->GetChild(nodeName, true);
-                player_->life_ += 20;
-                if (pumpkinNode) {
-                    pumpkinNode->Remove();
-                }
-
-                // Take the frame time step, which is stored as a float
-                using namespace Update;
-                float timeStep = eventData[P_TIMESTEP].GetFloat();
-                SetParticleEmitter(hitNode->GetID(), contactPosition.x_, contactPosition.y_, 1, timeStep);
-                sample2D_->PlaySoundEffect("Powerup.wav");
+            int hitId = hitNode->GetID();
+            player_->life_ += 20;
+            hitNode->Remove();
 
-
-            }
+            SetParticleEmitter(hitId, contactPosition.x_, contactPosition.y_, 1, timeStep);
+            sample2D_->PlaySoundEffect("Powerup.wav");
         }
 
-
-        a1 = "Bear-P";
-        b1 = "Bear-P1";
-        a2 = "Bear-P1";
-        b2 = "Bear-P";
-
-        bool hit3 = hitNodeA->GetName().Contains(a1) && hitNodeB->GetName().Contains(b1);
-        bool hit4 = hitNodeA->GetName().Contains(a2) && hitNodeB->GetName().Contains(b2);
-
-        if ((hit3 || hit4) && player_->isReady_) {
-
-            // If hit node is an id more than the player, it's AI
-//        if (hitNode->GetID() > character2DNode->GetID() && player_->isReady_) {
+        if (hitTag == ET_ENEMY && player_->isReady_) {
             player_->life_ -= 10;
             auto *body = character2DNode->GetComponent<RigidBody2D>();
             auto *body2 = hitNode->GetComponent<RigidBody2D>();
 
-            //        Vector2 v = body->GetLinearVelocity()*-10.0f;
-            //        float a = body->GetAngularVelocity();
-
             // Clear forces (should be performed by setting linear velocity to zero, but currently doesn't work)
             body->SetLinearVelocity(Vector2::ZERO);
             body->SetAwake(false);
             body->SetAwake(true);
 
-            body2->SetLinearVelocity(Vector2::ZERO);
-            body2->SetAwake(false);
-            body2->SetAwake(true);
-
-            //URHO3D_LOGINFOF("PLAYER HIT by=%d", hitNode->GetID());
+            if (body2) {
+                body2->SetLinearVelocity(Vector2::ZERO);
+                body2->SetAwake(false);
+                body2->SetAwake(true);
+            }
 
-            // Take the frame time step, which is stored as a float
-            using namespace Update;
-            float timeStep = eventData[P_TIMESTEP].GetFloat();
             SetParticleEmitter(hitNode->GetID(), contactPosition.x_, contactPosition.y_, 0, timeStep);
             sample2D_->PlaySoundEffect("explosion-sm.wav");
             sample2D_->PlaySoundEffect("bam-motherfucker.wav");
-
-
-        }
-    }
-
-
-    // Handle ropes and ladders climbing
-    if (nodeName == "Climb") {
-        if (player_->isClimbing_) // If transition between rope and top of rope (as we are using split triggers)
-            player_->climb2_ = true;
-        else {
-            player_->isClimbing_ = true;
-            auto *body = character2DNode->GetComponent<RigidBody2D>();
-            body->SetGravityScale(0.0f); // Override gravity so that the character doesn't fall
-            // Clear forces so that the character stops (should be performed by setting linear velocity to zero, but currently doesn't work)
-            body->SetLinearVelocity(Vector2(0.0f, 0.0f));
-            body->SetAwake(false);
-            body->SetAwake(true);
         }
     }
 
-    //URHO3D_LOGINFOF("HIT id=%d, name=%s", hitNode->GetID(), hitNode->GetName());
-    //URHO3D_LOGINFOF("character2DNode=%d", character2DNode->GetID());
-
-
-    auto *body = character2DNode->GetComponent<RigidBody2D>();
-    // body->SetGravityScale(0.0f); // Override gravity so that the character doesn't fall
-    // Clear forces so that the character stops (should be performed by setting linear velocity to zero, but currently doesn't work)
-//            body->SetLinearVelocity(body->GetLinearVelocity()*-1.0f);
-//            body->SetAwake(false);
-//            body->SetAwake(true);
-
+    switch (hitTag) {
+        // Handle ropes and ladders climbing
+        case ET_CLIMB:
+            if (player_->isClimbing_) // If transition between rope and top of rope (as we are using split triggers)
+                player_->climb2_ = true;
+            else {
+                player_->isClimbing_ = true;
+                auto *body = character2DNode->GetComponent<RigidBody2D>();
+                body->SetGravityScale(0.0f); // Override gravity so that the character doesn't fall
+                // Clear forces so that the character stops (should be performed by setting linear velocity to zero, but currently doesn't work)
+                body->SetLinearVelocity(Vector2(0.0f, 0.0f));
+                body->SetAwake(false);
+                body->SetAwake(true);
+            }
+            break;
 
-    if (nodeName == "hit-body") {
-        URHO3D_LOGINFOF("HIT BODY=%s", hitNode->GetName());
-    }
+        case ET_CAN_JUMP:
+            player_->aboveClimbable_ = true;
+            break;
 
-    if (nodeName == "CanJump")
-        player_->aboveClimbable_ = true;
-
-    // Handle coins picking
-    if (nodeName == "Coin") {
-        hitNode->Remove();
-        player_->remainingCoins_ -= 1;
-        auto *ui = GetSubsystem<UI>();
-        if (player_->remainingCoins_ == 0) {
-            Text *instructions = static_cast<Text *>(ui->GetRoot()->GetChild("Instructions", true));
-            instructions->SetText("!!! Go to the Exit !!!");
+        // Handle coins picking
+        case ET_COIN: {
+            hitNode->Remove();
+            player_->remainingCoins_ -= 1;
+            auto *ui = GetSubsystem<UI>();
+            if (player_->remainingCoins_ == 0) {
+                Text *instructions = static_cast<Text *>(ui->GetRoot()->GetChild("Instructions", true));
+                instructions->SetText("!!! Go to the Exit !!!");
+            }
+            Text *coinsText = static_cast<Text *>(ui->GetRoot()->GetChild("CoinsText", true));
+            coinsText->SetText(String(player_->remainingCoins_)); // Update coins UI counter
+            sample2D_->PlaySoundEffect("Powerup.wav");
         }
-        Text *coinsText = static_cast<Text *>(ui->GetRoot()->GetChild("CoinsText", true));
-        coinsText->SetText(String(player_->remainingCoins_)); // Update coins UI counter
-        sample2D_->PlaySoundEffect("Powerup.wav");
-    }
+            break;
 
-/*
-    // Handle interactions with enemies
-    if (nodeName == "Enemy" || nodeName == "Orc")
-    {
-        auto* animatedSprite = character2DNode->GetComponent<AnimatedSprite2D>();
-        float deltaX = character2DNode->GetPosition().x_ - hitNode->GetPosition().x_;
-
-        // Orc killed if character is fighting in its direction when the contact occurs (flowers are not destroyable)
-        if (nodeName == "Orc" && animatedSprite->GetAnimation() == "attack" && (deltaX < 0 == animatedSprite->GetFlipX()))
-        {
-            static_cast<Mover*>(hitNode->GetComponent<Mover>())->emitTime_ = 1;
-            if (!hitNode->GetChild("Emitter", true))
-            {
-                hitNode->GetComponent("RigidBody2D")->Remove(); // Remove Orc's body
-                sample2D_->SpawnEffect(hitNode);
-                sample2D_->PlaySoundEffect("BigExplosion.wav");
+        // Handle exiting the level when all coins have been gathered
+        case ET_EXIT:
+            if (player_->remainingCoins_ == 0) {
+                // Update UI
+                auto *ui = GetSubsystem<UI>();
+                Text *instructions = static_cast<Text *>(ui->GetRoot()->GetChild("Instructions", true));
+                instructions->SetText("!!! WELL DONE !!!");
+                instructions->SetPosition(IntVector2(0, 0));
+                // Put the character outside of the scene and magnify him
+                character2DNode->SetPosition(Vector3(-20.0f, 0.0f, 0.0f));
+                character2DNode->SetScale(1.5f);
             }
-        }
-        // Player killed if not fighting in the direction of the Orc when the contact occurs, or when colliding with a flower
-        else
-        {
-            if (!character2DNode->GetChild("Emitter", true))
-            {
+            break;
+
+        // Handle falling into lava
+        case ET_LAVA: {
+            auto *body = character2DNode->GetComponent<RigidBody2D>();
+            body->ApplyForceToCenter(Vector2(0.0f, 1000.0f), true);
+            if (!character2DNode->GetChild("Emitter", true)) {
                 player_->wounded_ = true;
-                if (nodeName == "Orc")
-                {
-                    auto* orc = static_cast<Mover*>(hitNode->GetComponent<Mover>());
-                    orc->fightTimer_ = 1;
-                }
                 sample2D_->SpawnEffect(character2DNode);
                 sample2D_->PlaySoundEffect("BigExplosion.wav");
             }
         }
-    }*/
-
-    // Handle exiting the level when all coins have been gathered
-    if (nodeName == "Exit" && player_->remainingCoins_ == 0) {
-        // Update UI
-        auto *ui = GetSubsystem<UI>();
-        Text *instructions = static_cast<Text *>(ui->GetRoot()->GetChild("Instructions", true));
-        instructions->SetText("!!! WELL DONE !!!");
-        instructions->SetPosition(IntVector2(0, 0));
-        // Put the character outside of the scene and magnify him
-        character2DNode->SetPosition(Vector3(-20.0f, 0.0f, 0.0f));
-        character2DNode->SetScale(1.5f);
+            break;
+
+        // Handle climbing a slope
+        case ET_SLOPE:
+            player_->onSlope_ = true;
+            break;
+
+        default:
+            break;
     }
+}
 
-    // Handle falling into lava
-    if (nodeName == "Lava") {
-        auto *body = character2DNode->GetComponent<RigidBody2D>();
-        body->ApplyForceToCenter(Vector2(0.0f, 1000.0f), true);
-        if (!character2DNode->GetChild("Emitter", true)) {
-            player_->wounded_ = true;
-            sample2D_->SpawnEffect(character2DNode);
-            sample2D_->PlaySoundEffect("BigExplosion.wav");
-        }
+
+void MayaSpace::InitParticlePool() {
+    particlePoolFree_.Clear();
+    particlePoolUsed_.Clear();
+
+    for (unsigned i = 0; i < NUM_PARTICLE_EMITTERS; i++) {
+        ParticlePool &entry = particlePool_[i];
+        // Temporary so that the pooled nodes are not written out by SaveScene
+        entry.node = scene_->CreateTemporaryChild("GreenSpiral");
+        entry.emitter = entry.node->CreateComponent<ParticleEmitter2D>();
+        entry.node->SetEnabled(false);
+        entry.used = false;
+        entry.usedBy = -1;
+        entry.lastEmit = 0;
+        entry.currEmit = 0;
+        entry.timeout = 0;
     }
 
-    // Handle climbing a slope
-    if (nodeName == "Slope")
-        player_->onSlope_ = true;
+    // Hand out the lowest indices first
+    for (unsigned i = NUM_PARTICLE_EMITTERS; i > 0; i--)
+        particlePoolFree_.Push(i - 1);
 }
 
-
 void MayaSpace::SetParticleEmitter(int hitId, float contactX, float contactY, int type, float timeStep) {
-    // CREATE
     auto *cache = GetSubsystem<ResourceCache>();
-    ParticleEffect2D *particleEffect;
+    ParticleEffect2D *particleEffect = nullptr;
     Vector2 position;
 
     switch (type) {
@@ -994,89 +950,111 @@ void MayaSpace::SetParticleEmitter(int hitId, float contactX, float contactY, in
     if (!particleEffect)
         return;
 
-    for (int i = 0; i < sizeof(particlePool_) / sizeof(*particlePool_); i++) {
-        if (!particlePool_[i].used) {
-            particlePool_[i].used = true;
-            particlePool_[i].usedBy = hitId;
-            particlePool_[i].node = scene_->CreateChild("GreenSpiral");
-            auto *particleEmitter = particlePool_[i].node->CreateComponent<ParticleEmitter2D>();
-            particleEmitter->SetEffect(particleEffect);
-            particlePool_[i].node->SetPosition(Vector3(position.x_, position.y_, 0.0));
-            particlePool_[i].lastEmit = timeStep;
-            particlePool_[i].currEmit = 0;
-            particlePool_[i].timeout = 0.8f;
-
-            break;
-        }
+    if (particlePoolFree_.Empty()) {
+        URHO3D_LOGWARNINGF("PARTICLE POOL EXHAUSTED, dropped effect for id=%d", hitId);
+        return;
     }
 
-    URHO3D_LOGINFOF("PARTICLE EMITTER CREATED used by id=%d", hitId);
+    unsigned index = particlePoolFree_.Back();
+    particlePoolFree_.Pop();
+    particlePoolUsed_.Push(index);
+
+    // Reuse the pooled node and emitter, only the effect binding and emission state change
+    ParticlePool &entry = particlePool_[index];
+    entry.used = true;
+    entry.usedBy = hitId;
+    entry.node->SetPosition(Vector3(position.x_, position.y_, 0.0));
+    entry.emitter->SetEffect(particleEffect);
+    entry.emitter->Reset();
+    entry.node->SetEnabled(true);
+    entry.lastEmit = timeStep;
+    entry.currEmit = 0;
+    entry.timeout = 0.8f;
+
+    URHO3D_LOGINFOF("PARTICLE EMITTER SPAWNED used by id=%d", hitId);
 }
 
 void MayaSpace::HandleUpdateParticlePool(float timeStep) {
-    // CREATE
-    auto *cache = GetSubsystem<ResourceCache>();
-/*    auto* particleEffect = cache->GetResource<ParticleEffect2D>("Urho2D/sun.pex");
-    if (!particleEffect)
+    for (unsigned i = 0; i < particlePoolUsed_.Size();) {
+        unsigned index = particlePoolUsed_[i];
+        ParticlePool &entry = particlePool_[index];
+
+        entry.currEmit += timeStep;
+
+        if (entry.currEmit - entry.lastEmit > entry.timeout) {
+            // Park the emitter and return its entry to the free list
+            entry.emitter->RemoveAllParticles();
+            entry.node->SetEnabled(false);
+            entry.used = false;
+            entry.usedBy = -1;
+            particlePoolUsed_.EraseSwap(i);
+            particlePoolFree_.Push(index);
+        } else
+            i++;
+    }
+}
+
+
+void MayaSpace::HandleCollisionEnd(StringHash eventType, PhysicsContact2DEventData &eventData) {
+    Node *character2DNode = player_ ? player_->GetNode() : nullptr;
+    if (!character2DNode)
         return;
-*/
-    for (int i = 0; i < sizeof(particlePool_) / sizeof(*particlePool_); i++) {
-        if (particlePool_[i].used) {
 
-            particlePool_[i].currEmit += timeStep;
+    // Get colliding node, only contacts involving the player drive gameplay
+    Node *hitNode = eventData.nodeA_;
+    if (hitNode == character2DNode)
+        hitNode = eventData.nodeB_;
+    else if (eventData.nodeB_ != character2DNode)
+        return;
 
-            if (particlePool_[i].currEmit - particlePool_[i].lastEmit > particlePool_[i].timeout) {
-                if (particlePool_[i].node) {
-                    particlePool_[i].node->Remove();
-                    particlePool_[i].used = false;
-                    particlePool_[i].usedBy = -1;
-                }
+    switch (GetEntityTag(hitNode)) {
+        // Handle leaving a rope or ladder
+        case ET_CLIMB:
+            if (player_->climb2_)
+                player_->climb2_ = false;
+            else {
+                player_->isClimbing_ = false;
+                auto *body = character2DNode->GetComponent<RigidBody2D>();
+                body->SetGravityScale(1.0f); // Restore gravity
             }
-        }
-    }
-}
-
+            break;
 
-void MayaSpace::HandleCollisionEnd(StringHash eventType, VariantMap &eventData) {
-    // Get colliding node
-    auto *hitNode = static_cast<Node *>(eventData[PhysicsEndContact2D::P_NODEA].GetPtr());
-    if (hitNode->GetName() == "Bear-P1")
-        hitNode = static_cast<Node *>(eventData[PhysicsEndContact2D::P_NODEB].GetPtr());
-    String nodeName = hitNode->GetName();
-    Node *character2DNode = scene_->GetChild("Bear-P1", true);
+        case ET_CAN_JUMP:
+            player_->aboveClimbable_ = false;
+            break;
 
-    // Handle leaving a rope or ladder
-    if (nodeName == "Climb") {
-        if (player_->climb2_)
-            player_->climb2_ = false;
-        else {
-            player_->isClimbing_ = false;
+        // Handle leaving a slope
+        case ET_SLOPE: {
+            player_->onSlope_ = false;
+            // Clear forces (should be performed by setting linear velocity to zero, but currently doesn't work)
             auto *body = character2DNode->GetComponent<RigidBody2D>();
-            body->SetGravityScale(1.0f); // Restore gravity
+            body->SetLinearVelocity(Vector2::ZERO);
+            body->SetAwake(false);
+            body->SetAwake(true);
         }
-    }
+            break;
 
-    if (nodeName == "CanJump")
-        player_->aboveClimbable_ = false;
-
-    // Handle leaving a slope
-    if (nodeName == "Slope") {
-        player_->onSlope_ = false;
-        // Clear forces (should be performed by setting linear velocity to zero, but currently doesn't work)
-        auto *body = character2DNode->GetComponent<RigidBody2D>();
-        body->SetLinearVelocity(Vector2::ZERO);
-        body->SetAwake(false);
-        body->SetAwake(true);
+        default:
+            break;
     }
 }
 
-void MayaSpace::HandleUpdate(StringHash eventType, VariantMap &eventData) {
-    using namespace Update;
+void MayaSpace::HandleInputEnd(StringHash eventType, VariantMap &eventData) {
+    // Latch edge-triggered input once per frame, before the scene update runs the controllers. The player consumes
+    // it on the next simulation step
     auto *input = GetSubsystem<Input>();
+    if (player_ && simulationEnabled_ && (input->GetKeyPress('W') || input->GetKeyPress(KEY_UP)))
+        player_->jumpPressed_ = true;
+}
+
+void MayaSpace::HandleUpdate(StringHash eventType, UpdateEventData &eventData) {
+    auto *input = GetSubsystem<Input>();
+
+    // Take the frame time step
+    float timeStep = eventData.timeStep_;
 
-    // Take the frame time step, which is stored as a float
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
-    HandleUpdateParticlePool(timeStep);
+    // Advance gameplay, AI and physics, decoupled from the render rate
+    UpdateSimulation(timeStep);
 
     float zoom_ = cameraNode_->GetComponent<Camera>()->GetZoom();
     float deltaSum;
@@ -1123,8 +1101,10 @@ void MayaSpace::HandleUpdate(StringHash eventType, VariantMap &eventData) {
 
 
     // Check for loading / saving the scene
-    if (input->GetKeyPress(KEY_F5))
+    if (input->GetKeyPress(KEY_F5)) {
+        RestoreInterpolatedNodes();
         sample2D_->SaveScene(false);
+    }
     if (input->GetKeyPress(KEY_F7))
         ReloadScene(false);
 
@@ -1199,7 +1179,7 @@ void MayaSpace::HandleUpdate(StringHash eventType, VariantMap &eventData) {
                 Billboard *bb = agents_[i]->genotypeBBSet_->GetBillboard(j);
                 //  bb->rotation_ += BILLBOARD_ROTATION_SPEED * timeStep;
                 if (agents_[i]) {
-                    Vector3 aiPos = agents_[i]->GetNode()->GetPosition();
+                    Vector3 aiPos = GetRenderPosition(agents_[i]->GetNode());
                     bb->position_ = Vector3(aiPos.x_ + (j * 0.02), aiPos.y_, 0.0f);
 
                     // Already set size in initialization (based on parameter)
@@ -1221,7 +1201,7 @@ void MayaSpace::HandleUpdate(StringHash eventType, VariantMap &eventData) {
                 Billboard *bb = agents_[i]->powerbarBBSet_->GetBillboard(j);
                 //  bb->rotation_ += BILLBOARD_ROTATION_SPEED * timeStep;
                 if (agents_[i]) {
-                    Vector3 aiPos = agents_[i]->GetNode()->GetPosition();
+                    Vector3 aiPos = GetRenderPosition(agents_[i]->GetNode());
                     bb->position_ = Vector3(aiPos.x_ + (j * 0.02), aiPos.y_+0.2f, 0.0f);
 
                     bb->size_ = Vector2((0.4f) * 0.05f, (4.0f) * 0.05f);
@@ -1308,16 +1288,145 @@ void MayaSpace::HandleUpdate(StringHash eventType, VariantMap &eventData) {
 
 }
 
-void MayaSpace::HandlePostUpdate(StringHash eventType, VariantMap &eventData) {
+void MayaSpace::HandlePostUpdate(StringHash eventType, UpdateEventData &eventData) {
     if (!player_)
         return;
 
-    Node *character2DNode = player_->GetNode();
-    cameraNode_->SetPosition(Vector3(character2DNode->GetPosition().x_, character2DNode->GetPosition().y_,
-                                     -10.0f)); // Camera tracks character
+    // Show the characters between the last two simulated states
+    ApplyInterpolatedNodes();
+
+    Vector3 playerPos = GetRenderPosition(player_->GetNode());
+    cameraNode_->SetPosition(Vector3(playerPos.x_, playerPos.y_, -10.0f)); // Camera tracks character
+}
+
+void MayaSpace::SetSimulationEnabled(bool enable) {
+    simulationEnabled_ = enable;
+    simAccumulator_ = 0.0f;
+    // Do not carry a jump pressed while paused into the resumed simulation
+    if (player_)
+        player_->jumpPressed_ = false;
+    // In fixed step mode the scene is stepped from UpdateSimulation() instead of its own update event
+    scene_->SetUpdateEnabled(enable && fixedTimeStep_ <= 0.0f);
+    StoreInterpolatedNodes(true);
 }
 
-void MayaSpace::HandlePostRenderUpdate(StringHash eventType, VariantMap &eventData) {
+void MayaSpace::UpdateSimulation(float timeStep) {
+    if (!simulationEnabled_)
+        return;
+
+    // Variable step: the scene has already updated with the render timestep
+    if (fixedTimeStep_ <= 0.0f) {
+        HandleUpdateParticlePool(timeStep);
+        renderAlpha_ = 1.0f;
+        StoreInterpolatedNodes(true);
+        return;
+    }
+
+    URHO3D_PROFILE(UpdateSimulation);
+
+    simAccumulator_ += timeStep;
+    if (simAccumulator_ < fixedTimeStep_) {
+        renderAlpha_ = simAccumulator_ / fixedTimeStep_;
+        return;
+    }
+
+    // Simulate on the true transforms only
+    RestoreInterpolatedNodes();
+
+    unsigned numSteps = 0;
+    while (simAccumulator_ >= fixedTimeStep_ && numSteps < SIM_MAX_STEPS) {
+        StoreInterpolatedNodes(true);
+        scene_->Update(fixedTimeStep_);
+        HandleUpdateParticlePool(fixedTimeStep_);
+        simAccumulator_ -= fixedTimeStep_;
+        ++numSteps;
+    }
+
+    // Drop the time that could not be simulated rather than falling further behind every frame
+    if (simAccumulator_ >= fixedTimeStep_)
+        simAccumulator_ = 0.0f;
+
+    StoreInterpolatedNodes(false);
+    renderAlpha_ = simAccumulator_ / fixedTimeStep_;
+}
+
+void MayaSpace::InitInterpolatedNodes() {
+    interpolatedNodes_.Clear();
+    interpolatedNodeIndex_.Clear();
+
+    // Characters are top level scene nodes tagged at creation, their model hangs below the adjust node
+    const Vector<SharedPtr<Node> >& children = scene_->GetChildren();
+    for (unsigned i = 0; i < children.Size(); ++i) {
+        Node *node = children[i];
+        EntityTag2D tag = GetEntityTag(node);
+        if (tag != ET_PLAYER && tag != ET_ENEMY)
+            continue;
+        Node *visual = node->GetChild("AdjNode");
+        if (!visual)
+            continue;
+
+        InterpolatedNode entry;
+        entry.node = node;
+        entry.visual = visual;
+        entry.visualPosition = visual->GetPosition();
+        entry.visualRotation = visual->GetRotation();
+        entry.prevPosition = entry.currPosition = entry.renderPosition = node->GetWorldPosition();
+        entry.prevRotation = entry.currRotation = node->GetWorldRotation();
+        interpolatedNodeIndex_[node->GetID()] = interpolatedNodes_.Size();
+        interpolatedNodes_.Push(entry);
+    }
+}
+
+void MayaSpace::RestoreInterpolatedNodes() {
+    for (unsigned i = 0; i < interpolatedNodes_.Size(); ++i) {
+        InterpolatedNode &entry = interpolatedNodes_[i];
+        if (entry.visual)
+            entry.visual->SetTransform(entry.visualPosition, entry.visualRotation);
+    }
+}
+
+void MayaSpace::StoreInterpolatedNodes(bool resetPrevious) {
+    for (unsigned i = 0; i < interpolatedNodes_.Size(); ++i) {
+        InterpolatedNode &entry = interpolatedNodes_[i];
+        if (!entry.node)
+            continue;
+        if (resetPrevious) {
+            // Start the next step from the state the previous step ended in
+            entry.prevPosition = entry.currPosition = entry.node->GetWorldPosition();
+            entry.prevRotation = entry.currRotation = entry.node->GetWorldRotation();
+        } else {
+            entry.currPosition = entry.node->GetWorldPosition();
+            entry.currRotation = entry.node->GetWorldRotation();
+        }
+    }
+}
+
+void MayaSpace::ApplyInterpolatedNodes() {
+    for (unsigned i = 0; i < interpolatedNodes_.Size(); ++i) {
+        InterpolatedNode &entry = interpolatedNodes_[i];
+        if (!entry.node || !entry.visual)
+            continue;
+
+        Vector3 position = entry.prevPosition.Lerp(entry.currPosition, renderAlpha_);
+        Quaternion rotation = entry.prevRotation.Slerp(entry.currRotation, renderAlpha_);
+        entry.renderPosition = position;
+
+        // Place the render-only child as if its parent were at the interpolated transform. The simulated node and its
+        // rigid body stay untouched
+        Matrix3x4 parentTransform(position, rotation, entry.node->GetWorldScale());
+        Matrix3x4 visualTransform = parentTransform * Matrix3x4(entry.visualPosition, entry.visualRotation, entry.visual->GetScale());
+        entry.visual->SetWorldTransform(visualTransform.Translation(), visualTransform.Rotation());
+    }
+}
+
+Vector3 MayaSpace::GetRenderPosition(Node *node) const {
+    HashMap<unsigned, unsigned>::ConstIterator i = interpolatedNodeIndex_.Find(node->GetID());
+    if (i == interpolatedNodeIndex_.End() || !interpolatedNodes_[i->second_].node)
+        return node->GetWorldPosition();
+    return interpolatedNodes_[i->second_].renderPosition;
+}
+
+void MayaSpace::HandlePostRenderUpdate(StringHash eventType, UpdateEventData &eventData) {
     // Mesh and bones do not match -> bones are too big
     // Scale down bone
 //    player_->
@@ -1358,13 +1467,33 @@ void MayaSpace::ReloadScene(bool reInit) {
 
     File loadFile(context_, GetSubsystem<FileSystem>()->GetProgramDir() + "Data/Scenes/" + filename + ".xml",
                   FILE_READ);
+    // The batch points to the current scene's AI characters, which loading destroys
+    if (agentBatch_)
+        agentBatch_->Clear();
     scene_->LoadXML(loadFile);
+    // Loading replaced the scene content, including the pooled emitter nodes and the interpolated characters
+    InitParticlePool();
+    InitInterpolatedNodes();
     // After loading we have to reacquire the weak pointer to the Character2D component, as it has been recreated
     // Simply find the character's scene node by name as there's only one of them
     Node *character2DNode = scene_->GetChild("Bear-P1", true);
     if (character2DNode)
         player_ = character2DNode->GetComponent<Character2D>();
 
+    // Reacquire the AI characters by name and hand them back to the batch. Their runtime-only state is not saved in the scene
+    for (int i = 0; i < MAX_AGENTS; i++) {
+        Node *agentNode = scene_->GetChild(String("AI-Bear-P") + String(i), true);
+        agents_[i] = agentNode ? agentNode->GetComponent<Character2D>() : nullptr;
+        if (!agents_[i])
+            continue;
+        agents_[i]->agentIndex = i;
+        agents_[i]->isAI_ = true;
+        agents_[i]->id_ = 1 + i;
+        agents_[i]->type_ = 2;
+        if (agentBatch_)
+            agentBatch_->AddCharacter(agents_[i]);
+    }
+
     // Set what number to use depending whether reload is requested from 'PLAY' button (reInit=true) or 'F7' key (reInit=false)
     int lifes = player_->remainingLifes_;
     int coins = player_->remainingCoins_;
@@ -1391,7 +1520,7 @@ void MayaSpace::HandlePlayButton(StringHash eventType, VariantMap &eventData) {
     auto *ui = GetSubsystem<UI>();
     if (static_cast<Text *>(ui->GetRoot()->GetChild("FullUI", true))) {
         ui->GetRoot()->GetChild("FullUI", true)->Remove();
-        scene_->SetUpdateEnabled(true);
+        SetSimulationEnabled(true);
     } else
         // Reload scene
         ReloadScene(true);
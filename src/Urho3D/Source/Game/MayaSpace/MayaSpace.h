@@ -26,21 +26,47 @@
 #include "Game.h"
 #include "Sample2D.h"
 
+namespace Urho3D
+{
+
+class PhysicsContact2DEventData;
+class UpdateEventData;
+
+}
+
 class Character2D;
+class Character2DBatch;
 class Sample2D;
 class EvolutionManager;
 
 #define MAX_AGENTS 1024 // Set max limit for agents (used for storage)
+#define NUM_PARTICLE_EMITTERS 20 // Number of recycled particle emitters
+#define SIM_DEFAULT_RATE 60 // Default fixed simulation rate (Hz), override with -simrate <hz>, 0 runs on the render timestep
+#define SIM_MAX_STEPS 5 // Max simulation steps per rendered frame before simulation time is dropped
 
 struct ParticlePool {
     bool used; // Is particle emitter used?
     int usedBy; // Node id using particle emitter
-    SharedPtr<Node> node; // Scene node
+    SharedPtr<Node> node; // Scene node, kept alive and disabled while the entry is free
+    WeakPtr<ParticleEmitter2D> emitter; // Emitter component, rebound to the requested effect on reuse
     float lastEmit;
     float currEmit;
     float timeout;
 };
 
+/// Simulated node whose render-only child is placed at the transform interpolated between the last two fixed steps.
+struct InterpolatedNode {
+    WeakPtr<Node> node; // Simulated node, carries the rigid body and is never moved by the interpolation
+    WeakPtr<Node> visual; // Render-only child (model adjust node) that is offset to the interpolated transform
+    Vector3 visualPosition; // Rest local position of the render-only child
+    Quaternion visualRotation; // Rest local rotation of the render-only child
+    Vector3 prevPosition; // World position after the previous fixed step
+    Quaternion prevRotation; // World rotation after the previous fixed step
+    Vector3 currPosition; // World position after the latest fixed step
+    Quaternion currRotation; // World rotation after the latest fixed step
+    Vector3 renderPosition; // Interpolated world position used for rendering this frame
+};
+
 /// Urho2D platformer example.
 /// This sample demonstrates:
 ///    - Creating an orthogonal 2D scene from tile map file
@@ -71,27 +97,46 @@ private:
     void CreateScene();
     /// Subscribe to application-wide logic update events.
     void SubscribeToEvents();
+    /// Handle the input end event. Latch key presses for the next simulation step.
+    void HandleInputEnd(StringHash eventType, VariantMap& eventData);
     /// Handle the logic update event.
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleUpdate(StringHash eventType, UpdateEventData& eventData);
     /// Handle the logic post update event.
-    void HandlePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandlePostUpdate(StringHash eventType, UpdateEventData& eventData);
     /// Handle the post render update event.
-    void HandlePostRenderUpdate(StringHash eventType, VariantMap& eventData);
+    void HandlePostRenderUpdate(StringHash eventType, UpdateEventData& eventData);
     /// Handle the end rendering event.
     void HandleSceneRendered(StringHash eventType, VariantMap& eventData);
     void HandleNodeCollision(StringHash eventType, VariantMap& eventData);
     /// Handle the contact begin event (Box2D contact listener).
-    void HandleCollisionBegin(StringHash eventType, VariantMap& eventData);
+    void HandleCollisionBegin(StringHash eventType, PhysicsContact2DEventData& eventData);
     /// Handle the contact end event (Box2D contact listener).
-    void HandleCollisionEnd(StringHash eventType, VariantMap& eventData);
+    void HandleCollisionEnd(StringHash eventType, PhysicsContact2DEventData& eventData);
     /// Handle reloading the scene.
     void ReloadScene(bool reInit);
     /// Handle 'PLAY' button released event.
     void HandlePlayButton(StringHash eventType, VariantMap& eventData);
 
+    /// (Re)create the pooled particle emitter nodes. Must be called whenever the scene content is replaced.
+    void InitParticlePool();
     void SetParticleEmitter(int hitId, float contactX, float contactY, int type, float timeStep);
     void HandleUpdateParticlePool(float timeStep);
 
+    /// Pause or resume the gameplay simulation.
+    void SetSimulationEnabled(bool enable);
+    /// Advance gameplay, AI and physics by the frame time step, in fixed steps when a simulation rate is set.
+    void UpdateSimulation(float timeStep);
+    /// Collect the player and AI character nodes for interpolation. Must be called whenever the scene content is replaced.
+    void InitInterpolatedNodes();
+    /// Return the render-only children to their rest transform before simulating.
+    void RestoreInterpolatedNodes();
+    /// Record the simulated transforms after a fixed step.
+    void StoreInterpolatedNodes(bool resetPrevious);
+    /// Place the render-only children at the transform interpolated by renderAlpha_.
+    void ApplyInterpolatedNodes();
+    /// Return the interpolated world position of a simulated node, or its world position when not interpolated.
+    Vector3 GetRenderPosition(Node* node) const;
+
     // Init Genetic Algorithm sprite generator
     void InitEvolutionSpriteGenerator();
 
@@ -101,6 +146,8 @@ private:
     /// The controllable character component.
     WeakPtr<Character2D> player_;
     WeakPtr<Character2D> agents_[MAX_AGENTS];
+    /// Batched update of the AI controlled characters.
+    SharedPtr<Character2DBatch> agentBatch_;
 
     /// Flag for drawing debug geometry.
     bool drawDebug_{};
@@ -115,7 +162,24 @@ private:
     SharedPtr<Sprite> powerbarBkgP1Sprite_;
 
     /// Particle pool
-    ParticlePool particlePool_[20];
+    ParticlePool particlePool_[NUM_PARTICLE_EMITTERS];
+    /// Free list of particle pool entry indices
+    PODVector<unsigned> particlePoolFree_;
+    /// Particle pool entry indices currently emitting
+    PODVector<unsigned> particlePoolUsed_;
+
+    /// Fixed simulation time step in seconds, 0 to simulate on the render time step.
+    float fixedTimeStep_{1.0f / SIM_DEFAULT_RATE};
+    /// Render time not yet consumed by fixed steps.
+    float simAccumulator_{};
+    /// Fraction of a fixed step between the last two simulated states shown this frame.
+    float renderAlpha_{1.0f};
+    /// Gameplay simulation running flag (false while the menu UI is shown).
+    bool simulationEnabled_{true};
+    /// Interpolated character nodes.
+    Vector<InterpolatedNode> interpolatedNodes_;
+    /// Node ID to interpolated node index.
+    HashMap<unsigned, unsigned> interpolatedNodeIndex_;
 
     #define NUM_DEBUG_FIELDS 8
     // Debug text
@@ -60,6 +60,7 @@
 #include <Urho3D/UI/UIEvents.h>
 #include <Urho3D/Scene/ValueAnimation.h>
 #include <Urho3D/UI/Window.h>
+#include <Urho3D/Resource/XMLFile.h>
 
 
 #include <Urho3D/Graphics/Graphics.h>
@@ -77,6 +78,20 @@
 #include "Sample2D.h"
 #include "Character2D.h"
 
+EntityTag2D GetEntityTagFromType(const String& type)
+{
+    static const char* typeNames[] = { "Climb", "CanJump", "Slope", "Lava", "Exit", "Coin" };
+    static const EntityTag2D typeTags[] = { ET_CLIMB, ET_CAN_JUMP, ET_SLOPE, ET_LAVA, ET_EXIT, ET_COIN };
+
+    for (unsigned i = 0; i < sizeof(typeNames) / sizeof(typeNames[0]); ++i)
+    {
+        if (type == typeNames[i])
+            return typeTags[i];
+    }
+
+    return ET_NONE;
+}
+
 Sample2D::Sample2D(Context* context) :
     Object(context)
 {
@@ -123,6 +138,368 @@ void Sample2D::CreateCollisionShapesFromTMXObjects(Node* tileMapNode, TileMapLay
     }
 }
 
+/// Tolerance used when comparing tmx object coordinates for adjacency.
+static const float BAKE_EPSILON = 0.0001f;
+
+static inline bool BakeEquals(float lhs, float rhs)
+{
+    return Abs(lhs - rhs) < BAKE_EPSILON;
+}
+
+static inline bool BakeEquals(const Vector2& lhs, const Vector2& rhs)
+{
+    return BakeEquals(lhs.x_, rhs.x_) && BakeEquals(lhs.y_, rhs.y_);
+}
+
+static float GetObjectFriction(TileMapObject2D* object)
+{
+    return object->HasProperty("Friction") ? ToFloat(object->GetProperty("Friction")) : 0.8f;
+}
+
+/// Return whether a baked shape has the vertices its type needs. Used both when baking and when loading the baked shapes.
+static bool IsValidBakedShape(TileMapObjectType2D type, unsigned numVertices)
+{
+    switch (type)
+    {
+    case OT_RECTANGLE:
+    case OT_ELLIPSE:
+        return numVertices == 2;
+
+    case OT_POLYGON:
+        return numVertices >= 3;
+
+    case OT_POLYLINE:
+        return numVertices >= 2;
+
+    default:
+        return false;
+    }
+}
+
+/// Merge rectangles which share a full edge along one axis. Return true if any were merged.
+static bool MergeRectangles(PODVector<Rect>& rects, PODVector<float>& frictions, bool horizontal)
+{
+    bool merged = false;
+
+    for (unsigned i = 0; i < rects.Size(); ++i)
+    {
+        for (unsigned j = i + 1; j < rects.Size();)
+        {
+            Rect& a = rects[i];
+            const Rect& b = rects[j];
+            bool adjacent;
+            if (horizontal)
+                adjacent = BakeEquals(a.min_.y_, b.min_.y_) && BakeEquals(a.max_.y_, b.max_.y_) &&
+                    (BakeEquals(a.max_.x_, b.min_.x_) || BakeEquals(b.max_.x_, a.min_.x_));
+            else
+                adjacent = BakeEquals(a.min_.x_, b.min_.x_) && BakeEquals(a.max_.x_, b.max_.x_) &&
+                    (BakeEquals(a.max_.y_, b.min_.y_) || BakeEquals(b.max_.y_, a.min_.y_));
+
+            if (adjacent && BakeEquals(frictions[i], frictions[j]))
+            {
+                a.Merge(b);
+                rects.Erase(j);
+                frictions.Erase(j);
+                merged = true;
+                // The grown rectangle may now be adjacent to ones already skipped
+                j = i + 1;
+            }
+            else
+                ++j;
+        }
+    }
+
+    return merged;
+}
+
+/// Join poly lines whose end points coincide into longer chains, closing them into loops where possible.
+static void JoinPolyLines(Vector<BakedCollisionShape2D>& chains)
+{
+    for (unsigned i = 0; i < chains.Size(); ++i)
+    {
+        for (unsigned j = i + 1; j < chains.Size();)
+        {
+            PODVector<Vector2>& a = chains[i].vertices_;
+            PODVector<Vector2> b = chains[j].vertices_;
+            if (chains[i].loop_ || chains[j].loop_ || !BakeEquals(chains[i].friction_, chains[j].friction_))
+            {
+                ++j;
+                continue;
+            }
+
+            // Orient b so that it continues from the end of a, or leads into the start of a
+            if (BakeEquals(a.Back(), b.Back()) || BakeEquals(a.Front(), b.Front()))
+            {
+                for (unsigned k = 0; k < b.Size() / 2; ++k)
+                    Swap(b[k], b[b.Size() - 1 - k]);
+            }
+
+            if (BakeEquals(a.Back(), b.Front()))
+            {
+                for (unsigned k = 1; k < b.Size(); ++k)
+                    a.Push(b[k]);
+            }
+            else if (BakeEquals(b.Back(), a.Front()))
+            {
+                b.Pop();
+                a.Insert(0, b);
+            }
+            else
+            {
+                ++j;
+                continue;
+            }
+
+            chains.Erase(j);
+            j = i + 1;
+
+            if (a.Size() > 3 && BakeEquals(a.Front(), a.Back()))
+            {
+                a.Pop();
+                chains[i].loop_ = true;
+            }
+        }
+    }
+}
+
+void Sample2D::CreateMergedCollisionShapesFromTMXObjects(Node* tileMapNode, TileMapLayer3D* tileMapLayer, TileMapInfo2D info)
+{
+    // Isometric rectangles are built as rotated boxes, fall back to one shape per object
+    if (info.orientation_ != O_ORTHOGONAL)
+    {
+        CreateCollisionShapesFromTMXObjects(tileMapNode, tileMapLayer, info);
+        return;
+    }
+
+    // The bake is cached next to the tmx file and reused while the tmx file checksum matches
+    auto* cache = GetSubsystem<ResourceCache>();
+    TileMap3D* tileMap = tileMapLayer->GetTileMap();
+    TmxFile2D* tmxFile = tileMap ? tileMap->GetTmxFile() : nullptr;
+    String tmxFileName = tmxFile ? cache->GetResourceFileName(tmxFile->GetName()) : String::EMPTY;
+    String bakeFileName;
+    unsigned tmxChecksum = 0;
+    if (!tmxFileName.Empty())
+    {
+        File tmxFileData(context_, tmxFileName, FILE_READ);
+        if (tmxFileData.IsOpen())
+        {
+            String layerName = tileMapLayer->GetTmxLayer() ? tileMapLayer->GetTmxLayer()->GetName() : String::EMPTY;
+            bakeFileName = ReplaceExtension(tmxFileName, "_" + layerName.Replaced(' ', '_') + ".collision.xml");
+            tmxChecksum = tmxFileData.GetChecksum();
+        }
+    }
+
+    Vector<BakedCollisionShape2D> shapes;
+    if (bakeFileName.Empty() || !LoadBakedCollisionShapes(bakeFileName, tmxChecksum, shapes))
+    {
+        shapes.Clear();
+        BakeCollisionShapes(tileMapLayer, shapes);
+        if (!bakeFileName.Empty())
+            SaveBakedCollisionShapes(bakeFileName, tmxChecksum, shapes);
+    }
+
+    // Create rigid body to the root node
+    auto* body = tileMapNode->CreateComponent<RigidBody2D>();
+    body->SetBodyType(BT_STATIC);
+
+    for (unsigned i = 0; i < shapes.Size(); ++i)
+    {
+        const BakedCollisionShape2D& baked = shapes[i];
+        CollisionShape2D* shape = nullptr;
+
+        switch (baked.type_)
+        {
+            case OT_RECTANGLE:
+            {
+                auto* box = tileMapNode->CreateComponent<CollisionBox2D>();
+                box->SetCenter(baked.vertices_[0]);
+                box->SetSize(baked.vertices_[1]);
+                shape = box;
+            }
+            break;
+
+            case OT_ELLIPSE:
+            {
+                auto* circle = tileMapNode->CreateComponent<CollisionCircle2D>();
+                circle->SetCenter(baked.vertices_[0]);
+                circle->SetRadius(baked.vertices_[1].x_);
+                shape = circle;
+            }
+            break;
+
+            case OT_POLYGON:
+            {
+                auto* polygon = tileMapNode->CreateComponent<CollisionPolygon2D>();
+                polygon->SetVertices(baked.vertices_);
+                shape = polygon;
+            }
+            break;
+
+            case OT_POLYLINE:
+            {
+                auto* chain = tileMapNode->CreateComponent<CollisionChain2D>();
+                chain->SetLoop(baked.loop_);
+                chain->SetVertices(baked.vertices_);
+                shape = chain;
+            }
+            break;
+
+            default:
+                break;
+        }
+
+        if (shape)
+            shape->SetFriction(baked.friction_);
+    }
+}
+
+void Sample2D::BakeCollisionShapes(TileMapLayer3D* tileMapLayer, Vector<BakedCollisionShape2D>& shapes)
+{
+    PODVector<Rect> rects;
+    PODVector<float> rectFrictions;
+    Vector<BakedCollisionShape2D> chains;
+
+    shapes.Clear();
+
+    for (unsigned i = 0; i < tileMapLayer->GetNumObjects(); ++i)
+    {
+        TileMapObject2D* tileMapObject = tileMapLayer->GetObject(i);
+        BakedCollisionShape2D baked;
+        baked.type_ = tileMapObject->GetObjectType();
+        baked.friction_ = GetObjectFriction(tileMapObject);
+
+        switch (baked.type_)
+        {
+            case OT_RECTANGLE:
+                rects.Push(Rect(tileMapObject->GetPosition(), tileMapObject->GetPosition() + tileMapObject->GetSize()));
+                rectFrictions.Push(baked.friction_);
+                break;
+
+            case OT_ELLIPSE:
+                // Ellipse is built as a Circle shape as it doesn't exist in Box2D
+                baked.vertices_.Push(tileMapObject->GetPosition() + tileMapObject->GetSize() / 2);
+                baked.vertices_.Push(Vector2(tileMapObject->GetSize().x_ / 2, 0.0f));
+                shapes.Push(baked);
+                break;
+
+            case OT_POLYGON:
+            case OT_POLYLINE:
+                for (unsigned j = 0; j < tileMapObject->GetNumPoints(); ++j)
+                    baked.vertices_.Push(tileMapObject->GetPoint(j));
+                // Drop degenerate shapes, which loading the baked shapes would reject
+                if (!IsValidBakedShape(baked.type_, baked.vertices_.Size()))
+                    break;
+                if (baked.type_ == OT_POLYGON)
+                    shapes.Push(baked);
+                else
+                    chains.Push(baked);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // Merge rows first, then columns, until the set of rectangles is stable
+    for (;;)
+    {
+        bool merged = MergeRectangles(rects, rectFrictions, true);
+        merged |= MergeRectangles(rects, rectFrictions, false);
+        if (!merged)
+            break;
+    }
+
+    for (unsigned i = 0; i < rects.Size(); ++i)
+    {
+        BakedCollisionShape2D baked;
+        baked.type_ = OT_RECTANGLE;
+        baked.vertices_.Push(rects[i].Center());
+        baked.vertices_.Push(rects[i].Size());
+        baked.friction_ = rectFrictions[i];
+        shapes.Push(baked);
+    }
+
+    JoinPolyLines(chains);
+    shapes.Push(chains);
+
+    URHO3D_LOGINFOF("Baked %u tmx collision objects into %u shapes", tileMapLayer->GetNumObjects(), shapes.Size());
+}
+
+bool Sample2D::LoadBakedCollisionShapes(const String& fileName, unsigned tmxChecksum, Vector<BakedCollisionShape2D>& shapes)
+{
+    if (!GetSubsystem<FileSystem>()->FileExists(fileName))
+        return false;
+
+    File file(context_, fileName, FILE_READ);
+    XMLFile xml(context_);
+    if (!xml.Load(file))
+        return false;
+
+    XMLElement rootElem = xml.GetRoot("collision");
+    if (!rootElem || !rootElem.HasAttribute("tmxChecksum") || rootElem.GetUInt("tmxChecksum") != tmxChecksum)
+        return false;
+
+    // Reject a truncated or hand-edited cache: the stored counts must match the content and each shape must have the vertices its type needs
+    shapes.Clear();
+    for (XMLElement shapeElem = rootElem.GetChild("shape"); shapeElem; shapeElem = shapeElem.GetNext("shape"))
+    {
+        BakedCollisionShape2D baked;
+        baked.type_ = (TileMapObjectType2D)shapeElem.GetUInt("type");
+        baked.friction_ = shapeElem.GetFloat("friction");
+        baked.loop_ = shapeElem.GetBool("loop");
+        for (XMLElement vertexElem = shapeElem.GetChild("vertex"); vertexElem; vertexElem = vertexElem.GetNext("vertex"))
+            baked.vertices_.Push(vertexElem.GetVector2("value"));
+
+        unsigned numVertices = baked.vertices_.Size();
+        if (numVertices != shapeElem.GetUInt("numVertices") || !IsValidBakedShape(baked.type_, numVertices))
+        {
+            URHO3D_LOGWARNING("Invalid baked collision shape in " + fileName + ", rebaking");
+            shapes.Clear();
+            return false;
+        }
+        shapes.Push(baked);
+    }
+
+    if (shapes.Size() != rootElem.GetUInt("numShapes"))
+    {
+        URHO3D_LOGWARNING("Baked collision shape count mismatch in " + fileName + ", rebaking");
+        shapes.Clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool Sample2D::SaveBakedCollisionShapes(const String& fileName, unsigned tmxChecksum, const Vector<BakedCollisionShape2D>& shapes)
+{
+    XMLFile xml(context_);
+    XMLElement rootElem = xml.CreateRoot("collision");
+    rootElem.SetUInt("tmxChecksum", tmxChecksum);
+    rootElem.SetUInt("numShapes", shapes.Size());
+
+    for (unsigned i = 0; i < shapes.Size(); ++i)
+    {
+        const BakedCollisionShape2D& baked = shapes[i];
+        XMLElement shapeElem = rootElem.CreateChild("shape");
+        shapeElem.SetUInt("type", baked.type_);
+        shapeElem.SetFloat("friction", baked.friction_);
+        if (baked.loop_)
+            shapeElem.SetBool("loop", true);
+        shapeElem.SetUInt("numVertices", baked.vertices_.Size());
+        for (unsigned j = 0; j < baked.vertices_.Size(); ++j)
+            shapeElem.CreateChild("vertex").SetVector2("value", baked.vertices_[j]);
+    }
+
+    File file(context_, fileName, FILE_WRITE);
+    if (!file.IsOpen() || !xml.Save(file))
+    {
+        URHO3D_LOGWARNING("Could not save baked collision shapes to " + fileName);
+        return false;
+    }
+
+    return true;
+}
+
 CollisionBox2D* Sample2D::CreateRectangleShape(Node* node, TileMapObject2D* object, Vector2 size, TileMapInfo2D info)
 {
     auto* shape = node->CreateComponent<CollisionBox2D>();
@@ -652,6 +1029,7 @@ void Sample2D::PopulateTriggers(TileMapLayer3D* triggersLayer)
         {
             Node* triggerClone = triggerNode->Clone();
             triggerClone->SetName(triggerObject->GetType());
+            SetEntityTag(triggerClone, GetEntityTagFromType(triggerObject->GetType()));
             auto* shape = triggerClone->GetComponent<CollisionBox2D>();
             shape->SetSize(triggerObject->GetSize());
             triggerClone->SetPosition2D(triggerObject->GetPosition() + triggerObject->GetSize() / 2);
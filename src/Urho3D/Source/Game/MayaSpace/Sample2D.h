@@ -23,6 +23,7 @@
 #pragma once
 
 #include <Urho3D/Core/Object.h>
+#include <Urho3D/Scene/Node.h>
 #include <Urho3D/Urho2D/TileMapLayer3D.h>
 #include <Urho3D/Urho2D/CollisionBox2D.h>
 #include <Urho3D/Urho2D/CollisionCircle2D.h>
@@ -45,6 +46,53 @@ using namespace Urho3D;
 const float CAMERA_MIN_DIST = 1.5f;
 const float CAMERA_MAX_DIST = 50.0f;
 
+/// Gameplay role of a scene node. Resolved once when the node is created so that contact handling compares integers instead of node names.
+enum EntityTag2D
+{
+    ET_NONE = 0,
+    ET_PLAYER,
+    ET_ENEMY,
+    ET_PICKUP,
+    ET_COIN,
+    ET_CLIMB,
+    ET_CAN_JUMP,
+    ET_SLOPE,
+    ET_LAVA,
+    ET_EXIT,
+    ET_TILEMAP
+};
+
+/// Node variable holding the entity tag. Stored as a node variable so that it survives scene save / load.
+static const StringHash VAR_ENTITY_TAG(URHO3D_STRINGHASH("EntityTag"));
+
+/// Set the entity tag of a node.
+inline void SetEntityTag(Node* node, EntityTag2D tag)
+{
+    node->SetVar(VAR_ENTITY_TAG, (int)tag);
+}
+
+/// Return the entity tag of a node, ET_NONE if untagged.
+inline EntityTag2D GetEntityTag(const Node* node)
+{
+    return node ? (EntityTag2D)node->GetVar(VAR_ENTITY_TAG).GetInt() : ET_NONE;
+}
+
+/// Return the entity tag for a Tiled object type name, ET_NONE if the type has no gameplay role.
+EntityTag2D GetEntityTagFromType(const String& type);
+
+/// Static collision shape baked from tmx objects, ready to be turned into a Box2D fixture.
+struct BakedCollisionShape2D
+{
+    /// Source object type: OT_RECTANGLE (merged box), OT_ELLIPSE (circle), OT_POLYGON or OT_POLYLINE (joined chain).
+    TileMapObjectType2D type_{OT_INVALID};
+    /// Box center and size, circle center and radius (x), or polygon/chain vertices.
+    PODVector<Vector2> vertices_;
+    /// Friction.
+    float friction_{0.8f};
+    /// Whether a joined chain is closed.
+    bool loop_{};
+};
+
 /// Convenient functions for Urho2D samples:
 ///    - Generate collision shapes from a tmx file objects
 ///    - Create Spriter Imp character
@@ -67,6 +115,14 @@ public:
 
     /// Generate physics collision shapes from the tmx file's objects located in tileMapLayer.
     void CreateCollisionShapesFromTMXObjects(Node* tileMapNode, TileMapLayer3D* tileMapLayer, TileMapInfo2D info);
+    /// Generate physics collision shapes from the tmx file's objects located in tileMapLayer, merging adjacent solids. The baked result is cached next to the tmx file.
+    void CreateMergedCollisionShapesFromTMXObjects(Node* tileMapNode, TileMapLayer3D* tileMapLayer, TileMapInfo2D info);
+    /// Merge the tmx file's objects located in tileMapLayer into a minimal set of static shapes.
+    void BakeCollisionShapes(TileMapLayer3D* tileMapLayer, Vector<BakedCollisionShape2D>& shapes);
+    /// Load baked collision shapes. Return false if the cache is missing, malformed or was baked from a different tmx file.
+    bool LoadBakedCollisionShapes(const String& fileName, unsigned tmxChecksum, Vector<BakedCollisionShape2D>& shapes);
+    /// Save baked collision shapes along with the checksum of the tmx file they were baked from.
+    bool SaveBakedCollisionShapes(const String& fileName, unsigned tmxChecksum, const Vector<BakedCollisionShape2D>& shapes);
     /// Build collision shape from Tiled 'Rectangle' objects.
     CollisionBox2D* CreateRectangleShape(Node* node, TileMapObject2D* object, Vector2 size, TileMapInfo2D info);
     /// Build collision shape from Tiled 'Ellipse' objects.
@@ -125,6 +125,7 @@ void Urho3DPlayer::Setup()
             "-nosound     Disable sound output\n"
             "-noip        Disable sound mixing interpolation\n"
             "-touch       Touch emulation on desktop platform\n"
+            "-trace <file> Capture a profiler trace of all threads until exit and save it as Chrome trace JSON\n"
             #endif
         );
     }
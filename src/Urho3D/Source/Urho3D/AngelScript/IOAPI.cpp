@@ -152,6 +152,10 @@ static void RegisterLog(asIScriptEngine* engine)
     engine->RegisterGlobalProperty("const int LOG_ERROR", (void*)&LOG_ERROR);
     engine->RegisterGlobalProperty("const int LOG_NONE", (void*)&LOG_NONE);
 
+    engine->RegisterEnum("LogOverflowPolicy");
+    engine->RegisterEnumValue("LogOverflowPolicy", "LOG_OVERFLOW_DROP", LOG_OVERFLOW_DROP);
+    engine->RegisterEnumValue("LogOverflowPolicy", "LOG_OVERFLOW_BLOCK", LOG_OVERFLOW_BLOCK);
+
     RegisterObject<Log>(engine, "Log");
     engine->RegisterObjectMethod("Log", "void Open(const String&in)", asMETHOD(Log, Open), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "void Close()", asMETHOD(Log, Close), asCALL_THISCALL);
@@ -168,6 +172,12 @@ static void RegisterLog(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Log", "String get_lastMessage()", asMETHOD(Log, GetLastMessage), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "void set_quiet(bool)", asMETHOD(Log, SetQuiet), asCALL_THISCALL);
     engine->RegisterObjectMethod("Log", "bool get_quiet() const", asMETHOD(Log, IsQuiet), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void SetAsync(bool, uint queueSize = 4096)", asMETHOD(Log, SetAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "bool get_async() const", asMETHOD(Log, IsAsync), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void Flush()", asMETHOD(Log, Flush), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "void set_overflowPolicy(LogOverflowPolicy)", asMETHOD(Log, SetOverflowPolicy), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "LogOverflowPolicy get_overflowPolicy() const", asMETHOD(Log, GetOverflowPolicy), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Log", "uint get_numDroppedMessages() const", asMETHOD(Log, GetNumDroppedMessages), asCALL_THISCALL);
     engine->RegisterGlobalFunction("Log@+ get_log()", asFUNCTION(GetLog), asCALL_CDECL);
 
     // Register also Print() functions for convenience
@@ -48,7 +48,7 @@ const char* AUDIO_CATEGORY = "Audio";
 static const int MIN_BUFFERLENGTH = 20;
 static const int MIN_MIXRATE = 11025;
 static const int MAX_MIXRATE = 48000;
-static const StringHash SOUND_MASTER_HASH("Master");
+static const StringHash SOUND_MASTER_HASH(URHO3D_STRINGHASH("Master"));
 
 static void SDLAudioCallback(void* userdata, Uint8* stream, int len);
 
@@ -22,6 +22,10 @@
 
 #include "../Precompiled.h"
 
+#include "../Math/MathDefs.h"
+
+#include <atomic>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -119,4 +123,299 @@ void AllocatorFree(AllocatorBlock* allocator, void* ptr)
     allocator->free_ = node;
 }
 
+/// Pool allocator node sizes, 16 bytes apart up to 128, 32 bytes apart up to 256 and 64 bytes apart up to 512.
+static const unsigned poolNodeSizes[POOL_NUM_SIZE_CLASSES] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512
+};
+
+/// Number of nodes moved between a thread cache and the global free list at once.
+static const unsigned POOL_BATCH_SIZE = 32;
+/// Number of free nodes per size class a thread cache can hold before returning a batch to the global free list.
+static const unsigned POOL_MAX_CACHED_NODES = POOL_BATCH_SIZE * 2;
+/// Size of the memory chunks that are divided into nodes.
+static const unsigned POOL_CHUNK_SIZE = 64 * 1024;
+
+/// Pool allocator free node.
+struct PoolNode
+{
+    /// Next free node.
+    PoolNode* next_;
+};
+
+/// Pool allocator size class shared by all threads. Aligned to a cache line so that threads using different size classes do not contend.
+struct alignas(64) PoolSizeClass
+{
+    /// Spin lock guarding the free list.
+    std::atomic<bool> lock_;
+    /// Global free list.
+    PoolNode* free_;
+    /// Bytes currently allocated. Can be transiently negative, as threads report their allocations and frees separately.
+    std::atomic<long long> bytesInUse_;
+    /// Highest number of bytes allocated at once.
+    std::atomic<long long> peakBytesInUse_;
+    /// Bytes reserved from the heap.
+    std::atomic<unsigned long long> bytesReserved_;
+    /// Total number of allocations.
+    std::atomic<unsigned long long> numAllocations_;
+};
+
+/// Global size classes. Zero-initialized without constructors, so they can be used during static initialization and destruction.
+static PoolSizeClass poolSizeClasses[POOL_NUM_SIZE_CLASSES];
+
+/// Pool allocator spin lock.
+class PoolLock
+{
+public:
+    /// Construct and acquire the lock of a size class.
+    explicit PoolLock(PoolSizeClass& sizeClass) :
+        sizeClass_(sizeClass)
+    {
+        while (sizeClass_.lock_.exchange(true, std::memory_order_acquire))
+        {
+        }
+    }
+
+    /// Destruct and release the lock.
+    ~PoolLock()
+    {
+        sizeClass_.lock_.store(false, std::memory_order_release);
+    }
+
+private:
+    /// Size class.
+    PoolSizeClass& sizeClass_;
+};
+
+/// Chain a list of nodes to the global free list of a size class.
+static void PoolReturnNodes(unsigned index, PoolNode* first, PoolNode* last)
+{
+    PoolSizeClass& sizeClass = poolSizeClasses[index];
+    PoolLock lock(sizeClass);
+    last->next_ = sizeClass.free_;
+    sizeClass.free_ = first;
+}
+
+/// Take up to the specified number of nodes from the global free list of a size class, allocating a new chunk if the free list is empty. Return the first node of the list and the number of nodes taken.
+static PoolNode* PoolTakeNodes(unsigned index, unsigned maxCount, unsigned& count)
+{
+    PoolSizeClass& sizeClass = poolSizeClasses[index];
+    {
+        PoolLock lock(sizeClass);
+        PoolNode* first = sizeClass.free_;
+        if (first)
+        {
+            PoolNode* last = first;
+            count = 1;
+            while (count < maxCount && last->next_)
+            {
+                last = last->next_;
+                ++count;
+            }
+            sizeClass.free_ = last->next_;
+            last->next_ = nullptr;
+            return first;
+        }
+    }
+
+    // Free nodes have been exhausted. Divide a new chunk into nodes, keep the requested amount and give the rest to the free list
+    unsigned nodeSize = poolNodeSizes[index];
+    unsigned numNodes = POOL_CHUNK_SIZE / nodeSize;
+    auto* chunk = new unsigned char[POOL_CHUNK_SIZE];
+    sizeClass.bytesReserved_.fetch_add(POOL_CHUNK_SIZE, std::memory_order_relaxed);
+
+    for (unsigned i = 0; i < numNodes - 1; ++i)
+        reinterpret_cast<PoolNode*>(chunk + i * nodeSize)->next_ = reinterpret_cast<PoolNode*>(chunk + (i + 1) * nodeSize);
+    reinterpret_cast<PoolNode*>(chunk + (numNodes - 1) * nodeSize)->next_ = nullptr;
+
+    count = Min(maxCount, numNodes);
+    if (count < numNodes)
+    {
+        reinterpret_cast<PoolNode*>(chunk + (count - 1) * nodeSize)->next_ = nullptr;
+        PoolReturnNodes(index, reinterpret_cast<PoolNode*>(chunk + count * nodeSize),
+            reinterpret_cast<PoolNode*>(chunk + (numNodes - 1) * nodeSize));
+    }
+
+    return reinterpret_cast<PoolNode*>(chunk);
+}
+
+/// Per-thread cache of free pool nodes and statistics not yet added to the size classes. Has no constructor or destructor, so that accessing it needs no thread-local initialization check.
+struct PoolThreadCache
+{
+    /// Free lists.
+    PoolNode* free_[POOL_NUM_SIZE_CLASSES];
+    /// Number of nodes in the free lists.
+    unsigned numFree_[POOL_NUM_SIZE_CLASSES];
+    /// Change in allocated nodes since the statistics were last updated.
+    int numInUse_[POOL_NUM_SIZE_CLASSES];
+    /// Allocations since the statistics were last updated.
+    unsigned numAllocations_[POOL_NUM_SIZE_CLASSES];
+    /// Whether the cache is registered for release at thread exit.
+    bool registered_;
+    /// Whether the cache has been released at thread exit.
+    bool destroyed_;
+};
+
+/// Calling thread's cache.
+static thread_local PoolThreadCache poolThreadCache;
+
+/// Add the statistics gathered by the calling thread to a size class.
+static void PoolUpdateStats(unsigned index)
+{
+    PoolSizeClass& sizeClass = poolSizeClasses[index];
+    long long delta = (long long)poolThreadCache.numInUse_[index] * poolNodeSizes[index];
+    long long bytesInUse = sizeClass.bytesInUse_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    long long peakBytesInUse = sizeClass.peakBytesInUse_.load(std::memory_order_relaxed);
+    while (bytesInUse > peakBytesInUse &&
+        !sizeClass.peakBytesInUse_.compare_exchange_weak(peakBytesInUse, bytesInUse, std::memory_order_relaxed))
+    {
+    }
+    sizeClass.numAllocations_.fetch_add(poolThreadCache.numAllocations_[index], std::memory_order_relaxed);
+
+    poolThreadCache.numInUse_[index] = 0;
+    poolThreadCache.numAllocations_[index] = 0;
+}
+
+/// Releases the calling thread's cache at thread exit.
+struct PoolThreadCacheGuard
+{
+    /// Destruct. Return the cached nodes to the global free lists and update the statistics.
+    ~PoolThreadCacheGuard()
+    {
+        for (unsigned i = 0; i < POOL_NUM_SIZE_CLASSES; ++i)
+        {
+            PoolUpdateStats(i);
+
+            PoolNode* first = poolThreadCache.free_[i];
+            if (!first)
+                continue;
+
+            PoolNode* last = first;
+            while (last->next_)
+                last = last->next_;
+            PoolReturnNodes(i, first, last);
+            poolThreadCache.free_[i] = nullptr;
+            poolThreadCache.numFree_[i] = 0;
+        }
+
+        poolThreadCache.destroyed_ = true;
+    }
+};
+
+/// Register the calling thread's cache for release at thread exit.
+static void PoolRegisterThreadCache()
+{
+    static thread_local PoolThreadCacheGuard guard;
+    (void)guard;
+    poolThreadCache.registered_ = true;
+}
+
+unsigned PoolAllocatorGetSizeClass(unsigned size)
+{
+    if (size <= 128)
+        return size ? (size - 1) >> 4u : 0;
+    else if (size <= 256)
+        return 8 + ((size - 129) >> 5u);
+    else if (size <= POOL_MAX_NODE_SIZE)
+        return 12 + ((size - 257) >> 6u);
+    else
+        return POOL_NUM_SIZE_CLASSES;
+}
+
+void* PoolAllocatorReserve(unsigned size)
+{
+    unsigned index = PoolAllocatorGetSizeClass(size);
+    if (index >= POOL_NUM_SIZE_CLASSES)
+        return new unsigned char[size];
+
+    PoolThreadCache& cache = poolThreadCache;
+    if (cache.destroyed_)
+    {
+        // Allocating during thread exit after the cache has been released, so go directly to the global free list
+        unsigned count;
+        PoolNode* node = PoolTakeNodes(index, 1, count);
+        ++cache.numInUse_[index];
+        ++cache.numAllocations_[index];
+        PoolUpdateStats(index);
+        return node;
+    }
+
+    if (!cache.free_[index])
+    {
+        if (!cache.registered_)
+            PoolRegisterThreadCache();
+        cache.free_[index] = PoolTakeNodes(index, POOL_BATCH_SIZE, cache.numFree_[index]);
+        PoolUpdateStats(index);
+    }
+
+    PoolNode* node = cache.free_[index];
+    cache.free_[index] = node->next_;
+    --cache.numFree_[index];
+    ++cache.numInUse_[index];
+    ++cache.numAllocations_[index];
+    return node;
+}
+
+void PoolAllocatorFree(void* ptr, unsigned size)
+{
+    if (!ptr)
+        return;
+
+    unsigned index = PoolAllocatorGetSizeClass(size);
+    if (index >= POOL_NUM_SIZE_CLASSES)
+    {
+        delete[] static_cast<unsigned char*>(ptr);
+        return;
+    }
+
+    auto* node = static_cast<PoolNode*>(ptr);
+    PoolThreadCache& cache = poolThreadCache;
+    --cache.numInUse_[index];
+    if (cache.destroyed_)
+    {
+        PoolUpdateStats(index);
+        PoolReturnNodes(index, node, node);
+        return;
+    }
+
+    if (!cache.registered_)
+        PoolRegisterThreadCache();
+    node->next_ = cache.free_[index];
+    cache.free_[index] = node;
+    if (++cache.numFree_[index] > POOL_MAX_CACHED_NODES)
+    {
+        // Return a batch to the global free list so that other threads can reuse the nodes
+        PoolNode* last = node;
+        for (unsigned i = 1; i < POOL_BATCH_SIZE; ++i)
+            last = last->next_;
+        cache.free_[index] = last->next_;
+        cache.numFree_[index] -= POOL_BATCH_SIZE;
+        PoolReturnNodes(index, node, last);
+        PoolUpdateStats(index);
+    }
+}
+
+PoolAllocatorStats PoolAllocatorGetStats(unsigned sizeClass)
+{
+    PoolAllocatorStats stats{};
+    if (sizeClass >= POOL_NUM_SIZE_CLASSES)
+        return stats;
+
+    const PoolSizeClass& src = poolSizeClasses[sizeClass];
+    stats.nodeSize_ = poolNodeSizes[sizeClass];
+    stats.bytesInUse_ = (unsigned long long)Max(src.bytesInUse_.load(std::memory_order_relaxed), 0LL);
+    stats.peakBytesInUse_ = (unsigned long long)src.peakBytesInUse_.load(std::memory_order_relaxed);
+    stats.bytesReserved_ = src.bytesReserved_.load(std::memory_order_relaxed);
+    stats.numAllocations_ = src.numAllocations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+unsigned long long PoolAllocatorGetBytesInUse()
+{
+    long long bytesInUse = 0;
+    for (unsigned i = 0; i < POOL_NUM_SIZE_CLASSES; ++i)
+        bytesInUse += poolSizeClasses[i].bytesInUse_.load(std::memory_order_relaxed);
+    return (unsigned long long)Max(bytesInUse, 0LL);
+}
+
 }
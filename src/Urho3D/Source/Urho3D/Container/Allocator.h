@@ -67,6 +67,37 @@ URHO3D_API void* AllocatorReserve(AllocatorBlock* allocator);
 /// Free a node. Does not free any blocks.
 URHO3D_API void AllocatorFree(AllocatorBlock* allocator, void* ptr);
 
+/// Number of size classes in the pool allocator.
+static const unsigned POOL_NUM_SIZE_CLASSES = 16;
+/// Largest allocation served by the pool allocator. Larger allocations are passed through to the heap.
+static const unsigned POOL_MAX_NODE_SIZE = 512;
+
+/// Pool allocator statistics of one size class. Each thread reports its allocations when it exchanges nodes with the global free list, so the statistics can lag behind by the nodes held in the thread caches.
+struct PoolAllocatorStats
+{
+    /// Node size in bytes.
+    unsigned nodeSize_;
+    /// Bytes currently allocated, counted in whole nodes.
+    unsigned long long bytesInUse_;
+    /// Highest number of bytes allocated at once.
+    unsigned long long peakBytesInUse_;
+    /// Bytes reserved from the heap for nodes. Pool memory is kept for reuse and never returned to the heap.
+    unsigned long long bytesReserved_;
+    /// Total number of allocations.
+    unsigned long long numAllocations_;
+};
+
+/// Allocate memory from the size-class pool allocator. Thread-safe: each thread allocates from its own cache of free nodes, which is refilled from a global free list in batches. Memory is aligned to 16 bytes.
+URHO3D_API void* PoolAllocatorReserve(unsigned size);
+/// Free memory allocated by PoolAllocatorReserve(). The size must be the same as when allocating. Can be called from any thread.
+URHO3D_API void PoolAllocatorFree(void* ptr, unsigned size);
+/// Return the size class for an allocation size, or POOL_NUM_SIZE_CLASSES if too large to be pooled.
+URHO3D_API unsigned PoolAllocatorGetSizeClass(unsigned size);
+/// Return statistics of a size class.
+URHO3D_API PoolAllocatorStats PoolAllocatorGetStats(unsigned sizeClass);
+/// Return bytes currently allocated from all size classes.
+URHO3D_API unsigned long long PoolAllocatorGetBytesInUse();
+
 /// %Allocator template class. Allocates objects of a specific class.
 template <class T> class Allocator
 {
@@ -124,4 +155,11 @@ private:
     AllocatorBlock* allocator_;
 };
 
+/// Define class-specific new and delete operators that allocate the objects from the pool allocator. Also used by derived classes. A compilation unit that allocates such objects should not include DebugNew.h.
+#define URHO3D_POOL_ALLOCATED \
+    static void* operator new(size_t size) { return Urho3D::PoolAllocatorReserve((unsigned)size); } \
+    static void operator delete(void* ptr, size_t size) { Urho3D::PoolAllocatorFree(ptr, (unsigned)size); } \
+    static void* operator new(size_t, void* ptr) { return ptr; } \
+    static void operator delete(void*, void*) { }
+
 }
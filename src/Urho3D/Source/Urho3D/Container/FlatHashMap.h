@@ -0,0 +1,632 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include "../Container/Hash.h"
+#include "../Container/Pair.h"
+#include "../Container/Sort.h"
+#include "../Container/Vector.h"
+
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace Urho3D
+{
+
+/// Open-addressing hash map template class. Pairs are stored contiguously in insertion order and located through a Robin Hood hashed index table kept in the same allocation, so lookups touch few cache lines and inserting does not allocate per pair. Erasing moves the last pair into the erased position. Unlike HashMap, inserting may invalidate iterators and pointers to values.
+template <class T, class U> class FlatHashMap
+{
+public:
+    using KeyType = T;
+    using ValueType = U;
+
+    /// Hash map key-value pair with const key.
+    class KeyValue
+    {
+    public:
+        /// Construct with default key.
+        KeyValue() :
+            first_(T())
+        {
+        }
+
+        /// Construct with key and value.
+        KeyValue(const T& first, const U& second) :
+            first_(first),
+            second_(second)
+        {
+        }
+
+        /// Copy-construct.
+        KeyValue(const KeyValue& value) :
+            first_(value.first_),
+            second_(value.second_)
+        {
+        }
+
+        /// Move-construct.
+        KeyValue(KeyValue&& value) :
+            first_(value.first_),
+            second_(std::move(value.second_))
+        {
+        }
+
+        /// Prevent assignment.
+        KeyValue& operator =(const KeyValue& rhs) = delete;
+
+        /// Test for equality with another pair.
+        bool operator ==(const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
+
+        /// Test for inequality with another pair.
+        bool operator !=(const KeyValue& rhs) const { return first_ != rhs.first_ || second_ != rhs.second_; }
+
+        /// Key.
+        const T first_;
+        /// Value.
+        U second_;
+    };
+
+    /// Hash map iterator.
+    using Iterator = RandomAccessIterator<KeyValue>;
+    /// Hash map const iterator.
+    using ConstIterator = RandomAccessConstIterator<KeyValue>;
+
+    /// Construct empty.
+    FlatHashMap() = default;
+
+    /// Construct from another hash map.
+    FlatHashMap(const FlatHashMap<T, U>& map)
+    {
+        Reserve(map.size_);
+        Insert(map);
+    }
+
+    /// Move-construct from another hash map.
+    FlatHashMap(FlatHashMap<T, U>&& map) noexcept
+    {
+        Swap(map);
+    }
+
+    /// Aggregate initialization constructor.
+    FlatHashMap(const std::initializer_list<Pair<T, U> >& list)
+    {
+        Reserve((unsigned)list.size());
+        for (auto it = list.begin(); it != list.end(); it++)
+            Insert(*it);
+    }
+
+    /// Destruct.
+    ~FlatHashMap()
+    {
+        Clear();
+        delete[] reinterpret_cast<unsigned char*>(pairs_);
+    }
+
+    /// Assign a hash map.
+    FlatHashMap& operator =(const FlatHashMap<T, U>& rhs)
+    {
+        // In case of self-assignment do nothing
+        if (&rhs != this)
+        {
+            Clear();
+            Reserve(rhs.size_);
+            Insert(rhs);
+        }
+        return *this;
+    }
+
+    /// Move-assign a hash map.
+    FlatHashMap& operator =(FlatHashMap<T, U>&& rhs) noexcept
+    {
+        Swap(rhs);
+        return *this;
+    }
+
+    /// Add-assign a pair.
+    FlatHashMap& operator +=(const Pair<T, U>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Add-assign a hash map.
+    FlatHashMap& operator +=(const FlatHashMap<T, U>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+
+    /// Test for equality with another hash map.
+    bool operator ==(const FlatHashMap<T, U>& rhs) const
+    {
+        if (rhs.size_ != size_)
+            return false;
+
+        const unsigned* rhsHashes = rhs.Hashes();
+        for (unsigned i = 0; i < rhs.size_; ++i)
+        {
+            unsigned index = FindIndex(rhs.pairs_[i].first_, rhsHashes[i]);
+            if (index == NOT_FOUND || pairs_[index].second_ != rhs.pairs_[i].second_)
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Test for inequality with another hash map.
+    bool operator !=(const FlatHashMap<T, U>& rhs) const { return !(*this == rhs); }
+
+    /// Index the map. Create a new pair if key not found.
+    U& operator [](const T& key)
+    {
+        unsigned hash = HashKey(key);
+        unsigned index = FindIndex(key, hash);
+        if (index == NOT_FOUND)
+            index = InsertPair(key, U(), hash);
+        return pairs_[index].second_;
+    }
+
+    /// Index the map. Return null if key is not found, does not create a new pair.
+    U* operator [](const T& key) const
+    {
+        unsigned index = FindIndex(key, HashKey(key));
+        return index != NOT_FOUND ? &pairs_[index].second_ : 0;
+    }
+
+#ifndef COVERITY_SCAN_MODEL
+    /// Populate the map using variadic template. This handles the base case.
+    FlatHashMap& Populate(const T& key, const U& value)
+    {
+        this->operator [](key) = value;
+        return *this;
+    };
+    /// Populate the map using variadic template.
+    template <typename... Args> FlatHashMap& Populate(const T& key, const U& value, const Args&... args)
+    {
+        this->operator [](key) = value;
+        return Populate(args...);
+    };
+#endif
+
+    /// Insert a pair. Return an iterator to it.
+    Iterator Insert(const Pair<T, U>& pair)
+    {
+        return Iterator(pairs_ + InsertOrAssign(pair.first_, pair.second_));
+    }
+
+    /// Insert a pair. Return iterator and set exists flag according to whether the key already existed.
+    Iterator Insert(const Pair<T, U>& pair, bool& exists)
+    {
+        unsigned oldSize = size_;
+        Iterator ret(pairs_ + InsertOrAssign(pair.first_, pair.second_));
+        exists = size_ == oldSize;
+        return ret;
+    }
+
+    /// Insert a map.
+    void Insert(const FlatHashMap<T, U>& map)
+    {
+        // Reuse the stored hashes of the source map
+        const unsigned* mapHashes = map.Hashes();
+        for (unsigned i = 0; i < map.size_; ++i)
+        {
+            unsigned index = FindIndex(map.pairs_[i].first_, mapHashes[i]);
+            if (index != NOT_FOUND)
+                pairs_[index].second_ = map.pairs_[i].second_;
+            else
+                InsertPair(map.pairs_[i].first_, map.pairs_[i].second_, mapHashes[i]);
+        }
+    }
+
+    /// Insert a pair by iterator. Return iterator to the value.
+    Iterator Insert(const ConstIterator& it) { return Iterator(pairs_ + InsertOrAssign(it->first_, it->second_)); }
+
+    /// Insert a range by iterators.
+    void Insert(const ConstIterator& start, const ConstIterator& end)
+    {
+        ConstIterator it = start;
+        while (it != end)
+            Insert(it++);
+    }
+
+    /// Erase a pair. Return true if was found.
+    bool Erase(const T& key)
+    {
+        unsigned index = FindIndex(key, HashKey(key));
+        if (index == NOT_FOUND)
+            return false;
+
+        ErasePair(index);
+        return true;
+    }
+
+    /// Erase a pair by iterator. Return iterator to the next pair, which occupies the same position after erasing.
+    Iterator Erase(const Iterator& it)
+    {
+        if (it.ptr_ < pairs_ || it.ptr_ >= pairs_ + size_)
+            return End();
+
+        ErasePair((unsigned)(it.ptr_ - pairs_));
+        return it;
+    }
+
+    /// Clear the map. Keeps the allocated storage, so that a map reused every frame does not reallocate.
+    void Clear()
+    {
+        if (!size_)
+            return;
+
+        for (unsigned i = 0; i < size_; ++i)
+            (pairs_ + i)->~KeyValue();
+        size_ = 0;
+        memset(IndexTable(), 0, IndexSize() * sizeof(unsigned));
+    }
+
+    /// Sort pairs. After sorting the map can be iterated in order until new elements are inserted.
+    void Sort()
+    {
+        if (size_ < 2)
+            return;
+
+        PODVector<KeyValue*> ptrs(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            ptrs[i] = pairs_ + i;
+        Urho3D::Sort(ptrs.Begin(), ptrs.End(), ComparePairs);
+
+        // Move the pairs into a new buffer in sorted order
+        KeyValue* newPairs = AllocatePairs(capacity_);
+        unsigned* newHashes = reinterpret_cast<unsigned*>(newPairs + capacity_);
+        const unsigned* hashes = Hashes();
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            new(newPairs + i) KeyValue(std::move(*ptrs[i]));
+            newHashes[i] = hashes[ptrs[i] - pairs_];
+        }
+        ReplacePairs(newPairs, capacity_);
+    }
+
+    /// Reserve storage for the specified number of pairs. Return true if the storage was reallocated.
+    bool Reserve(unsigned numPairs)
+    {
+        if (numPairs <= capacity_)
+            return false;
+
+        unsigned newCapacity = capacity_ ? capacity_ : MIN_CAPACITY;
+        while (newCapacity < numPairs)
+            newCapacity <<= 1;
+        Reallocate(newCapacity);
+        return true;
+    }
+
+    /// Return iterator to the pair with key, or end iterator if not found.
+    Iterator Find(const T& key)
+    {
+        unsigned index = FindIndex(key, HashKey(key));
+        return index != NOT_FOUND ? Iterator(pairs_ + index) : End();
+    }
+
+    /// Return const iterator to the pair with key, or end iterator if not found.
+    ConstIterator Find(const T& key) const
+    {
+        unsigned index = FindIndex(key, HashKey(key));
+        return index != NOT_FOUND ? ConstIterator(pairs_ + index) : End();
+    }
+
+    /// Return whether contains a pair with key.
+    bool Contains(const T& key) const { return FindIndex(key, HashKey(key)) != NOT_FOUND; }
+
+    /// Try to copy value to output. Return true if was found.
+    bool TryGetValue(const T& key, U& out) const
+    {
+        unsigned index = FindIndex(key, HashKey(key));
+        if (index == NOT_FOUND)
+            return false;
+
+        out = pairs_[index].second_;
+        return true;
+    }
+
+    /// Return all the keys.
+    Vector<T> Keys() const
+    {
+        Vector<T> result;
+        result.Reserve(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            result.Push(pairs_[i].first_);
+        return result;
+    }
+
+    /// Return all the values.
+    Vector<U> Values() const
+    {
+        Vector<U> result;
+        result.Reserve(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            result.Push(pairs_[i].second_);
+        return result;
+    }
+
+    /// Return iterator to the beginning.
+    Iterator Begin() { return Iterator(pairs_); }
+
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(pairs_); }
+
+    /// Return iterator to the end.
+    Iterator End() { return Iterator(pairs_ + size_); }
+
+    /// Return iterator to the end.
+    ConstIterator End() const { return ConstIterator(pairs_ + size_); }
+
+    /// Return first pair.
+    const KeyValue& Front() const
+    {
+        assert(size_);
+        return pairs_[0];
+    }
+
+    /// Return last pair.
+    const KeyValue& Back() const
+    {
+        assert(size_);
+        return pairs_[size_ - 1];
+    }
+
+    /// Return number of pairs.
+    unsigned Size() const { return size_; }
+
+    /// Return number of pairs that fit without reallocating.
+    unsigned Capacity() const { return capacity_; }
+
+    /// Return number of slots in the index table.
+    unsigned NumBuckets() const { return IndexSize(); }
+
+    /// Return whether map is empty.
+    bool Empty() const { return size_ == 0; }
+
+    /// Swap with another hash map.
+    void Swap(FlatHashMap<T, U>& map)
+    {
+        Urho3D::Swap(pairs_, map.pairs_);
+        Urho3D::Swap(size_, map.size_);
+        Urho3D::Swap(capacity_, map.capacity_);
+    }
+
+private:
+    /// Index value returned when a key is not found.
+    static const unsigned NOT_FOUND = 0xffffffff;
+    /// Initial pair capacity.
+    static const unsigned MIN_CAPACITY = 4;
+
+    /// Return the stored hashes, parallel to the pairs.
+    unsigned* Hashes() const { return reinterpret_cast<unsigned*>(pairs_ + capacity_); }
+
+    /// Return the index table. Each slot holds a pair index plus one, or zero when empty.
+    unsigned* IndexTable() const { return Hashes() + capacity_; }
+
+    /// Return number of slots in the index table. Kept at twice the pair capacity, so the load factor stays at or below one half.
+    unsigned IndexSize() const { return capacity_ * 2; }
+
+    /// Hash a key. The hash is mixed so that the low bits used for the index table are well distributed also for pointer and integer keys.
+    static unsigned HashKey(const T& key)
+    {
+        unsigned hash = MakeHash(key);
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6b;
+        hash ^= hash >> 13;
+        return hash;
+    }
+
+    /// Return distance of an index table slot from the home slot of a hash.
+    static unsigned ProbeDistance(unsigned slot, unsigned hash, unsigned mask) { return (slot - hash) & mask; }
+
+    /// Return index of the pair with key, or NOT_FOUND.
+    unsigned FindIndex(const T& key, unsigned hash) const
+    {
+        if (!size_)
+            return NOT_FOUND;
+
+        const unsigned* hashes = Hashes();
+        const unsigned* table = IndexTable();
+        unsigned mask = IndexSize() - 1;
+        for (unsigned slot = hash & mask, distance = 0;; slot = (slot + 1) & mask, ++distance)
+        {
+            unsigned entry = table[slot];
+            if (!entry)
+                return NOT_FOUND;
+            unsigned index = entry - 1;
+            if (hashes[index] == hash && pairs_[index].first_ == key)
+                return index;
+            // A resident closer to its home slot than the probe means that the key would have displaced it
+            if (ProbeDistance(slot, hashes[index], mask) < distance)
+                return NOT_FOUND;
+        }
+    }
+
+    /// Insert a pair or assign the value of an existing pair. Return its index.
+    unsigned InsertOrAssign(const T& key, const U& value)
+    {
+        unsigned hash = HashKey(key);
+        unsigned index = FindIndex(key, hash);
+        if (index != NOT_FOUND)
+        {
+            pairs_[index].second_ = value;
+            return index;
+        }
+        return InsertPair(key, value, hash);
+    }
+
+    /// Append a pair whose key is known not to exist. Return its index.
+    unsigned InsertPair(const T& key, const U& value, unsigned hash)
+    {
+        if (size_ == capacity_)
+        {
+            // The value may refer to a pair in this map, so construct the new pair before moving the old ones
+            unsigned newCapacity = capacity_ ? capacity_ << 1 : MIN_CAPACITY;
+            KeyValue* newPairs = AllocatePairs(newCapacity);
+            new(newPairs + size_) KeyValue(key, value);
+            MovePairs(newPairs, newCapacity);
+        }
+        else
+            new(pairs_ + size_) KeyValue(key, value);
+
+        unsigned index = size_++;
+        Hashes()[index] = hash;
+        InsertSlot(index);
+        return index;
+    }
+
+    /// Add a pair to the index table, displacing residents that are closer to their home slot.
+    void InsertSlot(unsigned index)
+    {
+        const unsigned* hashes = Hashes();
+        unsigned* table = IndexTable();
+        unsigned mask = IndexSize() - 1;
+        unsigned entry = index + 1;
+        unsigned distance = 0;
+        for (unsigned slot = hashes[index] & mask;; slot = (slot + 1) & mask, ++distance)
+        {
+            unsigned& resident = table[slot];
+            if (!resident)
+            {
+                resident = entry;
+                return;
+            }
+            unsigned residentDistance = ProbeDistance(slot, hashes[resident - 1], mask);
+            if (residentDistance < distance)
+            {
+                Urho3D::Swap(resident, entry);
+                distance = residentDistance;
+            }
+        }
+    }
+
+    /// Return the index table slot referring to a pair.
+    unsigned FindSlot(unsigned index) const
+    {
+        const unsigned* table = IndexTable();
+        unsigned mask = IndexSize() - 1;
+        unsigned slot = Hashes()[index] & mask;
+        while (table[slot] != index + 1)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    /// Erase a pair by index.
+    void ErasePair(unsigned index)
+    {
+        unsigned* hashes = Hashes();
+        unsigned* table = IndexTable();
+        unsigned mask = IndexSize() - 1;
+
+        // Shift the following residents back instead of leaving a tombstone
+        unsigned slot = FindSlot(index);
+        for (;;)
+        {
+            unsigned next = (slot + 1) & mask;
+            unsigned entry = table[next];
+            if (!entry || ProbeDistance(next, hashes[entry - 1], mask) == 0)
+                break;
+            table[slot] = entry;
+            slot = next;
+        }
+        table[slot] = 0;
+
+        // Move the last pair into the hole to keep the pairs contiguous
+        unsigned last = size_ - 1;
+        (pairs_ + index)->~KeyValue();
+        if (index != last)
+        {
+            table[FindSlot(last)] = index + 1;
+            new(pairs_ + index) KeyValue(std::move(pairs_[last]));
+            (pairs_ + last)->~KeyValue();
+            hashes[index] = hashes[last];
+        }
+        size_ = last;
+    }
+
+    /// Reallocate the storage to a new pair capacity.
+    void Reallocate(unsigned newCapacity) { MovePairs(AllocatePairs(newCapacity), newCapacity); }
+
+    /// Move the pairs and hashes into new storage, then rebuild the index table.
+    void MovePairs(KeyValue* newPairs, unsigned newCapacity)
+    {
+        unsigned* newHashes = reinterpret_cast<unsigned*>(newPairs + newCapacity);
+        const unsigned* hashes = Hashes();
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            new(newPairs + i) KeyValue(std::move(pairs_[i]));
+            newHashes[i] = hashes[i];
+        }
+        ReplacePairs(newPairs, newCapacity);
+    }
+
+    /// Destruct the moved-from pairs, free the old storage and rebuild the index table for the new storage.
+    void ReplacePairs(KeyValue* newPairs, unsigned newCapacity)
+    {
+        for (unsigned i = 0; i < size_; ++i)
+            (pairs_ + i)->~KeyValue();
+        delete[] reinterpret_cast<unsigned char*>(pairs_);
+
+        pairs_ = newPairs;
+        capacity_ = newCapacity;
+        memset(IndexTable(), 0, IndexSize() * sizeof(unsigned));
+        for (unsigned i = 0; i < size_; ++i)
+            InsertSlot(i);
+    }
+
+    /// Allocate storage for pairs, their hashes and the index table.
+    static KeyValue* AllocatePairs(unsigned capacity)
+    {
+        return reinterpret_cast<KeyValue*>(new unsigned char[capacity * (sizeof(KeyValue) + 3 * sizeof(unsigned))]);
+    }
+
+    /// Compare two pairs by key.
+    static bool ComparePairs(KeyValue*& lhs, KeyValue*& rhs) { return lhs->first_ < rhs->first_; }
+
+    /// Pairs, followed by their hashes and the index table in the same allocation.
+    KeyValue* pairs_{};
+    /// Number of pairs.
+    unsigned size_{};
+    /// Pair capacity.
+    unsigned capacity_{};
+};
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator begin(const Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::ConstIterator end(const Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator begin(Urho3D::FlatHashMap<T, U>& v) { return v.Begin(); }
+
+template <class T, class U> typename Urho3D::FlatHashMap<T, U>::Iterator end(Urho3D::FlatHashMap<T, U>& v) { return v.End(); }
+
+}
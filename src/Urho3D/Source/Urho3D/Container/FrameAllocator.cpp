@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/FrameAllocator.h"
+#include "../Container/Vector.h"
+#include "../Core/Mutex.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Minimum size of a frame allocator block.
+static const unsigned MIN_BLOCK_SIZE = 64 * 1024;
+/// Alignment of frame allocations.
+static const unsigned ALLOCATION_ALIGNMENT = 16;
+
+/// Memory block of a frame allocator.
+struct FrameAllocatorBlock
+{
+    /// Previous block.
+    FrameAllocatorBlock* previous_;
+    /// Usable size.
+    unsigned size_;
+    /// Aligned start of the usable memory.
+    unsigned char* data_;
+};
+
+std::atomic<unsigned> FrameAllocator::frameNumber_{};
+std::atomic<unsigned long long> FrameAllocator::peakFrameBytes_{};
+
+/// Registry of the frame allocators of all threads, for statistics.
+static Mutex& GetRegistryMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+static PODVector<FrameAllocator*>& GetRegistry()
+{
+    static PODVector<FrameAllocator*> registry;
+    return registry;
+}
+
+static inline unsigned AlignSize(unsigned size)
+{
+    return (size + ALLOCATION_ALIGNMENT - 1) & ~(ALLOCATION_ALIGNMENT - 1);
+}
+
+FrameAllocator::FrameAllocator() :
+    block_(nullptr),
+    offset_(0),
+    capacity_(0),
+    usedBytes_(0),
+    frame_(GetFrameNumber())
+{
+    MutexLock lock(GetRegistryMutex());
+    GetRegistry().Push(this);
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    {
+        MutexLock lock(GetRegistryMutex());
+        GetRegistry().Remove(this);
+    }
+    FreeBlocks();
+}
+
+void* FrameAllocator::Allocate(unsigned size)
+{
+    size = AlignSize(Max(size, 1U));
+    if (!block_ || offset_ + size > block_->size_)
+        AllocateBlock(size);
+
+    void* ptr = block_->data_ + offset_;
+    offset_ += size;
+    usedBytes_.store(usedBytes_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    return ptr;
+}
+
+bool FrameAllocator::Extend(void* ptr, unsigned oldSize, unsigned newSize)
+{
+    oldSize = AlignSize(oldSize);
+    newSize = AlignSize(newSize);
+    // Only the most recent allocation of the current block can grow
+    if (!block_ || static_cast<unsigned char*>(ptr) + oldSize != block_->data_ + offset_)
+        return false;
+    if (offset_ - oldSize + newSize > block_->size_)
+        return false;
+
+    offset_ += newSize - oldSize;
+    usedBytes_.store(usedBytes_.load(std::memory_order_relaxed) + newSize - oldSize, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameAllocator::Reset()
+{
+    // If the frame needed several blocks, replace them with one block so that the next frame is served from a single block
+    if (block_ && block_->previous_)
+    {
+        unsigned totalCapacity = capacity_;
+        FreeBlocks();
+        AllocateBlock(totalCapacity);
+    }
+
+    offset_ = 0;
+    usedBytes_.store(0, std::memory_order_relaxed);
+    frame_.store(GetFrameNumber(), std::memory_order_relaxed);
+}
+
+FrameAllocator& FrameAllocator::Get()
+{
+    static thread_local FrameAllocator allocator;
+    if (allocator.frame_.load(std::memory_order_relaxed) != GetFrameNumber())
+        allocator.Reset();
+    return allocator;
+}
+
+void FrameAllocator::AdvanceFrame()
+{
+    unsigned long long frameBytes = GetFrameBytes();
+    if (frameBytes > peakFrameBytes_.load(std::memory_order_relaxed))
+        peakFrameBytes_.store(frameBytes, std::memory_order_relaxed);
+
+    frameNumber_.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned long long FrameAllocator::GetFrameBytes()
+{
+    unsigned frameNumber = GetFrameNumber();
+    unsigned long long frameBytes = 0;
+
+    MutexLock lock(GetRegistryMutex());
+    const PODVector<FrameAllocator*>& registry = GetRegistry();
+    for (PODVector<FrameAllocator*>::ConstIterator i = registry.Begin(); i != registry.End(); ++i)
+    {
+        // Allocators not yet reset for this frame have allocated nothing in it
+        if ((*i)->frame_.load(std::memory_order_relaxed) == frameNumber)
+            frameBytes += (*i)->GetUsedBytes();
+    }
+
+    return frameBytes;
+}
+
+void FrameAllocator::AllocateBlock(unsigned minSize)
+{
+    unsigned size = Max(Max(minSize, MIN_BLOCK_SIZE), capacity_);
+    auto* memory = new unsigned char[sizeof(FrameAllocatorBlock) + ALLOCATION_ALIGNMENT + size];
+    auto* block = reinterpret_cast<FrameAllocatorBlock*>(memory);
+    block->previous_ = block_;
+    block->size_ = size;
+    block->data_ = reinterpret_cast<unsigned char*>((reinterpret_cast<size_t>(memory) + sizeof(FrameAllocatorBlock) +
+        ALLOCATION_ALIGNMENT - 1) & ~(size_t)(ALLOCATION_ALIGNMENT - 1));
+
+    block_ = block;
+    offset_ = 0;
+    capacity_ += size;
+}
+
+void FrameAllocator::FreeBlocks()
+{
+    while (block_)
+    {
+        FrameAllocatorBlock* previous = block_->previous_;
+        delete[] reinterpret_cast<unsigned char*>(block_);
+        block_ = previous;
+    }
+
+    offset_ = 0;
+    capacity_ = 0;
+}
+
+}
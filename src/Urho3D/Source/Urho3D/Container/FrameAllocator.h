@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#ifdef URHO3D_IS_BUILDING
+#include "Urho3D.h"
+#else
+#include <Urho3D/Urho3D.h>
+#endif
+
+#include "../Container/VectorBase.h"
+#include "../Math/MathDefs.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+namespace Urho3D
+{
+
+struct FrameAllocatorBlock;
+
+/// Linear allocator for memory that lives until the end of the frame. Allocating bumps a pointer, and all memory is released at once when the frame ends. Each thread has its own allocator, which resets itself on its first allocation in a new frame and is freed when the thread exits.
+class URHO3D_API FrameAllocator
+{
+public:
+    /// Construct.
+    FrameAllocator();
+    /// Destruct. Free all blocks.
+    ~FrameAllocator();
+
+    /// Prevent copy construction.
+    FrameAllocator(const FrameAllocator& rhs) = delete;
+    /// Prevent assignment.
+    FrameAllocator& operator =(const FrameAllocator& rhs) = delete;
+
+    /// Allocate memory aligned to 16 bytes.
+    void* Allocate(unsigned size);
+    /// Try to grow the most recent allocation in place. Return true if successful.
+    bool Extend(void* ptr, unsigned oldSize, unsigned newSize);
+    /// Release all memory. If several blocks were used, they are merged into one large enough for the whole frame.
+    void Reset();
+
+    /// Return bytes allocated since the last reset.
+    unsigned GetUsedBytes() const { return usedBytes_.load(std::memory_order_relaxed); }
+    /// Return total capacity of the allocated blocks.
+    unsigned GetCapacity() const { return capacity_; }
+
+    /// Return the frame allocator of the calling thread, reset first if a new frame has started.
+    static FrameAllocator& Get();
+    /// Start a new frame. Memory allocated during the previous frames must no longer be used. Called by Time at the end of each frame.
+    static void AdvanceFrame();
+    /// Return the current frame number of the frame allocators.
+    static unsigned GetFrameNumber() { return frameNumber_.load(std::memory_order_relaxed); }
+    /// Return bytes allocated during the current frame by all threads.
+    static unsigned long long GetFrameBytes();
+    /// Return the largest number of bytes allocated during one frame by all threads.
+    static unsigned long long GetPeakFrameBytes() { return peakFrameBytes_.load(std::memory_order_relaxed); }
+
+private:
+    /// Allocate a new block and make it current.
+    void AllocateBlock(unsigned minSize);
+    /// Free all blocks.
+    void FreeBlocks();
+
+    /// Current block.
+    FrameAllocatorBlock* block_;
+    /// Allocation offset in the current block.
+    unsigned offset_;
+    /// Total capacity of all blocks.
+    unsigned capacity_;
+    /// Bytes allocated since the last reset.
+    std::atomic<unsigned> usedBytes_;
+    /// Frame number the allocator was last reset for.
+    std::atomic<unsigned> frame_;
+
+    /// Current frame number.
+    static std::atomic<unsigned> frameNumber_;
+    /// Largest number of bytes allocated during one frame.
+    static std::atomic<unsigned long long> peakFrameBytes_;
+};
+
+/// %Vector template class for POD types with storage from the frame allocator of the thread that grows it. Clearing and reusing the vector in the next frame does no heap allocation, and nothing needs to be freed. The contents are only valid until the end of the frame; a vector left over from a previous frame behaves as empty.
+template <class T> class FramePODVector
+{
+public:
+    using ValueType = T;
+    using Iterator = RandomAccessIterator<T>;
+    using ConstIterator = RandomAccessConstIterator<T>;
+
+    /// Construct empty.
+    FramePODVector() = default;
+
+    /// Copy-construct from another vector.
+    FramePODVector(const FramePODVector<T>& vector)
+    {
+        *this = vector;
+    }
+
+    /// Assign from another vector.
+    FramePODVector<T>& operator =(const FramePODVector<T>& rhs)
+    {
+        // In case of self-assignment do nothing
+        if (&rhs != this)
+        {
+            Clear();
+            Resize(rhs.Size());
+            if (size_)
+                memcpy(buffer_, rhs.buffer_, size_ * sizeof(T));
+        }
+        return *this;
+    }
+
+    /// Return element at index.
+    T& operator [](unsigned index)
+    {
+        assert(index < Size());
+        return buffer_[index];
+    }
+
+    /// Return const element at index.
+    const T& operator [](unsigned index) const
+    {
+        assert(index < Size());
+        return buffer_[index];
+    }
+
+    /// Add an element at the end.
+    void Push(const T& value)
+    {
+        if (size_ >= capacity_ || frame_ != FrameAllocator::GetFrameNumber())
+            Reserve(size_ + 1);
+        buffer_[size_++] = value;
+    }
+
+    /// Remove the last element.
+    void Pop()
+    {
+        if (size_)
+            --size_;
+    }
+
+    /// Resize the vector. New elements are left uninitialized.
+    void Resize(unsigned newSize)
+    {
+        Reserve(newSize);
+        size_ = newSize;
+    }
+
+    /// Set new capacity, growing the buffer if necessary.
+    void Reserve(unsigned newCapacity)
+    {
+        // A buffer from a previous frame may have been reused by other allocations
+        if (frame_ != FrameAllocator::GetFrameNumber())
+            Release();
+        if (newCapacity <= capacity_)
+            return;
+
+        newCapacity = Max(Max(newCapacity, capacity_ + (capacity_ + 1) / 2), 8U);
+        FrameAllocator& allocator = FrameAllocator::Get();
+        if (!buffer_ || !allocator.Extend(buffer_, capacity_ * sizeof(T), newCapacity * sizeof(T)))
+        {
+            T* newBuffer = static_cast<T*>(allocator.Allocate(newCapacity * sizeof(T)));
+            if (size_)
+                memcpy(newBuffer, buffer_, size_ * sizeof(T));
+            buffer_ = newBuffer;
+        }
+        capacity_ = newCapacity;
+        frame_ = FrameAllocator::GetFrameNumber();
+    }
+
+    /// Remove all elements. The capacity is kept if still valid in this frame.
+    void Clear()
+    {
+        if (frame_ != FrameAllocator::GetFrameNumber())
+            Release();
+        size_ = 0;
+    }
+
+    /// Return iterator to the beginning.
+    Iterator Begin() { return Iterator(buffer_); }
+
+    /// Return const iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(buffer_); }
+
+    /// Return iterator to the end.
+    Iterator End() { return Iterator(buffer_ + Size()); }
+
+    /// Return const iterator to the end.
+    ConstIterator End() const { return ConstIterator(buffer_ + Size()); }
+
+    /// Return first element.
+    T& Front() { return buffer_[0]; }
+
+    /// Return const first element.
+    const T& Front() const { return buffer_[0]; }
+
+    /// Return last element.
+    T& Back()
+    {
+        assert(size_);
+        return buffer_[size_ - 1];
+    }
+
+    /// Return const last element.
+    const T& Back() const
+    {
+        assert(size_);
+        return buffer_[size_ - 1];
+    }
+
+    /// Return number of elements, or zero if the contents are from a previous frame.
+    unsigned Size() const { return frame_ == FrameAllocator::GetFrameNumber() ? size_ : 0; }
+
+    /// Return capacity.
+    unsigned Capacity() const { return capacity_; }
+
+    /// Return whether vector is empty.
+    bool Empty() const { return Size() == 0; }
+
+    /// Return the buffer.
+    T* Buffer() { return buffer_; }
+
+private:
+    /// Forget a buffer from a previous frame.
+    void Release()
+    {
+        buffer_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        frame_ = FrameAllocator::GetFrameNumber();
+    }
+
+    /// Buffer.
+    T* buffer_{};
+    /// Number of elements.
+    unsigned size_{};
+    /// Buffer capacity.
+    unsigned capacity_{};
+    /// Frame number the buffer was allocated in.
+    unsigned frame_{};
+};
+
+}
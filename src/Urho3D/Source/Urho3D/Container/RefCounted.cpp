@@ -24,8 +24,6 @@
 
 #include "../Container/RefCounted.h"
 
-#include "../DebugNew.h"
-
 namespace Urho3D
 {
 
@@ -28,12 +28,16 @@
 #include <Urho3D/Urho3D.h>
 #endif
 
+#include "../Container/Allocator.h"
+
 namespace Urho3D
 {
 
-/// Reference count structure.
+/// Reference count structure. Allocated from the pool allocator, as one is created for every reference-counted object.
 struct RefCount
 {
+    URHO3D_POOL_ALLOCATED
+
     /// Construct.
     RefCount() :
         refs_(0),
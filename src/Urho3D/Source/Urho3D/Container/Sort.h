@@ -25,6 +25,8 @@
 #include "../Container/Swap.h"
 #include "../Container/VectorBase.h"
 
+#include <cstring>
+
 namespace Urho3D
 {
 
@@ -33,6 +35,18 @@ static const int QUICKSORT_THRESHOLD = 16;
 // Based on Comparison of several sorting algorithms by Juha Nieminen
 // http://warp.povusers.org/SortComparison/
 
+/// Return the quicksort recursion depth after which introsort switches to heap sort.
+inline int GetIntroSortDepthLimit(int count)
+{
+    int depth = 0;
+    while (count > 1)
+    {
+        count >>= 1;
+        ++depth;
+    }
+    return depth * 2;
+}
+
 /// Perform insertion sort on an array.
 template <class T> void InsertionSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
 {
@@ -65,11 +79,56 @@ template <class T, class U> void InsertionSort(RandomAccessIterator<T> begin, Ra
     }
 }
 
-/// Perform quick sort initial pass on an array. Does not sort fully.
-template <class T> void InitialQuickSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
+/// Move an element down a binary max-heap until the heap property holds, using a compare function.
+template <class T, class U> void SiftDown(RandomAccessIterator<T> begin, int index, int count, U compare)
+{
+    T value = *(begin + index);
+    for (;;)
+    {
+        int child = index * 2 + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && compare(*(begin + child), *(begin + child + 1)))
+            ++child;
+        if (!compare(value, *(begin + child)))
+            break;
+        *(begin + index) = *(begin + child);
+        index = child;
+    }
+    *(begin + index) = value;
+}
+
+/// Perform heap sort on an array using a compare function.
+template <class T, class U> void HeapSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
+{
+    int count = (int)(end - begin);
+    for (int i = count / 2 - 1; i >= 0; --i)
+        SiftDown(begin, i, count, compare);
+    for (int i = count - 1; i > 0; --i)
+    {
+        Swap(*begin, *(begin + i));
+        SiftDown(begin, 0, i, compare);
+    }
+}
+
+/// Perform heap sort on an array.
+template <class T> void HeapSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
+{
+    HeapSort(begin, end, [](const T& lhs, const T& rhs) { return lhs < rhs; });
+}
+
+/// Perform introsort passes on an array: quicksort until the depth limit is exhausted, then heap sort the remaining partition. Partitions smaller than the quicksort threshold are left for the insertion sort.
+template <class T> void IntroSortLoop(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, int depthLimit)
 {
     while (end - begin > QUICKSORT_THRESHOLD)
     {
+        // Bad pivots have made the recursion too deep, guarantee O(n log n) for the rest
+        if (depthLimit-- <= 0)
+        {
+            HeapSort(begin, end);
+            return;
+        }
+
         // Choose the pivot by median
         RandomAccessIterator<T> pivot = begin + ((end - begin) / 2);
         if (*begin < *pivot && *(end - 1) < *begin)
@@ -91,16 +150,23 @@ template <class T> void InitialQuickSort(RandomAccessIterator<T> begin, RandomAc
                 break;
         }
 
-        InitialQuickSort(begin, j + 1);
+        IntroSortLoop(begin, j + 1, depthLimit);
         begin = j + 1;
     }
 }
 
-/// Perform quick sort initial pass on an array using a compare function. Does not sort fully.
-template <class T, class U> void InitialQuickSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
+/// Perform introsort passes on an array using a compare function.
+template <class T, class U> void IntroSortLoop(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, int depthLimit, U compare)
 {
     while (end - begin > QUICKSORT_THRESHOLD)
     {
+        // Bad pivots have made the recursion too deep, guarantee O(n log n) for the rest
+        if (depthLimit-- <= 0)
+        {
+            HeapSort(begin, end, compare);
+            return;
+        }
+
         // Choose the pivot by median
         RandomAccessIterator<T> pivot = begin + ((end - begin) / 2);
         if (compare(*begin, *pivot) && compare(*(end - 1), *begin))
@@ -122,23 +188,82 @@ template <class T, class U> void InitialQuickSort(RandomAccessIterator<T> begin,
                 break;
         }
 
-        InitialQuickSort(begin, j + 1, compare);
+        IntroSortLoop(begin, j + 1, depthLimit, compare);
         begin = j + 1;
     }
 }
 
-/// Sort in ascending order using quicksort for initial passes, then an insertion sort to finalize.
+/// Perform quick sort initial pass on an array. Does not sort fully.
+template <class T> void InitialQuickSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
+{
+    IntroSortLoop(begin, end, GetIntroSortDepthLimit((int)(end - begin)));
+}
+
+/// Perform quick sort initial pass on an array using a compare function. Does not sort fully.
+template <class T, class U> void InitialQuickSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
+{
+    IntroSortLoop(begin, end, GetIntroSortDepthLimit((int)(end - begin)), compare);
+}
+
+/// Sort in ascending order using introsort (quicksort falling back to heap sort on deep recursion) for initial passes, then an insertion sort to finalize.
 template <class T> void Sort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end)
 {
     InitialQuickSort(begin, end);
     InsertionSort(begin, end);
 }
 
-/// Sort in ascending order using quicksort for initial passes, then an insertion sort to finalize, using a compare function.
+/// Sort in ascending order using introsort (quicksort falling back to heap sort on deep recursion) for initial passes, then an insertion sort to finalize, using a compare function.
 template <class T, class U> void Sort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, U compare)
 {
     InitialQuickSort(begin, end, compare);
     InsertionSort(begin, end, compare);
 }
 
+/// Sort in ascending order of an unsigned 64-bit key returned by a key function, using a stable least significant digit radix sort with 8-bit digits. Digits that are the same for all keys are skipped. The temporary buffer must have room for the whole range. Elements are moved with memcpy, so only use for POD types.
+template <class T, class U> void RadixSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, RandomAccessIterator<T> temp, U getKey)
+{
+    auto count = (unsigned)(end - begin);
+    if (count < 2)
+        return;
+
+    // Count the digits of all passes at once
+    unsigned histograms[8][256];
+    memset(histograms, 0, sizeof histograms);
+    for (RandomAccessIterator<T> i = begin; i != end; ++i)
+    {
+        unsigned long long key = getKey(*i);
+        for (unsigned pass = 0; pass < 8; ++pass)
+            ++histograms[pass][(key >> (pass * 8)) & 0xff];
+    }
+
+    unsigned long long firstKey = getKey(*begin);
+    T* src = &*begin;
+    T* dest = &*temp;
+    for (unsigned pass = 0; pass < 8; ++pass)
+    {
+        unsigned shift = pass * 8;
+        unsigned* histogram = histograms[pass];
+        if (histogram[(firstKey >> shift) & 0xff] == count)
+            continue;
+
+        unsigned offset = 0;
+        for (unsigned digit = 0; digit < 256; ++digit)
+        {
+            unsigned digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (unsigned i = 0; i < count; ++i)
+            dest[histogram[(getKey(src[i]) >> shift) & 0xff]++] = src[i];
+
+        T* swap = src;
+        src = dest;
+        dest = swap;
+    }
+
+    if (src != &*begin)
+        memcpy(&*begin, src, count * sizeof(T));
+}
+
 }
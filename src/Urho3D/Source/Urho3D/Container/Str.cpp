@@ -417,18 +417,32 @@ String::Iterator String::Erase(const String::Iterator& start, const String::Iter
 
 void String::Resize(unsigned newLength)
 {
-    if (!capacity_)
+    if (!IsAllocated())
     {
-        // If zero length requested, do not allocate buffer yet
-        if (!newLength)
-            return;
-
-        // Calculate initial capacity
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
+        if (newLength < SMALL_CAPACITY)
+        {
+            // If zero length requested, keep pointing to the end zero. Otherwise use the inline buffer
+            if (buffer_ != smallBuffer_)
+            {
+                if (!newLength)
+                    return;
+                buffer_ = smallBuffer_;
+            }
+        }
+        else
+        {
+            // Calculate initial capacity
+            unsigned newCapacity = newLength + 1;
+            if (newCapacity < MIN_CAPACITY)
+                newCapacity = MIN_CAPACITY;
 
-        buffer_ = new char[capacity_];
+            auto* newBuffer = new char[newCapacity];
+            // Move the existing data out of the inline buffer before its storage is reused for the capacity
+            if (length_)
+                CopyChars(newBuffer, buffer_, length_);
+            buffer_ = newBuffer;
+            capacity_ = newCapacity;
+        }
     }
     else
     {
@@ -456,13 +470,40 @@ void String::Reserve(unsigned newCapacity)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
-    if (newCapacity == capacity_)
+
+    bool allocated = IsAllocated();
+    if (newCapacity <= SMALL_CAPACITY)
+    {
+        // Fits in the inline buffer. Move the existing data there if it was allocated
+        if (allocated)
+        {
+            char* oldBuffer = buffer_;
+            if (length_)
+            {
+                buffer_ = smallBuffer_;
+                CopyChars(buffer_, oldBuffer, length_ + 1);
+            }
+            else
+            {
+                buffer_ = &endZero;
+                capacity_ = 0;
+            }
+            delete[] oldBuffer;
+        }
+        else if (buffer_ == &endZero)
+        {
+            buffer_ = smallBuffer_;
+            buffer_[0] = 0;
+        }
+        return;
+    }
+    if (allocated && newCapacity == capacity_)
         return;
 
     auto* newBuffer = new char[newCapacity];
     // Move the existing data to the new buffer, then delete the old buffer
     CopyChars(newBuffer, buffer_, length_ + 1);
-    if (capacity_)
+    if (allocated)
         delete[] buffer_;
 
     capacity_ = newCapacity;
@@ -471,7 +512,7 @@ void String::Reserve(unsigned newCapacity)
 
 void String::Compact()
 {
-    if (capacity_)
+    if (IsAllocated())
         Reserve(length_ + 1);
 }
 
@@ -482,9 +523,21 @@ void String::Clear()
 
 void String::Swap(String& str)
 {
+    bool small = buffer_ == smallBuffer_;
+    bool strSmall = str.buffer_ == str.smallBuffer_;
+
     Urho3D::Swap(length_, str.length_);
-    Urho3D::Swap(capacity_, str.capacity_);
     Urho3D::Swap(buffer_, str.buffer_);
+
+    // The capacity shares storage with the inline buffer, so exchange it as raw bytes. Short strings live inside the object, so fix up their buffer pointers
+    char temp[SMALL_CAPACITY];
+    memcpy(temp, smallBuffer_, SMALL_CAPACITY);
+    memcpy(smallBuffer_, str.smallBuffer_, SMALL_CAPACITY);
+    memcpy(str.smallBuffer_, temp, SMALL_CAPACITY);
+    if (strSmall)
+        buffer_ = smallBuffer_;
+    if (small)
+        str.buffer_ = str.smallBuffer_;
 }
 
 String String::Substring(unsigned pos) const
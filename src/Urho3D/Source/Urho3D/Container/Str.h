@@ -163,7 +163,7 @@ public:
     /// Destruct.
     ~String()
     {
-        if (capacity_)
+        if (IsAllocated())
             delete[] buffer_;
     }
 
@@ -427,8 +427,11 @@ public:
     /// Return length.
     unsigned Length() const { return length_; }
 
-    /// Return buffer capacity.
-    unsigned Capacity() const { return capacity_; }
+    /// Return buffer capacity, including the inline buffer used for short strings.
+    unsigned Capacity() const { return buffer_ == smallBuffer_ ? SMALL_CAPACITY : capacity_; }
+
+    /// Return whether the string is stored in the inline buffer without a dynamic allocation.
+    bool IsSmall() const { return buffer_ == smallBuffer_; }
 
     /// Return whether the string is empty.
     bool Empty() const { return length_ == 0; }
@@ -509,10 +512,15 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size.
     static const unsigned MIN_CAPACITY = 8;
+    /// Size of the inline buffer for short strings, including the terminating zero. Sized so that the string fits in three pointers.
+    static const unsigned SMALL_CAPACITY = 3 * sizeof(void*) - sizeof(unsigned) - sizeof(char*);
     /// Empty string.
     static const String EMPTY;
 
 private:
+    /// Return whether the buffer is dynamically allocated.
+    bool IsAllocated() const { return buffer_ != smallBuffer_ && capacity_; }
+
     /// Move a range of characters within the string.
     void MoveRange(unsigned dest, unsigned src, unsigned count)
     {
@@ -542,9 +550,14 @@ private:
 
     /// String length.
     unsigned length_;
-    /// Capacity, zero if buffer not allocated.
-    unsigned capacity_;
-    /// String buffer, point to &endZero if buffer is not allocated.
+    union
+    {
+        /// Capacity, zero if buffer not allocated. Not valid for short strings.
+        unsigned capacity_;
+        /// Inline buffer for short strings, sharing storage with the capacity.
+        char smallBuffer_[SMALL_CAPACITY];
+    };
+    /// String buffer, point to &endZero if empty and not allocated, or to smallBuffer_ for short strings.
     char* buffer_;
 
     /// End zero for empty strings.
@@ -51,6 +51,8 @@ private:
 #ifndef _WIN32
     /// Mutex for the event, necessary for pthreads-based implementation.
     void* mutex_;
+    /// Signaled flag, so that a Set() before Wait() is not lost as with the Windows auto-reset event.
+    bool signaled_;
 #endif
     /// Operating system specific event.
     void* event_;
@@ -58,6 +58,25 @@ URHO3D_EVENT(E_POSTRENDERUPDATE, PostRenderUpdate)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Typed payload of the update, post-update, render update and post-render update events.
+class URHO3D_API UpdateEventData : public TypedEventData
+{
+public:
+    /// Construct.
+    explicit UpdateEventData(float timeStep = 0.0f) :
+        timeStep_(timeStep)
+    {
+    }
+
+    /// Write the payload to an event data map.
+    void ToVariantMap(VariantMap& eventData) const override { eventData[Update::P_TIMESTEP] = timeStep_; }
+    /// Read the payload from an event data map.
+    void FromVariantMap(const VariantMap& eventData) override { timeStep_ = GetParam(eventData, Update::P_TIMESTEP).GetFloat(); }
+
+    /// Time step.
+    float timeStep_;
+};
+
 /// Frame end event.
 URHO3D_EVENT(E_ENDFRAME, EndFrame)
 {
@@ -81,6 +81,18 @@ public:
 
         current_ = static_cast<EventProfilerBlock*>(current_)->GetChild(eventID);
         current_->Begin();
+        if (capturing_)
+            RecordTraceEvent(current_->name_);
+    }
+
+    /// End timing the current profiling block.
+    void EndBlock()
+    {
+        // Profiler supports only the main thread currently
+        if (!Thread::IsMainThread())
+            return;
+
+        Profiler::EndBlock();
     }
 
 private:
@@ -0,0 +1,415 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/Allocator.h"
+#include "../Container/FrameAllocator.h"
+#include "../Container/Sort.h"
+#include "../Core/CoreEvents.h"
+#include "../Core/Metrics.h"
+#include "../Core/WorkQueue.h"
+#include "../IO/Log.h"
+#include "../IO/Serializer.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static const char* builtinMetricNames[] =
+{
+    "FrameTime",
+    "DrawCalls",
+    "Batches",
+    "Primitives",
+    "WorkQueueUtilization",
+    "ResourceMemory",
+    "FrameAllocatorBytes",
+    "PoolAllocatorBytes"
+};
+
+static const MetricType builtinMetricTypes[] =
+{
+    METRIC_GAUGE,
+    METRIC_COUNTER,
+    METRIC_COUNTER,
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_GAUGE,
+    METRIC_GAUGE,
+    METRIC_GAUGE
+};
+
+/// Exponent of the lowest power of two covered by the histogram buckets.
+static const int HISTOGRAM_MIN_EXPONENT = -12;
+
+/// Return histogram bucket for a sample.
+static unsigned GetHistogramBucket(double value)
+{
+    if (!(value > 0.0))
+        return 0;
+
+    // Value is mantissa * 2^exponent with mantissa in [0.5, 1). Split each power of two into four buckets
+    int exponent;
+    double mantissa = frexp(value, &exponent);
+    int bucket = (exponent - HISTOGRAM_MIN_EXPONENT) * 4 + (int)((mantissa - 0.5) * 8.0);
+    return (unsigned)Clamp(bucket, 0, (int)METRIC_HISTOGRAM_BUCKETS - 1);
+}
+
+/// Return lower bound of a histogram bucket.
+static double GetHistogramBucketStart(unsigned bucket)
+{
+    return ldexp(0.5 + (bucket & 3) * 0.125, (int)(bucket >> 2) + HISTOGRAM_MIN_EXPONENT);
+}
+
+Metric::Metric() :
+    type_(METRIC_COUNTER),
+    value_(0.0),
+    numSamples_(0),
+    buckets_(nullptr)
+{
+}
+
+Metric::~Metric()
+{
+    delete[] buckets_;
+}
+
+Metrics::Metrics(Context* context) :
+    Object(context),
+    numMetrics_(0),
+    historySize_(DEFAULT_METRIC_HISTORY_SIZE),
+    numFrames_(0),
+    historyPos_(0),
+    segmentFrames_(0),
+    segmentPos_(0),
+    numSegmentFrames_(0),
+    lastBusyTime_(0)
+{
+    frameNumbers_.Resize(historySize_);
+    segmentFrames_ = (historySize_ + METRIC_HISTOGRAM_SEGMENTS - 1) / METRIC_HISTOGRAM_SEGMENTS;
+    for (unsigned i = 0; i < MAX_BUILTIN_METRICS; ++i)
+        RegisterMetric(builtinMetricNames[i], builtinMetricTypes[i]);
+
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(Metrics, HandleEndFrame));
+}
+
+Metrics::~Metrics() = default;
+
+unsigned Metrics::RegisterMetric(const String& name, MetricType type)
+{
+    unsigned id = GetMetricID(name);
+    if (id != M_MAX_UNSIGNED)
+        return id;
+
+    unsigned numMetrics = numMetrics_.load(std::memory_order_relaxed);
+    if (numMetrics >= MAX_METRICS)
+    {
+        URHO3D_LOGERROR("Can not register metric " + name + ", maximum number of metrics reached");
+        return M_MAX_UNSIGNED;
+    }
+
+    Metric& metric = metrics_[numMetrics];
+    metric.name_ = name;
+    metric.type_ = type;
+    metric.value_ = 0.0;
+    metric.numSamples_ = 0;
+    if (type == METRIC_HISTOGRAM)
+    {
+        metric.buckets_ = new std::atomic<unsigned>[METRIC_HISTOGRAM_BUCKETS];
+        for (unsigned i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i)
+            metric.buckets_[i] = 0;
+        metric.segmentBuckets_.Resize(METRIC_HISTOGRAM_SEGMENTS * METRIC_HISTOGRAM_BUCKETS);
+        metric.windowBuckets_.Resize(METRIC_HISTOGRAM_BUCKETS);
+        memset(metric.segmentBuckets_.Buffer(), 0, metric.segmentBuckets_.Size() * sizeof(unsigned));
+        memset(metric.windowBuckets_.Buffer(), 0, metric.windowBuckets_.Size() * sizeof(unsigned));
+    }
+    metric.history_.Resize(historySize_);
+    for (unsigned i = 0; i < historySize_; ++i)
+        metric.history_[i] = 0.0f;
+
+    // Publish only once set up, as other threads may be recording
+    numMetrics_.store(numMetrics + 1, std::memory_order_release);
+    return numMetrics;
+}
+
+void Metrics::SetHistorySize(unsigned frames)
+{
+    historySize_ = Max(frames, 1U);
+    segmentFrames_ = (historySize_ + METRIC_HISTOGRAM_SEGMENTS - 1) / METRIC_HISTOGRAM_SEGMENTS;
+    frameNumbers_.Resize(historySize_);
+    for (unsigned i = 0; i < numMetrics_; ++i)
+        metrics_[i].history_.Resize(historySize_);
+    Clear();
+}
+
+void Metrics::Clear()
+{
+    for (unsigned i = 0; i < numMetrics_; ++i)
+    {
+        Metric& metric = metrics_[i];
+        for (unsigned j = 0; j < historySize_; ++j)
+            metric.history_[j] = 0.0f;
+        if (metric.buckets_)
+        {
+            for (unsigned j = 0; j < METRIC_HISTOGRAM_BUCKETS; ++j)
+                metric.buckets_[j] = 0;
+            memset(metric.segmentBuckets_.Buffer(), 0, metric.segmentBuckets_.Size() * sizeof(unsigned));
+            memset(metric.windowBuckets_.Buffer(), 0, metric.windowBuckets_.Size() * sizeof(unsigned));
+        }
+    }
+
+    numFrames_ = 0;
+    historyPos_ = 0;
+    segmentPos_ = 0;
+    numSegmentFrames_ = 0;
+}
+
+void Metrics::Record(unsigned id, double value)
+{
+    if (id >= numMetrics_.load(std::memory_order_acquire))
+        return;
+
+    Metric& metric = metrics_[id];
+    AddAtomic(metric.value_, value);
+    metric.numSamples_.fetch_add(1, std::memory_order_relaxed);
+    if (metric.buckets_)
+        metric.buckets_[GetHistogramBucket(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::EndFrame()
+{
+    auto* time = GetSubsystem<Time>();
+    frameNumbers_[historyPos_] = time ? time->GetFrameNumber() : 0;
+
+    for (unsigned i = 0; i < numMetrics_; ++i)
+    {
+        Metric& metric = metrics_[i];
+        float value;
+        switch (metric.type_)
+        {
+        case METRIC_COUNTER:
+            value = (float)metric.value_.exchange(0.0, std::memory_order_relaxed);
+            break;
+
+        case METRIC_GAUGE:
+            value = (float)metric.value_.load(std::memory_order_relaxed);
+            break;
+
+        default:
+            {
+                unsigned numSamples = metric.numSamples_.exchange(0, std::memory_order_relaxed);
+                double sum = metric.value_.exchange(0.0, std::memory_order_relaxed);
+                value = numSamples ? (float)(sum / numSamples) : 0.0f;
+
+                // Move the frame's bucket counts into the current segment. Samples being recorded concurrently are
+                // left for the next frame
+                unsigned* segment = &metric.segmentBuckets_[segmentPos_ * METRIC_HISTOGRAM_BUCKETS];
+                for (unsigned j = 0; j < METRIC_HISTOGRAM_BUCKETS; ++j)
+                {
+                    unsigned count = metric.buckets_[j].load(std::memory_order_relaxed);
+                    if (count)
+                    {
+                        metric.buckets_[j].fetch_sub(count, std::memory_order_relaxed);
+                        segment[j] += count;
+                        metric.windowBuckets_[j] += count;
+                    }
+                }
+            }
+            break;
+        }
+        metric.history_[historyPos_] = value;
+    }
+
+    historyPos_ = (historyPos_ + 1) % historySize_;
+    if (numFrames_ < historySize_)
+        ++numFrames_;
+
+    // When a segment is full, drop the oldest one from the histogram window and reuse it
+    if (++numSegmentFrames_ >= segmentFrames_)
+    {
+        segmentPos_ = (segmentPos_ + 1) % METRIC_HISTOGRAM_SEGMENTS;
+        numSegmentFrames_ = 0;
+
+        for (unsigned i = 0; i < numMetrics_; ++i)
+        {
+            Metric& metric = metrics_[i];
+            if (!metric.buckets_)
+                continue;
+
+            unsigned* segment = &metric.segmentBuckets_[segmentPos_ * METRIC_HISTOGRAM_BUCKETS];
+            for (unsigned j = 0; j < METRIC_HISTOGRAM_BUCKETS; ++j)
+            {
+                metric.windowBuckets_[j] -= segment[j];
+                segment[j] = 0;
+            }
+        }
+    }
+}
+
+bool Metrics::SaveCSV(Serializer& dest) const
+{
+    String line = "Frame";
+    for (unsigned i = 0; i < numMetrics_; ++i)
+        line += "," + metrics_[i].name_;
+    if (!dest.WriteLine(line))
+        return false;
+
+    for (unsigned i = numFrames_; i > 0; --i)
+    {
+        unsigned index = (historyPos_ + historySize_ - i) % historySize_;
+        line = String(frameNumbers_[index]);
+        for (unsigned j = 0; j < numMetrics_; ++j)
+        {
+            line += ',';
+            line += String(metrics_[j].history_[index]);
+        }
+        if (!dest.WriteLine(line))
+            return false;
+    }
+
+    return true;
+}
+
+unsigned Metrics::GetMetricID(const String& name) const
+{
+    for (unsigned i = 0; i < numMetrics_; ++i)
+    {
+        if (metrics_[i].name_ == name)
+            return i;
+    }
+
+    return M_MAX_UNSIGNED;
+}
+
+const String& Metrics::GetMetricName(unsigned id) const
+{
+    return id < numMetrics_ ? metrics_[id].name_ : String::EMPTY;
+}
+
+MetricType Metrics::GetMetricType(unsigned id) const
+{
+    return id < numMetrics_ ? metrics_[id].type_ : METRIC_COUNTER;
+}
+
+float Metrics::GetValue(unsigned id, unsigned framesAgo) const
+{
+    if (id >= numMetrics_ || framesAgo >= numFrames_)
+        return 0.0f;
+
+    return metrics_[id].history_[(historyPos_ + historySize_ - 1 - framesAgo) % historySize_];
+}
+
+float Metrics::GetAverage(unsigned id) const
+{
+    if (id >= numMetrics_ || !numFrames_)
+        return 0.0f;
+
+    // Frames not yet stored are zero, so the whole buffer can be summed
+    float sum = 0.0f;
+    const PODVector<float>& history = metrics_[id].history_;
+    for (unsigned i = 0; i < historySize_; ++i)
+        sum += history[i];
+    return sum / numFrames_;
+}
+
+float Metrics::GetMax(unsigned id) const
+{
+    if (id >= numMetrics_ || !numFrames_)
+        return 0.0f;
+
+    float maxValue = -M_INFINITY;
+    for (unsigned i = 0; i < numFrames_; ++i)
+        maxValue = Max(maxValue, GetValue(id, i));
+    return maxValue;
+}
+
+float Metrics::GetPercentile(unsigned id, float percentile) const
+{
+    if (id >= numMetrics_ || !numFrames_)
+        return 0.0f;
+
+    PODVector<float> values(numFrames_);
+    for (unsigned i = 0; i < numFrames_; ++i)
+        values[i] = GetValue(id, i);
+    Sort(values.Begin(), values.End());
+
+    // Nearest-rank percentile
+    auto rank = (unsigned)ceilf(Clamp(percentile, 0.0f, 100.0f) * 0.01f * numFrames_);
+    return values[rank ? rank - 1 : 0];
+}
+
+float Metrics::GetSamplePercentile(unsigned id, float percentile) const
+{
+    if (id >= numMetrics_ || !metrics_[id].buckets_)
+        return 0.0f;
+
+    const PODVector<unsigned>& buckets = metrics_[id].windowBuckets_;
+    unsigned long long total = 0;
+    for (unsigned i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i)
+        total += buckets[i];
+    if (!total)
+        return 0.0f;
+
+    double target = Clamp(percentile, 0.0f, 100.0f) * 0.01 * total;
+    unsigned long long cumulative = 0;
+    for (unsigned i = 0; i < METRIC_HISTOGRAM_BUCKETS; ++i)
+    {
+        unsigned count = buckets[i];
+        if (count && cumulative + count >= target)
+        {
+            double start = GetHistogramBucketStart(i);
+            double end = GetHistogramBucketStart(i + 1);
+            return (float)(start + (end - start) * (target - cumulative) / count);
+        }
+        cumulative += count;
+    }
+
+    return (float)GetHistogramBucketStart(METRIC_HISTOGRAM_BUCKETS);
+}
+
+void Metrics::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    long long frameUSec = frameTimer_.GetUSec(true);
+    Set(METRIC_FRAME_TIME, frameUSec * 0.001);
+
+#ifdef URHO3D_THREADING
+    auto* workQueue = GetSubsystem<WorkQueue>();
+    if (workQueue && workQueue->GetNumThreads() && frameUSec > 0)
+    {
+        unsigned long long busyTime = workQueue->GetWorkerBusyTime();
+        Set(METRIC_WORK_QUEUE_UTILIZATION, (double)(busyTime - lastBusyTime_) / ((double)frameUSec * workQueue->GetNumThreads()));
+        lastBusyTime_ = busyTime;
+    }
+#endif
+
+    Set(METRIC_FRAME_ALLOCATOR_BYTES, (double)FrameAllocator::GetFrameBytes());
+    Set(METRIC_POOL_ALLOCATOR_BYTES, (double)PoolAllocatorGetBytesInUse());
+
+    EndFrame();
+}
+
+}
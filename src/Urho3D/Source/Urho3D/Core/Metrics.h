@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Core/Object.h"
+#include "../Core/Timer.h"
+
+#include <atomic>
+
+namespace Urho3D
+{
+
+class Serializer;
+
+/// Metric type.
+enum MetricType
+{
+    /// Sum of values added during the frame. Reset at the end of every frame.
+    METRIC_COUNTER = 0,
+    /// Last value set. Kept across frames.
+    METRIC_GAUGE,
+    /// Distribution of recorded samples. The frame history stores the mean of the samples recorded during the frame.
+    METRIC_HISTOGRAM
+};
+
+/// Built-in metrics. Registered by the metrics subsystem in this order.
+enum BuiltinMetric
+{
+    /// Frame time in milliseconds, measured between end of frame events.
+    METRIC_FRAME_TIME = 0,
+    /// Draw calls submitted by Graphics during the frame.
+    METRIC_DRAW_CALLS,
+    /// Batches rendered by Renderer during the frame.
+    METRIC_BATCHES,
+    /// Primitives rendered during the frame.
+    METRIC_PRIMITIVES,
+    /// Fraction of the frame the WorkQueue worker threads spent executing work items, from 0 to 1.
+    METRIC_WORK_QUEUE_UTILIZATION,
+    /// Memory used by resources in the ResourceCache, in bytes.
+    METRIC_RESOURCE_MEMORY,
+    /// Frame allocator memory used by all threads during the frame, in bytes.
+    METRIC_FRAME_ALLOCATOR_BYTES,
+    /// Memory allocated from the pool allocator by all threads, in bytes.
+    METRIC_POOL_ALLOCATOR_BYTES,
+    /// Number of built-in metrics.
+    MAX_BUILTIN_METRICS
+};
+
+/// Maximum number of metrics.
+static const unsigned MAX_METRICS = 128;
+/// Number of buckets in a histogram. Each power of two is split into four buckets.
+static const unsigned METRIC_HISTOGRAM_BUCKETS = 128;
+/// Number of segments the history is split into for histogram buckets. The oldest segment is dropped as the history advances.
+static const unsigned METRIC_HISTOGRAM_SEGMENTS = 8;
+/// Default number of frames kept in the metric history.
+static const unsigned DEFAULT_METRIC_HISTORY_SIZE = 600;
+
+/// Metric registered to the metrics subsystem.
+struct URHO3D_API Metric
+{
+    /// Construct.
+    Metric();
+    /// Destruct.
+    ~Metric();
+
+    /// Name.
+    String name_;
+    /// Type.
+    MetricType type_;
+    /// Counter sum, gauge value or histogram sample sum of the current frame.
+    std::atomic<double> value_;
+    /// Number of histogram samples in the current frame.
+    std::atomic<unsigned> numSamples_;
+    /// Histogram bucket sample counts of the current frame. Null for counters and gauges.
+    std::atomic<unsigned>* buckets_;
+    /// Histogram bucket sample counts of each history segment.
+    PODVector<unsigned> segmentBuckets_;
+    /// Histogram bucket sample counts summed over the history segments.
+    PODVector<unsigned> windowBuckets_;
+    /// Values of the past frames, as a ring buffer.
+    PODVector<float> history_;
+};
+
+/// Registry of per-frame engine and application metrics. Recording is lock-free and can be done from any thread, also while metrics are being registered, while registration and queries are done from the main thread.
+class URHO3D_API Metrics : public Object
+{
+    URHO3D_OBJECT(Metrics, Object);
+
+public:
+    /// Construct.
+    explicit Metrics(Context* context);
+    /// Destruct.
+    ~Metrics() override;
+
+    /// Register a metric, or return the ID of an existing metric with the same name. Return M_MAX_UNSIGNED if the maximum number of metrics is exceeded.
+    unsigned RegisterMetric(const String& name, MetricType type);
+    /// Set number of frames kept in the history. Clears the history.
+    void SetHistorySize(unsigned frames);
+    /// Clear the history and histogram buckets.
+    void Clear();
+    /// Add to a counter.
+    void Add(unsigned id, double value = 1.0)
+    {
+        if (id < numMetrics_.load(std::memory_order_acquire))
+            AddAtomic(metrics_[id].value_, value);
+    }
+    /// Set a gauge.
+    void Set(unsigned id, double value)
+    {
+        if (id < numMetrics_.load(std::memory_order_acquire))
+            metrics_[id].value_.store(value, std::memory_order_relaxed);
+    }
+    /// Record a histogram sample.
+    void Record(unsigned id, double value);
+    /// Store the current frame's values into the history. Called automatically at the end of the frame.
+    void EndFrame();
+    /// Write the history to a stream as comma-separated values, one row per frame from oldest to newest. Return true if successful.
+    bool SaveCSV(Serializer& dest) const;
+
+    /// Return ID of a metric by name, or M_MAX_UNSIGNED if not registered.
+    unsigned GetMetricID(const String& name) const;
+    /// Return number of registered metrics.
+    unsigned GetNumMetrics() const { return numMetrics_; }
+    /// Return metric name.
+    const String& GetMetricName(unsigned id) const;
+    /// Return metric type.
+    MetricType GetMetricType(unsigned id) const;
+    /// Return number of frames kept in the history.
+    unsigned GetHistorySize() const { return historySize_; }
+    /// Return number of frames currently stored in the history.
+    unsigned GetNumFrames() const { return numFrames_; }
+    /// Return the value of a past frame, 0 being the latest frame.
+    float GetValue(unsigned id, unsigned framesAgo = 0) const;
+    /// Return the average over the history.
+    float GetAverage(unsigned id) const;
+    /// Return the maximum over the history.
+    float GetMax(unsigned id) const;
+    /// Return a percentile (0-100) of the frame values in the history, for example 99 for the 99th percentile frame time.
+    float GetPercentile(unsigned id, float percentile) const;
+    /// Return a percentile (0-100) of the samples recorded to a histogram during the history, to the granularity of a history segment. Interpolated within the bucket.
+    float GetSamplePercentile(unsigned id, float percentile) const;
+
+private:
+    /// Handle end of frame.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Add to an atomic value.
+    static void AddAtomic(std::atomic<double>& dest, double value)
+    {
+        double current = dest.load(std::memory_order_relaxed);
+        while (!dest.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// Metrics.
+    Metric metrics_[MAX_METRICS];
+    /// Number of registered metrics. Published with release ordering after the metric is set up, for recording threads.
+    std::atomic<unsigned> numMetrics_;
+    /// Frame numbers of the history.
+    PODVector<unsigned> frameNumbers_;
+    /// Number of frames kept in the history.
+    unsigned historySize_;
+    /// Number of frames stored in the history.
+    unsigned numFrames_;
+    /// History position of the next frame.
+    unsigned historyPos_;
+    /// Number of frames in each histogram segment.
+    unsigned segmentFrames_;
+    /// Histogram segment of the current frame.
+    unsigned segmentPos_;
+    /// Frames stored into the current histogram segment.
+    unsigned numSegmentFrames_;
+    /// Frame timer.
+    HiresTimer frameTimer_;
+    /// WorkQueue busy time at the previous frame end.
+    unsigned long long lastBusyTime_;
+};
+
+}
@@ -83,45 +83,41 @@ Object::~Object()
     context_->RemoveEventSender(this);
 }
 
+void EventHandler::Invoke(TypedEventData& data, VariantMap& eventData)
+{
+    if (eventData.Empty())
+        data.ToVariantMap(eventData);
+
+    Invoke(eventData);
+}
+
 void Object::OnEvent(Object* sender, StringHash eventType, VariantMap& eventData)
 {
     if (blockEvents_)
         return;
 
-    // Make a copy of the context pointer in case the object is destroyed during event handler invocation
-    Context* context = context_;
-    EventHandler* specific = nullptr;
-    EventHandler* nonSpecific = nullptr;
-
-    EventHandler* handler = eventHandlers_.First();
-    while (handler)
+    EventHandler* handler = FindInvokedHandler(sender, eventType);
+    if (handler)
     {
-        if (handler->GetEventType() == eventType)
-        {
-            if (!handler->GetSender())
-                nonSpecific = handler;
-            else if (handler->GetSender() == sender)
-            {
-                specific = handler;
-                break;
-            }
-        }
-        handler = eventHandlers_.Next(handler);
+        // Make a copy of the context pointer in case the object is destroyed during event handler invocation
+        Context* context = context_;
+        context->SetEventHandler(handler);
+        handler->Invoke(eventData);
+        context->SetEventHandler(nullptr);
     }
+}
 
-    // Specific event handlers have priority, so if found, invoke first
-    if (specific)
-    {
-        context->SetEventHandler(specific);
-        specific->Invoke(eventData);
-        context->SetEventHandler(nullptr);
+void Object::OnTypedEvent(Object* sender, StringHash eventType, TypedEventData& data, VariantMap& eventData)
+{
+    if (blockEvents_)
         return;
-    }
 
-    if (nonSpecific)
+    EventHandler* handler = FindInvokedHandler(sender, eventType);
+    if (handler)
     {
-        context->SetEventHandler(nonSpecific);
-        nonSpecific->Invoke(eventData);
+        Context* context = context_;
+        context->SetEventHandler(handler);
+        handler->Invoke(data, eventData);
         context->SetEventHandler(nullptr);
     }
 }
@@ -295,6 +291,20 @@ void Object::SendEvent(StringHash eventType)
 }
 
 void Object::SendEvent(StringHash eventType, VariantMap& eventData)
+{
+    DispatchEvent(eventType, eventData, nullptr);
+}
+
+void Object::SendTypedEvent(StringHash eventType, TypedEventData& data)
+{
+    // Filled only if a handler needs it. The context's map for this nesting level is reused, so that its storage is
+    // not allocated on each send
+    VariantMap& eventData = GetEventDataMap();
+
+    DispatchEvent(eventType, eventData, &data);
+}
+
+void Object::DispatchEvent(StringHash eventType, VariantMap& eventData, TypedEventData* typedData)
 {
     if (!Thread::IsMainThread())
     {
@@ -327,7 +337,10 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
             if (!receiver)
                 continue;
 
-            receiver->OnEvent(this, eventType, eventData);
+            if (typedData)
+                receiver->OnTypedEvent(this, eventType, *typedData, eventData);
+            else
+                receiver->OnEvent(this, eventType, eventData);
 
             // If self has been destroyed as a result of event handling, exit
             if (self.Expired())
@@ -358,7 +371,10 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
                 if (!receiver)
                     continue;
 
-                receiver->OnEvent(this, eventType, eventData);
+                if (typedData)
+                    receiver->OnTypedEvent(this, eventType, *typedData, eventData);
+                else
+                    receiver->OnEvent(this, eventType, eventData);
 
                 if (self.Expired())
                 {
@@ -378,7 +394,10 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
                 if (!receiver || processed.Contains(receiver))
                     continue;
 
-                receiver->OnEvent(this, eventType, eventData);
+                if (typedData)
+                    receiver->OnTypedEvent(this, eventType, *typedData, eventData);
+                else
+                    receiver->OnEvent(this, eventType, eventData);
 
                 if (self.Expired())
                 {
@@ -509,6 +528,26 @@ EventHandler* Object::FindSpecificEventHandler(Object* sender, StringHash eventT
     return nullptr;
 }
 
+EventHandler* Object::FindInvokedHandler(Object* sender, StringHash eventType) const
+{
+    EventHandler* nonSpecific = nullptr;
+
+    EventHandler* handler = eventHandlers_.First();
+    while (handler)
+    {
+        if (handler->GetEventType() == eventType)
+        {
+            if (!handler->GetSender())
+                nonSpecific = handler;
+            else if (handler->GetSender() == sender)
+                return handler;
+        }
+        handler = eventHandlers_.Next(handler);
+    }
+
+    return nonSpecific;
+}
+
 void Object::RemoveEventSender(Object* sender)
 {
     EventHandler* handler = eventHandlers_.First();
@@ -33,6 +33,7 @@ namespace Urho3D
 
 class Context;
 class EventHandler;
+class TypedEventData;
 
 /// Type info.
 class URHO3D_API TypeInfo
@@ -139,6 +140,8 @@ public:
     {
         SendEvent(eventType, GetEventDataMap().Populate(args...));
     }
+    /// Send event with a typed payload to all subscribers. Typed handlers receive the payload directly; an event data map is filled from it only if a handler with the VariantMap signature, such as a script handler, is invoked. Values written to the map by handlers are not copied back.
+    void SendTypedEvent(StringHash eventType, TypedEventData& data);
 
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -185,6 +188,12 @@ private:
     EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous = nullptr) const;
     /// Remove event handlers related to a specific sender.
     void RemoveEventSender(Object* sender);
+    /// Return the handler to invoke for an event from the sender, or null if none. Specific handlers have priority.
+    EventHandler* FindInvokedHandler(Object* sender, StringHash eventType) const;
+    /// Send event to all subscribers, with an optional typed payload.
+    void DispatchEvent(StringHash eventType, VariantMap& eventData, TypedEventData* typedData);
+    /// Handle event with a typed payload.
+    void OnTypedEvent(Object* sender, StringHash eventType, TypedEventData& data, VariantMap& eventData);
 
     /// Event handlers. Sender is null for non-specific handlers.
     LinkedList<EventHandler> eventHandlers_;
@@ -267,6 +276,8 @@ public:
 
     /// Invoke event handler function.
     virtual void Invoke(VariantMap& eventData) = 0;
+    /// Invoke event handler function with a typed payload. By default fills the event data map from the payload on first use and invokes with it.
+    virtual void Invoke(TypedEventData& data, VariantMap& eventData);
     /// Return a unique copy of the event handler.
     virtual EventHandler* Clone() const = 0;
 
@@ -355,16 +366,89 @@ private:
     std::function<void(StringHash, VariantMap&)> function_;
 };
 
+/// Base class for statically typed event payloads, sent with Object::SendTypedEvent() without building an event data map.
+class URHO3D_API TypedEventData
+{
+public:
+    /// Destruct.
+    virtual ~TypedEventData() = default;
+
+    /// Write the payload to an event data map, for handlers with the VariantMap signature.
+    virtual void ToVariantMap(VariantMap& eventData) const = 0;
+    /// Read the payload from an event data map, for typed handlers of an event sent with a VariantMap.
+    virtual void FromVariantMap(const VariantMap& eventData) = 0;
+
+protected:
+    /// Return an event parameter, or empty if not found.
+    static const Variant& GetParam(const VariantMap& eventData, StringHash param)
+    {
+        const Variant* value = eventData[param];
+        return value ? *value : Variant::EMPTY;
+    }
+};
+
+/// Template implementation of the event handler invoke helper for a typed payload (stores a function pointer of specific class.) The payload type must be the one the event is sent with.
+template <class T, class D> class TypedEventHandlerImpl : public EventHandler
+{
+public:
+    using HandlerFunctionPtr = void (T::*)(StringHash, D&);
+
+    /// Construct with receiver and function pointers and userdata.
+    TypedEventHandlerImpl(T* receiver, HandlerFunctionPtr function, void* userData = nullptr) :
+        EventHandler(receiver, userData),
+        function_(function)
+    {
+        assert(receiver_);
+        assert(function_);
+    }
+
+    /// Invoke event handler function. The payload is read from the event data map.
+    void Invoke(VariantMap& eventData) override
+    {
+        D data;
+        data.FromVariantMap(eventData);
+        auto* receiver = static_cast<T*>(receiver_);
+        (receiver->*function_)(eventType_, data);
+    }
+
+    /// Invoke event handler function with a typed payload.
+    void Invoke(TypedEventData& data, VariantMap& /*eventData*/) override
+    {
+        // A handler subscribed with the wrong payload type for the event would otherwise read past the payload
+        assert(dynamic_cast<D*>(&data));
+        auto* receiver = static_cast<T*>(receiver_);
+        (receiver->*function_)(eventType_, static_cast<D&>(data));
+    }
+
+    /// Return a unique copy of the event handler.
+    EventHandler* Clone() const override
+    {
+        return new TypedEventHandlerImpl(static_cast<T*>(receiver_), function_, userData_);
+    }
+
+private:
+    /// Class-specific pointer to handler function.
+    HandlerFunctionPtr function_;
+};
+
+/// Construct a typed event handler, deducing the payload type from the handler function.
+template <class T, class D> EventHandler* MakeTypedEventHandler(T* receiver, void (T::*function)(StringHash, D&), void* userData = nullptr)
+{
+    return new TypedEventHandlerImpl<T, D>(receiver, function, userData);
+}
+
 /// Get register of event names.
 URHO3D_API StringHashRegister& GetEventNameRegister();
 
 /// Describe an event's hash ID and begin a namespace in which to define its parameters.
-#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(#eventName)); namespace eventName
+#define URHO3D_EVENT(eventID, eventName) static const Urho3D::StringHash eventID(Urho3D::GetEventNameRegister().RegisterString(URHO3D_STRINGHASH(#eventName), #eventName)); namespace eventName
 /// Describe an event's parameter hash ID. Should be used inside an event namespace.
-#define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID(#paramName)
+#define URHO3D_PARAM(paramID, paramName) static const Urho3D::StringHash paramID(URHO3D_STRINGHASH(#paramName))
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function.
 #define URHO3D_HANDLER(className, function) (new Urho3D::EventHandlerImpl<className>(this, &className::function))
 /// Convenience macro to construct an EventHandler that points to a receiver object and its member function, and also defines a userdata pointer.
 #define URHO3D_HANDLER_USERDATA(className, function, userData) (new Urho3D::EventHandlerImpl<className>(this, &className::function, userData))
+/// Convenience macro to construct an EventHandler that points to a receiver object and its member function taking a typed event payload.
+#define URHO3D_TYPED_HANDLER(className, function) (Urho3D::MakeTypedEventHandler<className>(this, &className::function))
 
 }
@@ -39,6 +39,9 @@
 extern "C" unsigned SDL_TVOS_GetActiveProcessorCount();
 #elif !defined(__linux__) && !defined(__EMSCRIPTEN__)
 #include <LibCpuId/libcpuid.h>
+#if defined(_MSC_VER) && defined(URHO3D_SSE)
+#include <immintrin.h>
+#endif
 #endif
 
 #if defined(_WIN32)
@@ -495,6 +498,75 @@ unsigned GetNumLogicalCPUs()
 #endif
 }
 
+#if defined(URHO3D_SSE) && !defined(__linux__) && !defined(__EMSCRIPTEN__) && !defined(IOS) && !defined(TVOS)
+/// Return the processor state components saved by the OS on context switches, from the XCR0 register. Requires OSXSAVE.
+static unsigned long long GetEnabledXStateFeatures()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((unsigned long long)edx << 32u) | eax;
+#endif
+}
+#endif
+
+/// Detect the SIMD instruction set level.
+static SIMDLevel DetectSIMDLevel()
+{
+#if !defined(URHO3D_SSE)
+    return SIMD_NONE;
+#elif defined(__linux__) && (defined(__i386__) || defined(__x86_64__))
+    // LibCpuId is not built on Linux, so use the compiler's CPU detection, which also checks that the OS saves the AVX registers
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("sse4.1"))
+        return SIMD_SSE2;
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+        return SIMD_SSE41;
+    if (!__builtin_cpu_supports("avx512f"))
+        return SIMD_AVX2;
+    return SIMD_AVX512;
+#elif defined(__linux__) || defined(__EMSCRIPTEN__) || defined(IOS) || defined(TVOS)
+    return SIMD_SSE2;
+#else
+    struct cpu_raw_data_t raw;
+    struct cpu_id_t data;
+    if (cpuid_get_raw_data(&raw) < 0 || cpu_identify(&raw, &data) < 0 || !data.flags[CPU_FEATURE_SSE4_1])
+        return SIMD_SSE2;
+
+    // AVX requires the OS to save the YMM registers, and AVX-512 additionally the opmask and ZMM registers
+    unsigned long long xState = data.flags[CPU_FEATURE_OSXSAVE] ? GetEnabledXStateFeatures() : 0;
+    if (!data.flags[CPU_FEATURE_AVX2] || !data.flags[CPU_FEATURE_FMA3] || (xState & 0x6u) != 0x6u)
+        return SIMD_SSE41;
+
+    // LibCpuId reports AVX-512 for Intel CPUs only, so check the feature bit of the raw CPUID leaf 7 instead
+    if (raw.basic_cpuid[0][0] < 7 || !(raw.basic_cpuid[7][1] & (1u << 16u)) || (xState & 0xe6u) != 0xe6u)
+        return SIMD_AVX2;
+    return SIMD_AVX512;
+#endif
+}
+
+SIMDLevel GetCPUSIMDLevel()
+{
+    static const SIMDLevel level = DetectSIMDLevel();
+    return level;
+}
+
+const char* GetSIMDLevelName(SIMDLevel level)
+{
+    static const char* names[] =
+    {
+        "None",
+        "SSE2",
+        "SSE4.1",
+        "AVX2",
+        "AVX-512"
+    };
+
+    return level >= SIMD_NONE && level <= SIMD_AVX512 ? names[level] : "(?)";
+}
+
 void SetMiniDumpDir(const String& pathName)
 {
     miniDumpDir = AddTrailingSlash(pathName);
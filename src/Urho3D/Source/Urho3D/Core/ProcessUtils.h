@@ -31,6 +31,21 @@ namespace Urho3D
 
 class Mutex;
 
+/// SIMD instruction set level. Each level includes the instruction sets of the lower levels.
+enum SIMDLevel
+{
+    /// No SIMD instructions, or a build without URHO3D_SSE.
+    SIMD_NONE = 0,
+    /// SSE and SSE2.
+    SIMD_SSE2,
+    /// SSE3, SSSE3 and SSE4.1.
+    SIMD_SSE41,
+    /// AVX, AVX2 and FMA3.
+    SIMD_AVX2,
+    /// AVX-512 Foundation.
+    SIMD_AVX512
+};
+
 /// Initialize the FPU to round-to-nearest, single precision mode.
 URHO3D_API void InitFPU();
 /// Display an error dialog with the specified title and message.
@@ -67,6 +82,10 @@ URHO3D_API String GetPlatform();
 URHO3D_API unsigned GetNumPhysicalCPUs();
 /// Return the number of logical CPUs (different from physical if hyperthreading is used.)
 URHO3D_API unsigned GetNumLogicalCPUs();
+/// Return the highest SIMD instruction set level supported by both the CPU and the OS, and usable by this build. Detected once on the first call.
+URHO3D_API SIMDLevel GetCPUSIMDLevel();
+/// Return the name of a SIMD instruction set level.
+URHO3D_API const char* GetSIMDLevelName(SIMDLevel level);
 /// Set minidump write location as an absolute path. If empty, uses default (UserProfile/AppData/Roaming/urho3D/crashdumps) Minidumps are only supported on MSVC compiler.
 URHO3D_API void SetMiniDumpDir(const String& pathName);
 /// Return minidump write location.
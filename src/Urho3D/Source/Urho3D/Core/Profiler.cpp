@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Core/Profiler.h"
+#include "../IO/Serializer.h"
 
 #include <cstdio>
 
@@ -31,17 +32,73 @@
 namespace Urho3D
 {
 
+/// Timestamped begin or end of a profiling block in a trace capture.
+struct ProfilerTraceEvent
+{
+    /// Block name, null for an end event.
+    const char* name_;
+    /// Microseconds since the capture began.
+    long long time_;
+};
+
+/// Trace events of one thread. Written only by its own thread, as a ring buffer keeping the latest events.
+struct ProfilerTraceBuffer
+{
+    /// Owning thread.
+    ThreadID threadID_;
+    /// Thread name shown in the trace.
+    String threadName_;
+    /// Event storage.
+    PODVector<ProfilerTraceEvent> events_;
+    /// Number of events written during the capture given by generation_.
+    std::atomic<unsigned> numWritten_{};
+    /// Capture the events belong to. Events of earlier captures are discarded by the owning thread on its next write.
+    std::atomic<unsigned> generation_{};
+};
+
+/// Number of profilers whose trace buffers each thread remembers.
+static const unsigned THREAD_TRACE_CACHE_SIZE = 4;
+
+/// Next unique profiler ID.
+static std::atomic<unsigned> nextProfilerID(1);
+/// Trace buffers of the calling thread.
+static thread_local ProfilerTraceBuffer* threadTraceBuffers[THREAD_TRACE_CACHE_SIZE] = {};
+/// IDs of the profilers owning the calling thread's trace buffers. Zero for an unused slot.
+static thread_local unsigned threadTraceProfilerIDs[THREAD_TRACE_CACHE_SIZE] = {};
+/// Slot to replace next when the calling thread records into a profiler it does not remember.
+static thread_local unsigned threadTraceNextSlot = 0;
+
+static void AppendJSONString(String& dest, const char* str)
+{
+    dest += '"';
+    for (; *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+            dest += '\\';
+        dest += *str;
+    }
+    dest += '"';
+}
+
 Profiler::Profiler(Context* context) :
     Object(context),
     current_(nullptr),
     root_(nullptr),
-    intervalFrames_(0)
+    intervalFrames_(0),
+    maxTraceEvents_(0),
+    profilerID_(nextProfilerID++),
+    captureGeneration_(0),
+    capturing_(false)
 {
     current_ = root_ = new ProfilerBlock(nullptr, "RunFrame");
 }
 
 Profiler::~Profiler()
 {
+    capturing_ = false;
+    for (PODVector<ProfilerTraceBuffer*>::Iterator i = traceBuffers_.Begin(); i != traceBuffers_.End(); ++i)
+        delete *i;
+
     delete root_;
     root_ = nullptr;
 }
@@ -53,6 +110,8 @@ void Profiler::BeginFrame()
         EndFrame();
 
     root_->Begin();
+    if (capturing_)
+        RecordTraceEvent(root_->name_);
 }
 
 void Profiler::EndFrame()
@@ -69,6 +128,137 @@ void Profiler::BeginInterval()
     intervalFrames_ = 0;
 }
 
+void Profiler::BeginCapture(unsigned maxEvents)
+{
+    MutexLock lock(traceMutex_);
+
+    // Other threads may still be writing, so their buffers are not touched here. Each thread rewinds its own buffer
+    // when it sees the new generation
+    maxTraceEvents_ = Max(maxEvents, 2U);
+    ++captureGeneration_;
+
+    captureTimer_.Reset();
+    capturing_ = true;
+}
+
+void Profiler::EndCapture()
+{
+    capturing_ = false;
+}
+
+bool Profiler::SaveCapture(Serializer& dest) const
+{
+    MutexLock lock(traceMutex_);
+
+    static const int EVENT_MAX_LENGTH = 128;
+    char event[EVENT_MAX_LENGTH];
+    PODVector<const ProfilerTraceEvent*> openBlocks;
+    String output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    for (unsigned i = 0; i < traceBuffers_.Size(); ++i)
+    {
+        const ProfilerTraceBuffer* buffer = traceBuffers_[i];
+        unsigned generation = buffer->generation_.load(std::memory_order_acquire);
+
+        if (i)
+            output += ",\n";
+        sprintf(event, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", i);
+        output += String(event);
+        AppendJSONString(output, buffer->threadName_.CString());
+        output += "}}";
+
+        // Pair begin and end events into complete events. Ends whose begin has been overwritten in the ring buffer,
+        // and blocks still open at the end of the capture, are left out
+        unsigned numWritten = generation == captureGeneration_ ? buffer->numWritten_.load(std::memory_order_acquire) : 0;
+        unsigned size = buffer->events_.Size();
+        openBlocks.Clear();
+
+        for (unsigned j = numWritten > size ? numWritten - size : 0; j < numWritten; ++j)
+        {
+            const ProfilerTraceEvent& traceEvent = buffer->events_[j % size];
+            if (traceEvent.name_)
+                openBlocks.Push(&traceEvent);
+            else if (openBlocks.Size())
+            {
+                const ProfilerTraceEvent* begin = openBlocks.Back();
+                openBlocks.Pop();
+
+                output += ",\n{\"name\":";
+                AppendJSONString(output, begin->name_);
+                sprintf(event, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%lld,\"dur\":%lld}", i, begin->time_,
+                    traceEvent.time_ - begin->time_);
+                output += String(event);
+            }
+        }
+
+        // Write out each thread separately to not hold all events in memory at once
+        if (dest.Write(output.CString(), output.Length()) != output.Length())
+            return false;
+        output.Clear();
+    }
+
+    output += "\n]}\n";
+    return dest.Write(output.CString(), output.Length()) == output.Length();
+}
+
+void Profiler::RecordTraceEvent(const char* name)
+{
+    ProfilerTraceBuffer* buffer = GetTraceBuffer();
+
+    // Rewind on the first event of a new capture
+    unsigned generation = captureGeneration_.load(std::memory_order_relaxed);
+    if (buffer->generation_.load(std::memory_order_relaxed) != generation)
+    {
+        buffer->numWritten_.store(0, std::memory_order_relaxed);
+        buffer->generation_.store(generation, std::memory_order_release);
+    }
+
+    unsigned index = buffer->numWritten_.load(std::memory_order_relaxed);
+    ProfilerTraceEvent& event = buffer->events_[index % buffer->events_.Size()];
+    event.name_ = name;
+    event.time_ = captureTimer_.GetUSec(false);
+    buffer->numWritten_.store(index + 1, std::memory_order_release);
+}
+
+ProfilerTraceBuffer* Profiler::GetTraceBuffer()
+{
+    for (unsigned i = 0; i < THREAD_TRACE_CACHE_SIZE; ++i)
+    {
+        if (threadTraceProfilerIDs[i] == profilerID_)
+            return threadTraceBuffers[i];
+    }
+
+    MutexLock lock(traceMutex_);
+
+    // The thread may have been evicted from the cache by other profilers, in which case its buffer already exists
+    ThreadID threadID = Thread::GetCurrentThreadID();
+    ProfilerTraceBuffer* buffer = nullptr;
+    for (PODVector<ProfilerTraceBuffer*>::Iterator i = traceBuffers_.Begin(); i != traceBuffers_.End(); ++i)
+    {
+        if ((*i)->threadID_ == threadID)
+        {
+            buffer = *i;
+            break;
+        }
+    }
+
+    if (!buffer)
+    {
+        buffer = new ProfilerTraceBuffer();
+        buffer->threadID_ = threadID;
+        buffer->threadName_ = Thread::IsMainThread() ? String("Main thread") : "Thread " + String(traceBuffers_.Size());
+        buffer->events_.Resize(maxTraceEvents_);
+        buffer->generation_ = captureGeneration_.load();
+        traceBuffers_.Push(buffer);
+    }
+
+    unsigned slot = threadTraceNextSlot;
+    threadTraceNextSlot = (slot + 1) % THREAD_TRACE_CACHE_SIZE;
+    threadTraceBuffers[slot] = buffer;
+    threadTraceProfilerIDs[slot] = profilerID_;
+    return buffer;
+}
+
 const String& Profiler::PrintData(bool showUnused, bool showTotal, unsigned maxDepth) const
 {
     static String output;
@@ -23,12 +23,18 @@
 #pragma once
 
 #include "../Container/Str.h"
+#include "../Core/Mutex.h"
 #include "../Core/Thread.h"
 #include "../Core/Timer.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
+class Serializer;
+struct ProfilerTraceBuffer;
+
 /// Profiling data for one block in the profiling tree.
 class URHO3D_API ProfilerBlock
 {
@@ -179,20 +185,29 @@ public:
     /// Destruct.
     ~Profiler() override;
 
-    /// Begin timing a profiling block.
+    /// Begin timing a profiling block. Other threads than the main thread are only recorded into a trace capture, so their block names must stay valid until it has been saved.
     void BeginBlock(const char* name)
     {
-        // Profiler supports only the main thread currently
+        // The block tree is kept for the main thread only
         if (!Thread::IsMainThread())
+        {
+            if (capturing_)
+                RecordTraceEvent(name);
             return;
+        }
 
         current_ = current_->GetChild(name);
         current_->Begin();
+        if (capturing_)
+            RecordTraceEvent(current_->name_);
     }
 
     /// End timing the current profiling block.
     void EndBlock()
     {
+        if (capturing_)
+            RecordTraceEvent(nullptr);
+
         if (!Thread::IsMainThread())
             return;
 
@@ -208,6 +223,15 @@ public:
     /// Begin a new interval.
     void BeginInterval();
 
+    /// Begin a trace capture of block begin and end events from all threads. Each thread keeps its latest maxEvents events; threads seen in an earlier capture keep their previous buffer size.
+    void BeginCapture(unsigned maxEvents = 65536);
+    /// End the trace capture. The captured events are kept until the next capture begins.
+    void EndCapture();
+    /// Write the captured events as Chrome trace JSON, viewable in chrome://tracing or Perfetto. Return true if successful. Should be called after ending the capture.
+    bool SaveCapture(Serializer& dest) const;
+    /// Return whether a trace capture is in progress.
+    bool IsCapturing() const { return capturing_; }
+
     /// Return profiling data as text output. This method is not thread-safe.
     const String& PrintData(bool showUnused = false, bool showTotal = false, unsigned maxDepth = M_MAX_UNSIGNED) const;
     /// Return the current profiling block.
@@ -218,6 +242,10 @@ public:
 protected:
     /// Return profiling data as text output for a specified profiling block.
     void PrintData(ProfilerBlock* block, String& output, unsigned depth, unsigned maxDepth, bool showUnused, bool showTotal) const;
+    /// Record a trace event for the calling thread. A null name ends the innermost block.
+    void RecordTraceEvent(const char* name);
+    /// Return the trace buffer of the calling thread, creating it on first use.
+    ProfilerTraceBuffer* GetTraceBuffer();
 
     /// Current profiling block.
     ProfilerBlock* current_;
@@ -225,6 +253,20 @@ protected:
     ProfilerBlock* root_;
     /// Frames in the current interval.
     unsigned intervalFrames_;
+    /// Trace buffers of all threads that have recorded events.
+    PODVector<ProfilerTraceBuffer*> traceBuffers_;
+    /// Mutex for registering trace buffers.
+    mutable Mutex traceMutex_;
+    /// Timer started when the capture began.
+    HiresTimer captureTimer_;
+    /// Event capacity of new trace buffers.
+    unsigned maxTraceEvents_;
+    /// Unique ID of this profiler, for recognizing the thread-local trace buffers.
+    unsigned profilerID_;
+    /// Incremented on each capture start, so that threads can discard their events of earlier captures.
+    std::atomic<unsigned> captureGeneration_;
+    /// Trace capture flag.
+    std::atomic<bool> capturing_;
 };
 
 /// Helper class for automatically beginning and ending a profiling block
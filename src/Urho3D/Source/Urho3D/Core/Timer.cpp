@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/Profiler.h"
 
@@ -136,6 +137,9 @@ void Time::EndFrame()
         SendEvent(E_ENDFRAME);
     }
 
+    // Release the per-frame scratch memory of all threads
+    FrameAllocator::AdvanceFrame();
+
     auto* profiler = GetSubsystem<Profiler>();
     if (profiler)
         profiler->EndFrame();
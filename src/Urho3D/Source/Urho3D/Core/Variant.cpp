@@ -83,6 +83,34 @@ Variant& Variant::operator =(const Variant& rhs)
         return *this;
     }
 
+    // Share variant and string containers. Add the reference first in case of self-assignment
+    switch (rhs.type_)
+    {
+    case VAR_VARIANTVECTOR:
+        rhs.value_.variantVector_->AddRef();
+        SetType(VAR_NONE);
+        value_.variantVector_ = rhs.value_.variantVector_;
+        type_ = VAR_VARIANTVECTOR;
+        return *this;
+
+    case VAR_STRINGVECTOR:
+        rhs.value_.stringVector_->AddRef();
+        SetType(VAR_NONE);
+        value_.stringVector_ = rhs.value_.stringVector_;
+        type_ = VAR_STRINGVECTOR;
+        return *this;
+
+    case VAR_VARIANTMAP:
+        rhs.value_.variantMap_->AddRef();
+        SetType(VAR_NONE);
+        value_.variantMap_ = rhs.value_.variantMap_;
+        type_ = VAR_VARIANTMAP;
+        return *this;
+
+    default:
+        break;
+    }
+
     // Assign other types here
     SetType(rhs.GetType());
 
@@ -104,18 +132,6 @@ Variant& Variant::operator =(const Variant& rhs)
         value_.resourceRefList_ = rhs.value_.resourceRefList_;
         break;
 
-    case VAR_VARIANTVECTOR:
-        value_.variantVector_ = rhs.value_.variantVector_;
-        break;
-
-    case VAR_STRINGVECTOR:
-        value_.stringVector_ = rhs.value_.stringVector_;
-        break;
-
-    case VAR_VARIANTMAP:
-        value_.variantMap_ = rhs.value_.variantMap_;
-        break;
-
     case VAR_PTR:
         value_.weakPtr_ = rhs.value_.weakPtr_;
         break;
@@ -133,10 +149,72 @@ Variant& Variant::operator =(const Variant& rhs)
         break;
 
     default:
-        memcpy(&value_, &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+        memcpy(static_cast<void*>(&value_), &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+        break;
+    }
+
+    return *this;
+}
+
+Variant& Variant::operator =(Variant&& rhs) noexcept
+{
+    if (&rhs == this)
+        return *this;
+
+    switch (rhs.type_)
+    {
+    case VAR_STRING:
+        SetType(VAR_STRING);
+        value_.string_ = std::move(rhs.value_.string_);
+        break;
+
+    case VAR_BUFFER:
+        SetType(VAR_BUFFER);
+        value_.buffer_.Swap(rhs.value_.buffer_);
+        break;
+
+    case VAR_RESOURCEREF:
+        SetType(VAR_RESOURCEREF);
+        value_.resourceRef_.type_ = rhs.value_.resourceRef_.type_;
+        value_.resourceRef_.name_ = std::move(rhs.value_.resourceRef_.name_);
+        break;
+
+    case VAR_RESOURCEREFLIST:
+        SetType(VAR_RESOURCEREFLIST);
+        value_.resourceRefList_.type_ = rhs.value_.resourceRefList_.type_;
+        value_.resourceRefList_.names_ = std::move(rhs.value_.resourceRefList_.names_);
+        break;
+
+    case VAR_PTR:
+        SetType(VAR_PTR);
+        value_.weakPtr_ = rhs.value_.weakPtr_;
+        break;
+
+    case VAR_VARIANTVECTOR:
+    case VAR_STRINGVECTOR:
+    case VAR_VARIANTMAP:
+    case VAR_MATRIX3:
+    case VAR_MATRIX3X4:
+    case VAR_MATRIX4:
+    case VAR_CUSTOM_HEAP:
+        // Heap-allocated values change owner without copying
+        SetType(VAR_NONE);
+        memcpy(static_cast<void*>(&value_), &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
+        type_ = rhs.type_;
+        rhs.type_ = VAR_NONE;
+        return *this;
+
+    case VAR_CUSTOM_STACK:
+        SetCustomVariantValue(*rhs.GetCustomVariantValuePtr());
+        break;
+
+    default:
+        SetType(rhs.type_);
+        memcpy(static_cast<void*>(&value_), &rhs.value_, sizeof(VariantValue));     // NOLINT(bugprone-undefined-memory-manipulation)
         break;
     }
 
+    rhs.SetType(VAR_NONE);
     return *this;
 }
 
@@ -198,13 +276,13 @@ bool Variant::operator ==(const Variant& rhs) const
         return value_.resourceRefList_ == rhs.value_.resourceRefList_;
 
     case VAR_VARIANTVECTOR:
-        return value_.variantVector_ == rhs.value_.variantVector_;
+        return value_.variantVector_ == rhs.value_.variantVector_ || value_.variantVector_->value_ == rhs.value_.variantVector_->value_;
 
     case VAR_STRINGVECTOR:
-        return value_.stringVector_ == rhs.value_.stringVector_;
+        return value_.stringVector_ == rhs.value_.stringVector_ || value_.stringVector_->value_ == rhs.value_.stringVector_->value_;
 
     case VAR_VARIANTMAP:
-        return value_.variantMap_ == rhs.value_.variantMap_;
+        return value_.variantMap_ == rhs.value_.variantMap_ || value_.variantMap_->value_ == rhs.value_.variantMap_->value_;
 
     case VAR_INTRECT:
         return value_.intRect_ == rhs.value_.intRect_;
@@ -576,13 +654,13 @@ bool Variant::IsZero() const
     }
 
     case VAR_VARIANTVECTOR:
-        return value_.variantVector_.Empty();
+        return value_.variantVector_->value_.Empty();
 
     case VAR_STRINGVECTOR:
-        return value_.stringVector_.Empty();
+        return value_.stringVector_->value_.Empty();
 
     case VAR_VARIANTMAP:
-        return value_.variantMap_.Empty();
+        return value_.variantMap_->value_.Empty();
 
     case VAR_INTRECT:
         return value_.intRect_ == IntRect::ZERO;
@@ -644,15 +722,15 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_VARIANTVECTOR:
-        value_.variantVector_.~VariantVector();
+        value_.variantVector_->ReleaseRef();
         break;
 
     case VAR_STRINGVECTOR:
-        value_.stringVector_.~StringVector();
+        value_.stringVector_->ReleaseRef();
         break;
 
     case VAR_VARIANTMAP:
-        value_.variantMap_.~VariantMap();
+        value_.variantMap_->ReleaseRef();
         break;
 
     case VAR_PTR:
@@ -704,15 +782,15 @@ void Variant::SetType(VariantType newType)
         break;
 
     case VAR_VARIANTVECTOR:
-        new(&value_.variantVector_) VariantVector();
+        value_.variantVector_ = new VariantSharedValue<VariantVector>();
         break;
 
     case VAR_STRINGVECTOR:
-        new(&value_.stringVector_) StringVector();
+        value_.stringVector_ = new VariantSharedValue<StringVector>();
         break;
 
     case VAR_VARIANTMAP:
-        new(&value_.variantMap_) VariantMap();
+        value_.variantMap_ = new VariantSharedValue<VariantMap>();
         break;
 
     case VAR_PTR:
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/Allocator.h"
 #include "../Container/HashMap.h"
 #include "../Container/Ptr.h"
 #include "../Math/Color.h"
@@ -30,6 +31,7 @@
 #include "../Math/Rect.h"
 #include "../Math/StringHash.h"
 
+#include <atomic>
 #include <typeinfo>
 
 namespace Urho3D
@@ -80,7 +82,7 @@ using VariantVector = Vector<Variant>;
 /// Vector of strings.
 using StringVector = Vector<String>;
 
-/// Map of variants.
+/// Map of variants. Kept on HashMap, as script bindings hand out references to values that must survive inserting other keys.
 using VariantMap = HashMap<StringHash, Variant>;
 
 /// Typed resource reference.
@@ -272,10 +274,37 @@ private:
 /// Make custom variant value.
 template <typename T> CustomVariantValueImpl<T> MakeCustomValue(const T& value) { return CustomVariantValueImpl<T>(value); }
 
+/// Reference-counted variant value, shared by variant copies until one of them is modified.
+template <class T> struct VariantSharedValue
+{
+    URHO3D_POOL_ALLOCATED
+
+    /// Construct empty.
+    VariantSharedValue() = default;
+    /// Construct by copying a value.
+    explicit VariantSharedValue(const T& value) : value_(value) { }
+
+    /// Add a reference.
+    void AddRef() { refs_.fetch_add(1, std::memory_order_relaxed); }
+    /// Release a reference. Delete when no references remain.
+    void ReleaseRef()
+    {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+    /// Return whether more than one variant references the value.
+    bool IsShared() const { return refs_.load(std::memory_order_acquire) > 1; }
+
+    /// Reference count.
+    std::atomic<int> refs_{1};
+    /// Value.
+    T value_;
+};
+
 /// Size of variant value. 16 bytes on 32-bit platform, 32 bytes on 64-bit platform.
 static const unsigned VARIANT_VALUE_SIZE = sizeof(void*) * 4;
 
-/// Union for the possible variant values. Objects exceeding the VARIANT_VALUE_SIZE are allocated on the heap.
+/// Union for the possible variant values. Objects exceeding the VARIANT_VALUE_SIZE are allocated on the heap. Variant and string containers are shared between variant copies.
 union VariantValue
 {
     unsigned char storage_[VARIANT_VALUE_SIZE];
@@ -299,9 +328,9 @@ union VariantValue
     Quaternion quaternion_;
     Color color_;
     String string_;
-    StringVector stringVector_;
-    VariantVector variantVector_;
-    VariantMap variantMap_;
+    VariantSharedValue<StringVector>* stringVector_;
+    VariantSharedValue<VariantVector>* variantVector_;
+    VariantSharedValue<VariantMap>* variantMap_;
     PODVector<unsigned char> buffer_;
     ResourceRef resourceRef_;
     ResourceRefList resourceRefList_;
@@ -409,6 +438,12 @@ public:
         *this = value;
     }
 
+    /// Construct by moving a string.
+    Variant(String&& value)             // NOLINT(google-explicit-constructor)
+    {
+        *this = std::move(value);
+    }
+
     /// Construct from a C string.
     Variant(const char* value)          // NOLINT(google-explicit-constructor)
     {
@@ -421,6 +456,12 @@ public:
         *this = value;
     }
 
+    /// Construct by moving a buffer.
+    Variant(PODVector<unsigned char>&& value)   // NOLINT(google-explicit-constructor)
+    {
+        *this = std::move(value);
+    }
+
     /// Construct from a %VectorBuffer and store as a buffer.
     Variant(const VectorBuffer& value)  // NOLINT(google-explicit-constructor)
     {
@@ -451,18 +492,36 @@ public:
         *this = value;
     }
 
+    /// Construct by moving a variant vector.
+    Variant(VariantVector&& value)      // NOLINT(google-explicit-constructor)
+    {
+        *this = std::move(value);
+    }
+
     /// Construct from a variant map.
     Variant(const VariantMap& value)    // NOLINT(google-explicit-constructor)
     {
         *this = value;
     }
 
+    /// Construct by moving a variant map.
+    Variant(VariantMap&& value)         // NOLINT(google-explicit-constructor)
+    {
+        *this = std::move(value);
+    }
+
     /// Construct from a string vector.
     Variant(const StringVector& value)  // NOLINT(google-explicit-constructor)
     {
         *this = value;
     }
 
+    /// Construct by moving a string vector.
+    Variant(StringVector&& value)       // NOLINT(google-explicit-constructor)
+    {
+        *this = std::move(value);
+    }
+
     /// Construct from a rect.
     Variant(const Rect& value)          // NOLINT(google-explicit-constructor)
     {
@@ -548,6 +607,12 @@ public:
         *this = value;
     }
 
+    /// Move-construct from another variant, which is left empty.
+    Variant(Variant&& value) noexcept
+    {
+        *this = std::move(value);
+    }
+
     /// Destruct.
     ~Variant()
     {
@@ -563,6 +628,9 @@ public:
     /// Assign from another variant.
     Variant& operator =(const Variant& rhs);
 
+    /// Move-assign from another variant, which is left empty.
+    Variant& operator =(Variant&& rhs) noexcept;
+
     /// Assign from an integer.
     Variant& operator =(int rhs)
     {
@@ -675,6 +743,14 @@ public:
         return *this;
     }
 
+    /// Assign by moving a string.
+    Variant& operator =(String&& rhs)
+    {
+        SetType(VAR_STRING);
+        value_.string_ = std::move(rhs);
+        return *this;
+    }
+
     /// Assign from a C string.
     Variant& operator =(const char* rhs)
     {
@@ -691,6 +767,14 @@ public:
         return *this;
     }
 
+    /// Assign by moving a buffer.
+    Variant& operator =(PODVector<unsigned char>&& rhs)
+    {
+        SetType(VAR_BUFFER);
+        value_.buffer_.Swap(rhs);
+        return *this;
+    }
+
     /// Assign from a %VectorBuffer and store as a buffer.
     Variant& operator =(const VectorBuffer& rhs);
 
@@ -722,7 +806,15 @@ public:
     Variant& operator =(const VariantVector& rhs)
     {
         SetType(VAR_VARIANTVECTOR);
-        value_.variantVector_ = rhs;
+        Detach(value_.variantVector_) = rhs;
+        return *this;
+    }
+
+    /// Assign by moving a variant vector.
+    Variant& operator =(VariantVector&& rhs)
+    {
+        SetType(VAR_VARIANTVECTOR);
+        Detach(value_.variantVector_) = std::move(rhs);
         return *this;
     }
 
@@ -730,7 +822,15 @@ public:
     Variant& operator =(const StringVector& rhs)
     {
         SetType(VAR_STRINGVECTOR);
-        value_.stringVector_ = rhs;
+        Detach(value_.stringVector_) = rhs;
+        return *this;
+    }
+
+    /// Assign by moving a string vector.
+    Variant& operator =(StringVector&& rhs)
+    {
+        SetType(VAR_STRINGVECTOR);
+        Detach(value_.stringVector_) = std::move(rhs);
         return *this;
     }
 
@@ -738,7 +838,15 @@ public:
     Variant& operator =(const VariantMap& rhs)
     {
         SetType(VAR_VARIANTMAP);
-        value_.variantMap_ = rhs;
+        Detach(value_.variantMap_) = rhs;
+        return *this;
+    }
+
+    /// Assign by moving a variant map.
+    Variant& operator =(VariantMap&& rhs)
+    {
+        SetType(VAR_VARIANTMAP);
+        Detach(value_.variantMap_) = std::move(rhs);
         return *this;
     }
 
@@ -905,19 +1013,19 @@ public:
     /// Test for equality with a variant vector. To return true, both the type and value must match.
     bool operator ==(const VariantVector& rhs) const
     {
-        return type_ == VAR_VARIANTVECTOR ? value_.variantVector_ == rhs : false;
+        return type_ == VAR_VARIANTVECTOR ? value_.variantVector_->value_ == rhs : false;
     }
 
     /// Test for equality with a string vector. To return true, both the type and value must match.
     bool operator ==(const StringVector& rhs) const
     {
-        return type_ == VAR_STRINGVECTOR ? value_.stringVector_ == rhs : false;
+        return type_ == VAR_STRINGVECTOR ? value_.stringVector_->value_ == rhs : false;
     }
 
     /// Test for equality with a variant map. To return true, both the type and value must match.
     bool operator ==(const VariantMap& rhs) const
     {
-        return type_ == VAR_VARIANTMAP ? value_.variantMap_ == rhs : false;
+        return type_ == VAR_VARIANTMAP ? value_.variantMap_->value_ == rhs : false;
     }
 
     /// Test for equality with a rect. To return true, both the type and value must match.
@@ -1229,19 +1337,19 @@ public:
     /// Return a variant vector or empty on type mismatch.
     const VariantVector& GetVariantVector() const
     {
-        return type_ == VAR_VARIANTVECTOR ? value_.variantVector_ : emptyVariantVector;
+        return type_ == VAR_VARIANTVECTOR ? value_.variantVector_->value_ : emptyVariantVector;
     }
 
     /// Return a string vector or empty on type mismatch.
     const StringVector& GetStringVector() const
     {
-        return type_ == VAR_STRINGVECTOR ? value_.stringVector_ : emptyStringVector;
+        return type_ == VAR_STRINGVECTOR ? value_.stringVector_->value_ : emptyStringVector;
     }
 
     /// Return a variant map or empty on type mismatch.
     const VariantMap& GetVariantMap() const
     {
-        return type_ == VAR_VARIANTMAP ? value_.variantMap_ : emptyVariantMap;
+        return type_ == VAR_VARIANTMAP ? value_.variantMap_->value_ : emptyVariantMap;
     }
 
     /// Return a rect or empty on type mismatch.
@@ -1348,14 +1456,14 @@ public:
         return type_ == VAR_BUFFER ? &value_.buffer_ : nullptr;
     }
 
-    /// Return a pointer to a modifiable variant vector or null on type mismatch.
-    VariantVector* GetVariantVectorPtr() { return type_ == VAR_VARIANTVECTOR ? &value_.variantVector_ : nullptr; }
+    /// Return a pointer to a modifiable variant vector or null on type mismatch. A vector shared with copies of the variant is copied first, so do not keep the pointer over copying the variant.
+    VariantVector* GetVariantVectorPtr() { return type_ == VAR_VARIANTVECTOR ? &Detach(value_.variantVector_) : nullptr; }
 
-    /// Return a pointer to a modifiable string vector or null on type mismatch.
-    StringVector* GetStringVectorPtr() { return type_ == VAR_STRINGVECTOR ? &value_.stringVector_ : nullptr; }
+    /// Return a pointer to a modifiable string vector or null on type mismatch. A vector shared with copies of the variant is copied first, so do not keep the pointer over copying the variant.
+    StringVector* GetStringVectorPtr() { return type_ == VAR_STRINGVECTOR ? &Detach(value_.stringVector_) : nullptr; }
 
-    /// Return a pointer to a modifiable variant map or null on type mismatch.
-    VariantMap* GetVariantMapPtr() { return type_ == VAR_VARIANTMAP ? &value_.variantMap_ : nullptr; }
+    /// Return a pointer to a modifiable variant map or null on type mismatch. A map shared with copies of the variant is copied first, so do not keep the pointer over copying the variant.
+    VariantMap* GetVariantMapPtr() { return type_ == VAR_VARIANTMAP ? &Detach(value_.variantMap_) : nullptr; }
 
     /// Return a pointer to a modifiable custom variant value or null on type mismatch.
     template <class T> T* GetCustomPtr()
@@ -1393,6 +1501,17 @@ public:
 private:
     /// Set new type and allocate/deallocate memory as necessary.
     void SetType(VariantType newType);
+    /// Return a shared value for modification. Copy it first if other variants reference it.
+    template <class T> static T& Detach(VariantSharedValue<T>*& value)
+    {
+        if (value->IsShared())
+        {
+            auto* copy = new VariantSharedValue<T>(value->value_);
+            value->ReleaseRef();
+            value = copy;
+        }
+        return value->value_;
+    }
 
     /// Variant type.
     VariantType type_ = VAR_NONE;
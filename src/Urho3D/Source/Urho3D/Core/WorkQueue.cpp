@@ -22,15 +22,140 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/Condition.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/Profiler.h"
+#include "../Core/Timer.h"
 #include "../Core/WorkQueue.h"
 #include "../IO/Log.h"
 
 namespace Urho3D
 {
 
+/// Number of priority lanes. Lane 0 holds frame-critical work (priority M_MAX_UNSIGNED), lane 1 other prioritized work and lane 2 priority 0 work.
+static const unsigned NUM_WORK_LANES = 3;
+/// Number of attempts to find work before an idle worker thread parks.
+static const unsigned WORKER_SPIN_COUNT = 64;
+/// Number of ParallelFor() chunks per thread, so that stealing can even out uneven chunks.
+static const unsigned CHUNKS_PER_THREAD = 4;
+/// Capacity of the work item pool. Items beyond it are allocated and deleted once completed.
+static const unsigned WORK_ITEM_POOL_SIZE = 1024;
+/// Mask of the free item index in the pool free list head.
+static const unsigned long long FREE_INDEX_MASK = 0xffffffffULL;
+
+/// Return the priority lane of a work item priority.
+static unsigned GetWorkLane(unsigned priority)
+{
+    if (priority == M_MAX_UNSIGNED)
+        return 0;
+    else
+        return priority ? 1 : 2;
+}
+
+/// Ring buffer of work item pointers.
+class WorkItemDeque
+{
+public:
+    /// Push an item to the back.
+    void PushBack(WorkItem* item)
+    {
+        if (size_ == buffer_.Size())
+            Grow();
+        buffer_[(head_ + size_) & (buffer_.Size() - 1)] = item;
+        ++size_;
+    }
+
+    /// Take the last item which has at least the specified priority. Return null if none.
+    WorkItem* TakeBack(unsigned priority)
+    {
+        for (unsigned i = size_; i-- > 0;)
+        {
+            if (At(i)->priority_ >= priority)
+                return EraseAt(i);
+        }
+
+        return nullptr;
+    }
+
+    /// Take the first item which has at least the specified priority. Return null if none.
+    WorkItem* TakeFront(unsigned priority)
+    {
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            if (At(i)->priority_ >= priority)
+                return EraseAt(i);
+        }
+
+        return nullptr;
+    }
+
+    /// Remove an item. Return true if it was found.
+    bool Remove(WorkItem* item)
+    {
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            if (At(i) == item)
+            {
+                EraseAt(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    /// Return item at logical index.
+    WorkItem*& At(unsigned index) { return buffer_[(head_ + index) & (buffer_.Size() - 1)]; }
+
+    /// Erase item at logical index and return it.
+    WorkItem* EraseAt(unsigned index)
+    {
+        WorkItem* item = At(index);
+        if (!index)
+            head_ = (head_ + 1) & (buffer_.Size() - 1);
+        else
+        {
+            for (unsigned i = index; i + 1 < size_; ++i)
+                At(i) = At(i + 1);
+        }
+        --size_;
+        return item;
+    }
+
+    /// Double the capacity, keeping it a power of two.
+    void Grow()
+    {
+        PODVector<WorkItem*> newBuffer(Max(buffer_.Size() * 2, 16U));
+        for (unsigned i = 0; i < size_; ++i)
+            newBuffer[i] = At(i);
+        buffer_.Swap(newBuffer);
+        head_ = 0;
+    }
+
+    /// Item storage.
+    PODVector<WorkItem*> buffer_;
+    /// Index of the first item.
+    unsigned head_{};
+    /// Number of items.
+    unsigned size_{};
+};
+
+/// Work deque owned by one thread. Other threads steal from it when they run out of work.
+class WorkerQueue : public RefCounted
+{
+public:
+    /// Deque mutex. Mostly uncontended, as threads only lock other deques when stealing.
+    Mutex mutex_;
+    /// Items per priority lane.
+    WorkItemDeque lanes_[NUM_WORK_LANES];
+    /// Number of items in all lanes, readable without locking.
+    std::atomic<int> size_{};
+    /// Wake up signal for the parked owner thread.
+    Condition wake_;
+};
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -62,25 +187,53 @@ private:
 
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    freeHead_(0),
+    numQueued_(0),
+    numParked_(0),
+    workerBusyTime_(0),
+    nextQueue_(0),
     shutDown_(false),
-    pausing_(false),
     paused_(false),
     completing_(false),
     tolerance_(10),
-    lastSize_(0),
     maxNonThreadedWorkMs_(5)
 {
+    // Allocate the item pool up front and link all items to the free list
+    poolItems_.Resize(WORK_ITEM_POOL_SIZE);
+    for (unsigned i = 0; i < WORK_ITEM_POOL_SIZE; ++i)
+    {
+        poolItems_[i] = new WorkItem();
+        poolItems_[i]->pooled_ = true;
+        poolItems_[i]->poolIndex_ = i;
+        poolItems_[i]->priority_ = M_MAX_UNSIGNED;
+        poolItems_[i]->nextFree_ = i + 2 <= WORK_ITEM_POOL_SIZE ? i + 2 : 0;
+    }
+    freeHead_ = 1;
+
+    // Main thread deque, used for all work when there are no worker threads
+    queues_.Push(SharedPtr<WorkerQueue>(new WorkerQueue()));
+
     SubscribeToEvent(E_BEGINFRAME, URHO3D_HANDLER(WorkQueue, HandleBeginFrame));
 }
 
 WorkQueue::~WorkQueue()
 {
-    // Stop the worker threads. First make sure they are not waiting for work items
+    // Stop the worker threads. First make sure they are not parked waiting for work items
     shutDown_ = true;
-    Resume();
+    WakeWorkers(threads_.Size());
 
     for (unsigned i = 0; i < threads_.Size(); ++i)
         threads_[i]->Stop();
+
+    // Release the references held for unfinished work
+    for (unsigned i = 0; i < workItems_.Size(); ++i)
+        workItems_[i]->ReleaseRef();
+    for (unsigned i = 0; i < finishedItems_.Size(); ++i)
+    {
+        WorkItem* item = finishedItems_[i];
+        for (unsigned j = item->numFinishedRefs_; j > 0; --j)
+            item->ReleaseRef();
+    }
 }
 
 void WorkQueue::CreateThreads(unsigned numThreads)
@@ -94,6 +247,9 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     // Start threads in paused mode
     Pause();
 
+    for (unsigned i = 0; i < numThreads; ++i)
+        queues_.Push(SharedPtr<WorkerQueue>(new WorkerQueue()));
+
     for (unsigned i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
@@ -107,19 +263,19 @@ void WorkQueue::CreateThreads(unsigned numThreads)
 
 SharedPtr<WorkItem> WorkQueue::GetFreeItem()
 {
-    if (poolItems_.Size() > 0)
-    {
-        SharedPtr<WorkItem> item = poolItems_.Front();
-        poolItems_.PopFront();
-        return item;
-    }
-    else
+    // Pop from the lock-free free list. The change counter in the head makes the exchange fail if the item was taken and
+    // returned by another thread in the meantime, in which case its next index might be stale
+    unsigned long long head = freeHead_.load();
+    while (head & FREE_INDEX_MASK)
     {
-        // No usable items found, create a new one set it as pooled and return it.
-        SharedPtr<WorkItem> item(new WorkItem());
-        item->pooled_ = true;
-        return item;
+        WorkItem* item = poolItems_[(unsigned)(head & FREE_INDEX_MASK) - 1];
+        unsigned long long newHead = ((head >> 32) + 1) << 32 | item->nextFree_.load(std::memory_order_relaxed);
+        if (freeHead_.compare_exchange_weak(head, newHead))
+            return SharedPtr<WorkItem>(item);
     }
+
+    // No usable items found, create a new one. It is deleted when no longer referenced
+    return SharedPtr<WorkItem>(new WorkItem());
 }
 
 void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
@@ -130,43 +286,73 @@ void WorkQueue::AddWorkItem(const SharedPtr<WorkItem>& item)
         return;
     }
 
-    // Check for duplicate items.
-    assert(!workItems_.Contains(item));
-
-    // Push to the main thread list to keep item alive
-    // Clear completed flag in case item is reused
-    workItems_.Push(item);
+    // Keep the item alive until executed. Clear completed flag in case item is reused
+    item->AddRef();
     item->completed_ = false;
 
-    // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
-        queueMutex_.Acquire();
+    if (Thread::IsMainThread())
+    {
+        // Check for duplicate items.
+        assert(!workItems_.Contains(item.Get()));
 
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(item);
+        // Push to the main thread list to track completion
+        workItems_.Push(item.Get());
+    }
     else
-    {
-        bool inserted = false;
+        item->detached_ = true;
 
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
-        {
-            if ((*i)->priority_ <= item->priority_)
-            {
-                queue_.Insert(i, item);
-                inserted = true;
-                break;
-            }
-        }
+    // Adding work resumes the worker threads
+    paused_ = false;
 
-        if (!inserted)
-            queue_.Push(item);
-    }
+    // Release the submission count. If dependencies are still unfinished, the last one to complete queues the item
+    if (--item->pendingDependencies_)
+        return;
 
+    // Distribute the items over the worker thread deques so that they start without stealing
+    unsigned threadIndex = 0;
     if (threads_.Size())
+        threadIndex = 1 + nextQueue_++ % threads_.Size();
+
+    QueueItem(item, threadIndex);
+}
+
+void WorkQueue::AddDependency(WorkItem* item, WorkItem* dependency)
+{
+    if (!item || !dependency || item == dependency)
     {
-        queueMutex_.Release();
-        paused_ = false;
+        URHO3D_LOGERROR("Invalid work item dependency");
+        return;
+    }
+
+    ++item->pendingDependencies_;
+    if (!AddDependent(dependency, item))
+    {
+        --item->pendingDependencies_;
+        return;
+    }
+
+    MutexLock lock(dependenciesMutex_);
+    item->dependencies_.Push(SharedPtr<WorkItem>(dependency));
+}
+
+void WorkQueue::AddRangeWorkItems(void* start, unsigned count, unsigned elementSize, void (*workFunction)(const WorkItem*, unsigned),
+    void* aux, unsigned priority, unsigned minChunkSize, WorkItem* continuation)
+{
+    unsigned numChunks = (GetNumThreads() + 1) * CHUNKS_PER_THREAD;
+    unsigned chunkSize = Max((count + numChunks - 1) / numChunks, Max(minChunkSize, 1U));
+    auto* data = static_cast<unsigned char*>(start);
+
+    for (unsigned offset = 0; offset < count; offset += chunkSize)
+    {
+        SharedPtr<WorkItem> item = GetFreeItem();
+        item->priority_ = priority;
+        item->workFunction_ = workFunction;
+        item->aux_ = aux;
+        item->start_ = data + offset * elementSize;
+        item->end_ = data + Min(offset + chunkSize, count) * elementSize;
+        if (continuation)
+            AddDependency(continuation, item);
+        AddWorkItem(item);
     }
 }
 
@@ -175,44 +361,54 @@ bool WorkQueue::RemoveWorkItem(SharedPtr<WorkItem> item)
     if (!item)
         return false;
 
-    MutexLock lock(queueMutex_);
-
     // Can only remove successfully if the item was not yet taken by threads for execution
-    List<WorkItem*>::Iterator i = queue_.Find(item.Get());
-    if (i != queue_.End())
+    PODVector<WorkItem*>::Iterator j = workItems_.Find(item.Get());
+    if (j == workItems_.End())
+        return false;
+
+    // An item still waiting for dependencies is in no deque. Once it no longer waits, its last dependency has queued it
+    bool removed = DetachFromDependencies(item);
+    if (!removed)
     {
-        List<SharedPtr<WorkItem> >::Iterator j = workItems_.Find(item);
-        if (j != workItems_.End())
+        unsigned lane = GetWorkLane(item->priority_);
+        for (unsigned i = 0; i < queues_.Size() && !removed; ++i)
         {
-            queue_.Erase(i);
-            ReturnToPool(item);
-            workItems_.Erase(j);
-            return true;
+            WorkerQueue* queue = queues_[i];
+            MutexLock lock(queue->mutex_);
+            if (queue->lanes_[lane].Remove(item.Get()))
+            {
+                --queue->size_;
+                --numQueued_;
+                removed = true;
+            }
         }
     }
 
-    return false;
+    if (!removed)
+        return false;
+
+    // Rearm the submission count in case the item is added again. Dependents no longer wait for the removed item
+    item->pendingDependencies_ = 1;
+    ReleaseDependents(item, 0);
+    item->finished_ = false;
+    ClearDependencies(item);
+    workItems_.Erase(j);
+    // The caller still references the item, so a pooled item is returned to the pool later
+    if (item->pooled_)
+        AddFinishedItem(item);
+    else
+        item->ReleaseRef();
+    return true;
 }
 
 unsigned WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items)
 {
-    MutexLock lock(queueMutex_);
     unsigned removed = 0;
 
     for (Vector<SharedPtr<WorkItem> >::ConstIterator i = items.Begin(); i != items.End(); ++i)
     {
-        List<WorkItem*>::Iterator j = queue_.Find(i->Get());
-        if (j != queue_.End())
-        {
-            List<SharedPtr<WorkItem> >::Iterator k = workItems_.Find(*i);
-            if (k != workItems_.End())
-            {
-                queue_.Erase(j);
-                ReturnToPool(*k);
-                workItems_.Erase(k);
-                ++removed;
-            }
-        }
+        if (RemoveWorkItem(*i))
+            ++removed;
     }
 
     return removed;
@@ -220,23 +416,16 @@ unsigned WorkQueue::RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items)
 
 void WorkQueue::Pause()
 {
-    if (!paused_)
-    {
-        pausing_ = true;
-
-        queueMutex_.Acquire();
-        paused_ = true;
-
-        pausing_ = false;
-    }
+    // Worker threads finish the item they are executing, then park
+    paused_ = true;
 }
 
 void WorkQueue::Resume()
 {
     if (paused_)
     {
-        queueMutex_.Release();
         paused_ = false;
+        WakeWorkers((unsigned)Max(numQueued_.load(), 0));
     }
 }
 
@@ -245,48 +434,14 @@ void WorkQueue::Complete(unsigned priority)
 {
     completing_ = true;
 
-    if (threads_.Size())
-    {
-        Resume();
-
-        // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.Empty())
-        {
-            queueMutex_.Acquire();
-            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
-                break;
-            }
-        }
-
-        // Wait for threaded work to complete
-        while (!IsCompleted(priority))
-        {
-        }
+    Resume();
 
-        // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.Empty())
-            Pause();
-    }
-    else
+    // Take work items also in the main thread until no high-priority items are left to take. Then wait for the items
+    // being executed by worker threads to complete
+    while (!IsCompleted(priority))
     {
-        // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-        {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        if (WorkItem* item = TakeItem(0, priority))
+            ExecuteItem(item, 0);
     }
 
     PurgeCompleted(priority);
@@ -295,7 +450,7 @@ void WorkQueue::Complete(unsigned priority)
 
 bool WorkQueue::IsCompleted(unsigned priority) const
 {
-    for (List<SharedPtr<WorkItem> >::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
+    for (PODVector<WorkItem*>::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
     {
         if ((*i)->priority_ >= priority && !(*i)->completed_)
             return false;
@@ -306,78 +461,268 @@ bool WorkQueue::IsCompleted(unsigned priority) const
 
 void WorkQueue::ProcessItems(unsigned threadIndex)
 {
-    bool wasActive = false;
+    unsigned idleCount = 0;
 
     for (;;)
     {
         if (shutDown_)
             return;
 
-        if (pausing_ && !wasActive)
-            Time::Sleep(0);
-        else
+        WorkItem* item = paused_ ? nullptr : TakeItem(threadIndex, 0);
+        if (item)
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
-            {
-                wasActive = true;
+            URHO3D_PROFILE(ExecuteWorkItem);
+            idleCount = 0;
+            HiresTimer busyTimer;
+            ExecuteItem(item, threadIndex);
+            workerBusyTime_.fetch_add((unsigned long long)busyTimer.GetUSec(false), std::memory_order_relaxed);
+        }
+        else if (paused_ || ++idleCount >= WORKER_SPIN_COUNT)
+        {
+            // Park instead of spinning so that idle workers do not use up CPU time
+            idleCount = 0;
+            ParkWorker(threadIndex);
+        }
+    }
+}
 
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
-            }
-            else
-            {
-                wasActive = false;
+void WorkQueue::QueueItem(WorkItem* item, unsigned threadIndex)
+{
+    WorkerQueue* queue = queues_[threadIndex];
+    {
+        MutexLock lock(queue->mutex_);
+        queue->lanes_[GetWorkLane(item->priority_)].PushBack(item);
+        ++queue->size_;
+    }
+
+    ++numQueued_;
+    if (!paused_)
+        WakeWorkers(1);
+}
+
+WorkItem* WorkQueue::TakeItem(unsigned threadIndex, unsigned priority)
+{
+    if (numQueued_ <= 0)
+        return nullptr;
+
+    // Only the lanes which may hold items with at least the requested priority are searched
+    unsigned numLanes = GetWorkLane(priority) + 1;
+    unsigned numQueues = queues_.Size();
 
-                queueMutex_.Release();
-                Time::Sleep(0);
+    for (unsigned lane = 0; lane < numLanes; ++lane)
+    {
+        // Own deque first, newest item first for cache locality. Then steal the oldest items from the other deques
+        for (unsigned i = 0; i < numQueues; ++i)
+        {
+            WorkerQueue* queue = queues_[(threadIndex + i) % numQueues];
+            if (queue->size_ <= 0)
+                continue;
+
+            MutexLock lock(queue->mutex_);
+            WorkItem* item = i ? queue->lanes_[lane].TakeFront(priority) : queue->lanes_[lane].TakeBack(priority);
+            if (item)
+            {
+                --queue->size_;
+                --numQueued_;
+                return item;
             }
         }
     }
+
+    return nullptr;
 }
 
-void WorkQueue::PurgeCompleted(unsigned priority)
+void WorkQueue::ExecuteItem(WorkItem* item, unsigned threadIndex)
 {
-    // Purge completed work items and send completion events. Do not signal items lower than priority threshold,
-    // as those may be user submitted and lead to eg. scene manipulation that could happen in the middle of the
-    // render update, which is not allowed
-    for (List<SharedPtr<WorkItem> >::Iterator i = workItems_.Begin(); i != workItems_.End();)
+    // Rearm the submission count in case the item is added again after completion
+    item->pendingDependencies_ = 1;
+    item->workFunction_(item, threadIndex);
+
+    ReleaseDependents(item, threadIndex);
+
+    // Detached items are not tracked for completion. The submitting thread may still hold a reference, so hand the queue's
+    // reference over to the main thread, which returns the item to the pool once no other reference remains
+    if (item->detached_)
+    {
+        item->detached_ = false;
+        item->completed_ = true;
+        AddFinishedItem(item);
+        return;
+    }
+
+    // The item may be returned to the pool as soon as it is seen completed, so publish all writes first
+    std::atomic_thread_fence(std::memory_order_release);
+    item->completed_ = true;
+}
+
+bool WorkQueue::AddDependent(WorkItem* item, WorkItem* dependent)
+{
+    while (item->dependentsLock_.exchange(true, std::memory_order_acquire))
     {
-        if ((*i)->completed_ && (*i)->priority_ >= priority)
+    }
+
+    bool finished = item->finished_;
+    if (!finished)
+        item->dependents_.Push(dependent);
+
+    item->dependentsLock_.store(false, std::memory_order_release);
+    return !finished;
+}
+
+void WorkQueue::ClearDependencies(WorkItem* item)
+{
+    MutexLock lock(dependenciesMutex_);
+    item->dependencies_.Clear();
+}
+
+bool WorkQueue::DetachFromDependencies(WorkItem* item)
+{
+    MutexLock lock(dependenciesMutex_);
+    if (item->dependencies_.Empty())
+        return false;
+
+    // Hold the locks of all dependencies at once so that none of them can finish and queue the item meanwhile. Other threads
+    // only ever hold one of these locks, so this can not deadlock
+    PODVector<WorkItem*> locked;
+    for (unsigned i = 0; i < item->dependencies_.Size(); ++i)
+    {
+        WorkItem* dependency = item->dependencies_[i];
+        if (locked.Contains(dependency))
+            continue;
+        while (dependency->dependentsLock_.exchange(true, std::memory_order_acquire))
         {
-            if ((*i)->sendEvent_)
-            {
-                using namespace WorkItemCompleted;
+        }
+        locked.Push(dependency);
+    }
 
-                VariantMap& eventData = GetEventDataMap();
-                eventData[P_ITEM] = i->Get();
-                SendEvent(E_WORKITEMCOMPLETED, eventData);
+    int numRemoved = 0;
+    for (unsigned i = 0; i < locked.Size(); ++i)
+    {
+        PODVector<WorkItem*>& dependents = locked[i]->dependents_;
+        for (unsigned j = dependents.Size(); j-- > 0;)
+        {
+            if (dependents[j] == item)
+            {
+                dependents.Erase(j);
+                ++numRemoved;
             }
+        }
+    }
 
-            ReturnToPool(*i);
-            i = workItems_.Erase(i);
+    // The unfinished dependencies hold the only counts left, as the submission count has already been released
+    item->pendingDependencies_ -= numRemoved;
+
+    for (unsigned i = 0; i < locked.Size(); ++i)
+        locked[i]->dependentsLock_.store(false, std::memory_order_release);
+
+    return numRemoved != 0;
+}
+
+void WorkQueue::ReleaseDependents(WorkItem* item, unsigned threadIndex)
+{
+    while (item->dependentsLock_.exchange(true, std::memory_order_acquire))
+    {
+    }
+
+    item->finished_ = true;
+
+    // Queue the dependents whose last dependency this was to this thread's deque, as they likely use the same data
+    for (PODVector<WorkItem*>::ConstIterator i = item->dependents_.Begin(); i != item->dependents_.End(); ++i)
+    {
+        if (!--(*i)->pendingDependencies_)
+            QueueItem(*i, threadIndex);
+    }
+    item->dependents_.Clear();
+
+    item->dependentsLock_.store(false, std::memory_order_release);
+}
+
+void WorkQueue::ParkWorker(unsigned threadIndex)
+{
+    {
+        MutexLock lock(parkMutex_);
+
+        // Count as parked before checking for work, so that a thread queuing work concurrently either sees the parked
+        // thread or the parked thread sees the queued work
+        ++numParked_;
+        if (shutDown_ || (!paused_ && numQueued_ > 0))
+        {
+            --numParked_;
+            return;
         }
-        else
-            ++i;
+
+        parkedThreads_.Push(threadIndex);
     }
+
+    queues_[threadIndex]->wake_.Wait();
 }
 
-void WorkQueue::PurgePool()
+void WorkQueue::WakeWorkers(unsigned count)
+{
+    if (!count || numParked_ <= 0)
+        return;
+
+    MutexLock lock(parkMutex_);
+
+    while (count-- && !parkedThreads_.Empty())
+    {
+        unsigned threadIndex = parkedThreads_.Back();
+        parkedThreads_.Pop();
+        --numParked_;
+        queues_[threadIndex]->wake_.Set();
+    }
+}
+
+void WorkQueue::PurgeCompleted(unsigned priority)
 {
-    unsigned currentSize = poolItems_.Size();
-    int difference = lastSize_ - currentSize;
+    // Purge completed work items and send completion events. Do not signal items lower than priority threshold,
+    // as those may be user submitted and lead to eg. scene manipulation that could happen in the middle of the
+    // render update, which is not allowed
+    // Compact the remaining items in place, keeping their order. Send the events only afterward, as the event handlers
+    // may add or remove work items
+    PODVector<WorkItem*> completedItems;
+    unsigned kept = 0;
+    for (unsigned i = 0; i < workItems_.Size(); ++i)
+    {
+        WorkItem* item = workItems_[i];
+        if (item->completed_ && item->priority_ >= priority)
+            completedItems.Push(item);
+        else
+            workItems_[kept++] = item;
+    }
+    workItems_.Resize(kept);
+
+    if (!completedItems.Empty())
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+    for (unsigned i = 0; i < completedItems.Size(); ++i)
+    {
+        WorkItem* item = completedItems[i];
+        if (item->sendEvent_)
+        {
+            using namespace WorkItemCompleted;
+
+            VariantMap& eventData = GetEventDataMap();
+            eventData[P_ITEM] = item;
+            SendEvent(E_WORKITEMCOMPLETED, eventData);
+        }
 
-    // Difference tolerance, should be fairly significant to reduce the pool size.
-    for (unsigned i = 0; poolItems_.Size() > 0 && difference > tolerance_ && i < (unsigned)difference; i++)
-        poolItems_.PopFront();
+        // A pooled item returns to the pool once the user no longer references it. Otherwise the item is deleted if the user
+        // holds no reference
+        if (item->pooled_)
+            AddFinishedItem(item);
+        else
+        {
+            item->finished_ = false;
+            ClearDependencies(item);
+            item->ReleaseRef();
+        }
+    }
 
-    lastSize_ = currentSize;
+    ReleaseFinishedItems();
 }
 
-void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
+void WorkQueue::ReturnToPool(WorkItem* item)
 {
     // Check if this was a pooled item and set it to usable
     if (item->pooled_)
@@ -393,32 +738,76 @@ void WorkQueue::ReturnToPool(SharedPtr<WorkItem>& item)
         item->priority_ = M_MAX_UNSIGNED;
         item->sendEvent_ = false;
         item->completed_ = false;
+        item->finished_ = false;
+        ClearDependencies(item);
 
-        poolItems_.Push(item);
+        // Push to the lock-free free list
+        unsigned long long head = freeHead_.load();
+        do
+        {
+            item->nextFree_.store((unsigned)(head & FREE_INDEX_MASK), std::memory_order_relaxed);
+        } while (!freeHead_.compare_exchange_weak(head, ((head >> 32) + 1) << 32 | (item->poolIndex_ + 1)));
     }
 }
 
+void WorkQueue::AddFinishedItem(WorkItem* item)
+{
+    MutexLock lock(finishedItemsMutex_);
+    // An item added again after finishing may be finished twice before it is released
+    if (!item->numFinishedRefs_++)
+        finishedItems_.Push(item);
+}
+
+void WorkQueue::ReleaseFinishedItems()
+{
+    MutexLock lock(finishedItemsMutex_);
+
+    // Release an item only when the work queue holds the last references to it, besides the pool's own reference. Once the
+    // user has let go of it, no other thread can touch its reference count and a pooled item can be reused safely. Items
+    // still referenced are checked again on the next purge
+    unsigned kept = 0;
+    for (unsigned i = 0; i < finishedItems_.Size(); ++i)
+    {
+        WorkItem* item = finishedItems_[i];
+        auto numQueueRefs = (int)item->numFinishedRefs_;
+        bool pooled = item->pooled_;
+        if (item->Refs() != numQueueRefs + (pooled ? 1 : 0))
+        {
+            finishedItems_[kept++] = item;
+            continue;
+        }
+
+        // A non-pooled item is deleted by the last release
+        item->numFinishedRefs_ = 0;
+        item->finished_ = false;
+        for (int j = 0; j < numQueueRefs; ++j)
+            item->ReleaseRef();
+        if (pooled)
+            ReturnToPool(item);
+    }
+    finishedItems_.Resize(kept);
+}
+
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.Empty() && !queue_.Empty())
+    if (threads_.Empty() && numQueued_ > 0)
     {
         URHO3D_PROFILE(CompleteWorkNonthreaded);
 
         HiresTimer timer;
 
-        while (!queue_.Empty() && timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
+        while (timer.GetUSec(false) < maxNonThreadedWorkMs_ * 1000LL)
         {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
+            WorkItem* item = TakeItem(0, 0);
+            if (!item)
+                break;
+            ExecuteItem(item, 0);
         }
     }
 
     // Complete and signal items down to the lowest priority
     PurgeCompleted(0);
-    PurgePool();
 }
 
 }
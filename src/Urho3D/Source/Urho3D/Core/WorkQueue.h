@@ -22,10 +22,13 @@
 
 #pragma once
 
-#include "../Container/List.h"
+#include "../Container/Allocator.h"
+#include "../Container/Vector.h"
 #include "../Core/Mutex.h"
 #include "../Core/Object.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -36,13 +39,27 @@ URHO3D_EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 }
 
 class WorkerThread;
+class WorkerQueue;
 
-/// Work queue item.
+/// Work queue item. Its reference count is atomic, as items are referenced from several threads. Always reference work items through WorkItem pointers, not RefCounted pointers, so that the atomic count is used.
 struct WorkItem : public RefCounted
 {
     friend class WorkQueue;
 
 public:
+    URHO3D_POOL_ALLOCATED
+
+    /// Increment reference count.
+    void AddRef() { atomicRefs_.fetch_add(1, std::memory_order_relaxed); }
+    /// Decrement reference count and delete self if no more references.
+    void ReleaseRef()
+    {
+        if (atomicRefs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+    /// Return reference count.
+    int Refs() const { return atomicRefs_.load(std::memory_order_acquire); }
+
     /// Work function. Called with the work item and thread index (0 = main thread) as parameters.
     void (* workFunction_)(const WorkItem*, unsigned){};
     /// Data start pointer.
@@ -59,10 +76,31 @@ public:
     volatile bool completed_{};
 
 private:
+    /// Whether the item belongs to the work queue's fixed item pool.
     bool pooled_{};
+    /// Whether the item was added from outside the main thread. Such items are not tracked for completion. Once executed, they are released by the main thread as soon as no other reference to them remains.
+    bool detached_{};
+    /// Index of the item in the pool.
+    unsigned poolIndex_{};
+    /// Index of the next item in the pool's free list, plus one. Zero ends the list.
+    std::atomic<unsigned> nextFree_{};
+    /// Number of unfinished dependencies, plus one until the item is added to the queue or while it executes. The item is queued for execution when this reaches zero.
+    std::atomic<int> pendingDependencies_{1};
+    /// Items waiting for this item to complete.
+    PODVector<WorkItem*> dependents_;
+    /// Items this item waits for, recorded so that a waiting item can be removed. Guarded by the work queue's dependencies mutex.
+    Vector<SharedPtr<WorkItem> > dependencies_;
+    /// Spin lock guarding the dependents and the finished flag.
+    std::atomic<bool> dependentsLock_{};
+    /// Whether the work function has run to completion and the dependents have been released.
+    bool finished_{};
+    /// Number of work queue references waiting in the finished item list for release by the main thread. Guarded by the finished items mutex.
+    unsigned numFinishedRefs_{};
+    /// Atomic reference count, used instead of the base class reference count.
+    std::atomic<int> atomicRefs_{};
 };
 
-/// Work queue subsystem for multithreading.
+/// Work queue subsystem for multithreading. Each thread owns a work deque with priority lanes; idle worker threads steal from the other deques and park when no work is queued.
 class URHO3D_API WorkQueue : public Object
 {
     URHO3D_OBJECT(WorkQueue, Object);
@@ -77,11 +115,23 @@ public:
 
     /// Create worker threads. Can only be called once.
     void CreateThreads(unsigned numThreads);
-    /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items.
+    /// Get pointer to an usable WorkItem from the item pool. Allocate one if no more free items. Can be called from any thread.
     SharedPtr<WorkItem> GetFreeItem();
-    /// Add a work item and resume worker threads.
+    /// Add a work item and resume worker threads. When called from outside the main thread, the item is detached: it is not waited for by Complete(), sends no completion event and returns to the pool once executed and no longer referenced by the submitter.
     void AddWorkItem(const SharedPtr<WorkItem>& item);
-    /// Remove a work item before it has started executing. Return true if successfully removed.
+    /// Make a work item wait for another work item to complete before it is executed. Must be called before the item is added to the queue, and while the dependency has not been returned to the pool. Has no effect if the dependency has already completed. The dependency should have at least the item's priority so that completing the item's priority also completes the dependency.
+    void AddDependency(WorkItem* item, WorkItem* dependency);
+    /// Split an array range into chunks sized for the worker threads and add a work item for each chunk, with start_ and end_ pointing to the chunk's first and one past last element. If a continuation item is given, it waits for all the chunks to complete.
+    template <class T> void ParallelFor(T* start, T* end, void (*workFunction)(const WorkItem*, unsigned), void* aux = nullptr,
+        unsigned priority = M_MAX_UNSIGNED, unsigned minChunkSize = 1, WorkItem* continuation = nullptr)
+    {
+        AddRangeWorkItems(const_cast<void*>(static_cast<const void*>(start)), (unsigned)(end - start), sizeof(T), workFunction, aux,
+            priority, minChunkSize, continuation);
+    }
+    /// Add work items for chunks of an array range with the specified element size. Called by ParallelFor().
+    void AddRangeWorkItems(void* start, unsigned count, unsigned elementSize, void (*workFunction)(const WorkItem*, unsigned), void* aux,
+        unsigned priority, unsigned minChunkSize, WorkItem* continuation);
+    /// Remove a work item before it has started executing, including while it waits for its dependencies. Its own dependents no longer wait for it. Return true if successfully removed.
     bool RemoveWorkItem(SharedPtr<WorkItem> item);
     /// Remove a number of work items before they have started executing. Return the number of items successfully removed.
     unsigned RemoveWorkItems(const Vector<SharedPtr<WorkItem> >& items);
@@ -92,7 +142,7 @@ public:
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
 
-    /// Set the pool telerance before it starts deleting pool items.
+    /// Set the pool tolerance. Has no effect, as the item pool has a fixed capacity and overflow items are deleted once completed.
     void SetTolerance(int tolerance) { tolerance_ = tolerance; }
 
     /// Set how many milliseconds maximum per frame to spend on low-priority work, when there are no worker threads.
@@ -101,6 +151,9 @@ public:
     /// Return number of worker threads.
     unsigned GetNumThreads() const { return threads_.Size(); }
 
+    /// Return total time in microseconds the worker threads have spent executing work items.
+    unsigned long long GetWorkerBusyTime() const { return workerBusyTime_; }
+
     /// Return whether all work with at least the specified priority is finished.
     bool IsCompleted(unsigned priority) const;
     /// Return whether the queue is currently completing work in the main thread.
@@ -115,37 +168,71 @@ public:
 private:
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Queue a work item to a thread's deque and wake a parked worker thread.
+    void QueueItem(WorkItem* item, unsigned threadIndex);
+    /// Take a work item which has at least the specified priority, from the thread's own deque first and then by stealing from the other deques. Return null if none.
+    WorkItem* TakeItem(unsigned threadIndex, unsigned priority);
+    /// Execute a work item and mark it completed.
+    void ExecuteItem(WorkItem* item, unsigned threadIndex);
+    /// Add a dependent to a work item. Return false without adding if the work item has already finished.
+    bool AddDependent(WorkItem* item, WorkItem* dependent);
+    /// Release the recorded dependencies of a work item.
+    void ClearDependencies(WorkItem* item);
+    /// Detach a work item waiting for its dependencies from them, so that it will not be queued. Return false if the item no longer waits for any dependency.
+    bool DetachFromDependencies(WorkItem* item);
+    /// Mark a work item finished and queue its dependents whose last dependency it was.
+    void ReleaseDependents(WorkItem* item, unsigned threadIndex);
+    /// Park a worker thread until new work is queued. Return immediately if work was queued meanwhile.
+    void ParkWorker(unsigned threadIndex);
+    /// Wake up to the specified number of parked worker threads.
+    void WakeWorkers(unsigned count);
     /// Purge completed work items which have at least the specified priority, and send completion events as necessary.
     void PurgeCompleted(unsigned priority);
-    /// Purge the pool to reduce allocation where its unneeded.
-    void PurgePool();
-    /// Return a work item to the pool.
-    void ReturnToPool(SharedPtr<WorkItem>& item);
+    /// Return a work item to the pool if it is pooled.
+    void ReturnToPool(WorkItem* item);
+    /// Hand the work queue's reference to an executed or removed item over to the main thread for release. Can be called from any thread.
+    void AddFinishedItem(WorkItem* item);
+    /// Release the finished items which are no longer referenced outside the work queue, returning pooled items to the pool. Called from the main thread.
+    void ReleaseFinishedItems();
     /// Handle frame start event. Purge completed work from the main thread queue, and perform work if no threads at all.
     void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
 
     /// Worker threads.
     Vector<SharedPtr<WorkerThread> > threads_;
-    /// Work item pool for reuse to cut down on allocation. The bool is a flag for item pooling and whether it is available or not.
-    List<SharedPtr<WorkItem> > poolItems_;
-    /// Work item collection. Accessed only by the main thread.
-    List<SharedPtr<WorkItem> > workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems.)
-    List<WorkItem*> queue_;
-    /// Worker queue mutex.
-    Mutex queueMutex_;
+    /// Fixed capacity work item pool, allocated once. Holds a reference to each item so that they are never deleted while in use.
+    Vector<SharedPtr<WorkItem> > poolItems_;
+    /// Head of the lock-free pool free list: index of the first free item plus one in the low 32 bits, and a change counter in the high 32 bits to detect concurrent reuse.
+    std::atomic<unsigned long long> freeHead_;
+    /// Work item collection, each holding a reference. Accessed only by the main thread.
+    PODVector<WorkItem*> workItems_;
+    /// Executed detached items and finished pooled items, each holding a reference. The main thread releases them once nothing else references the item, so that a pooled item is never reused while still referenced.
+    PODVector<WorkItem*> finishedItems_;
+    /// Finished items mutex.
+    Mutex finishedItemsMutex_;
+    /// Mutex guarding the recorded dependencies of the work items, as dependencies may be added from any thread.
+    Mutex dependenciesMutex_;
+    /// Per-thread work deques, index 0 belongs to the main thread. Item pointers are guaranteed to be valid (point to workItems.)
+    Vector<SharedPtr<WorkerQueue> > queues_;
+    /// Indices of the parked worker threads.
+    PODVector<unsigned> parkedThreads_;
+    /// Parking mutex.
+    Mutex parkMutex_;
+    /// Number of queued work items not yet taken for execution.
+    std::atomic<int> numQueued_;
+    /// Number of parked worker threads.
+    std::atomic<int> numParked_;
+    /// Total time in microseconds the worker threads have spent executing work items.
+    std::atomic<unsigned long long> workerBusyTime_;
+    /// Next worker thread deque to queue to.
+    std::atomic<unsigned> nextQueue_;
     /// Shutting down flag.
-    volatile bool shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-    volatile bool pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    std::atomic<bool> shutDown_;
+    /// Paused flag. Indicates the worker threads should park instead of taking work items.
+    std::atomic<bool> paused_;
     /// Completing work in the main thread flag.
     bool completing_;
-    /// Tolerance for the shared pool before it begins to deallocate.
+    /// Pool tolerance. Unused.
     int tolerance_;
-    /// Last size of the shared pool.
-    unsigned lastSize_;
     /// Maximum milliseconds per frame to spend on low-priority work, when there are no worker threads.
     int maxNonThreadedWorkMs_;
 };
@@ -26,6 +26,7 @@
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/EventProfiler.h"
+#include "../Core/Metrics.h"
 #include "../Core/ProcessUtils.h"
 #include "../Core/WorkQueue.h"
 #include "../Engine/Console.h"
@@ -35,9 +36,11 @@
 #include "../Graphics/Graphics.h"
 #include "../Graphics/Renderer.h"
 #include "../Input/Input.h"
+#include "../IO/File.h"
 #include "../IO/FileSystem.h"
 #include "../IO/Log.h"
 #include "../IO/PackageFile.h"
+#include "../Math/BatchMath.h"
 #ifdef URHO3D_IK
 #include "../IK/IK.h"
 #endif
@@ -124,6 +127,7 @@ Engine::Engine(Context* context) :
 #ifdef URHO3D_PROFILING
     context_->RegisterSubsystem(new Profiler(context_));
 #endif
+    context_->RegisterSubsystem(new Metrics(context_));
     context_->RegisterSubsystem(new FileSystem(context_));
 #ifdef URHO3D_LOGGING
     context_->RegisterSubsystem(new Log(context_));
@@ -194,6 +198,7 @@ bool Engine::Initialize(const VariantMap& parameters)
         if (HasParameter(parameters, EP_LOG_LEVEL))
             log->SetLevel(GetParameter(parameters, EP_LOG_LEVEL).GetInt());
         log->SetQuiet(GetParameter(parameters, EP_LOG_QUIET, false).GetBool());
+        log->SetAsync(GetParameter(parameters, EP_LOG_ASYNC, false).GetBool());
         log->Open(GetParameter(parameters, EP_LOG_NAME, "Urho3D.log").GetString());
     }
 
@@ -216,6 +221,9 @@ bool Engine::Initialize(const VariantMap& parameters)
     }
 #endif
 
+    URHO3D_LOGINFOF("CPU SIMD level %s, using %s batch math kernels", GetSIMDLevelName(GetCPUSIMDLevel()),
+        GetSIMDLevelName(GetBatchMathSIMDLevel()));
+
     // Add resource paths
     if (!InitializeResourceCache(parameters, false))
         return false;
@@ -310,6 +318,11 @@ bool Engine::Initialize(const VariantMap& parameters)
         context_->RegisterSubsystem(new EventProfiler(context_));
         EventProfiler::SetActive(true);
     }
+
+    // Capture a trace of all threads until exit if requested
+    profilerCaptureFileName_ = GetParameter(parameters, EP_PROFILER_CAPTURE, String::EMPTY).GetString();
+    if (!profilerCaptureFileName_.Empty())
+        GetSubsystem<Profiler>()->BeginCapture();
 #endif
     frameTimer_.Reset();
 
@@ -519,6 +532,7 @@ void Engine::RunFrame()
 
     Render();
     ApplyFrameLimit();
+    UpdateMetrics();
 
     time->EndFrame();
 }
@@ -615,6 +629,34 @@ void Engine::DumpProfiler()
 #endif
 }
 
+bool Engine::SaveProfilerCapture(const String& fileName)
+{
+#ifdef URHO3D_PROFILING
+    if (!Thread::IsMainThread())
+        return false;
+
+    auto* profiler = GetSubsystem<Profiler>();
+    if (!profiler)
+        return false;
+
+    profiler->EndCapture();
+
+    File file(context_);
+    if (!file.Open(fileName, FILE_WRITE))
+        return false;
+    if (!profiler->SaveCapture(file))
+    {
+        URHO3D_LOGERROR("Failed to save profiler capture to " + fileName);
+        return false;
+    }
+
+    URHO3D_LOGINFO("Saved profiler capture to " + fileName);
+    return true;
+#else
+    return false;
+#endif
+}
+
 void Engine::DumpResources(bool dumpFileName)
 {
 #ifdef URHO3D_LOGGING
@@ -686,20 +728,17 @@ void Engine::Update()
     URHO3D_PROFILE(Update);
 
     // Logic update event
-    using namespace Update;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_TIMESTEP] = timeStep_;
-    SendEvent(E_UPDATE, eventData);
+    UpdateEventData eventData(timeStep_);
+    SendTypedEvent(E_UPDATE, eventData);
 
     // Logic post-update event
-    SendEvent(E_POSTUPDATE, eventData);
+    SendTypedEvent(E_POSTUPDATE, eventData);
 
     // Rendering update event
-    SendEvent(E_RENDERUPDATE, eventData);
+    SendTypedEvent(E_RENDERUPDATE, eventData);
 
     // Post-render update event
-    SendEvent(E_POSTRENDERUPDATE, eventData);
+    SendTypedEvent(E_POSTRENDERUPDATE, eventData);
 }
 
 void Engine::Render()
@@ -794,6 +833,27 @@ void Engine::ApplyFrameLimit()
         timeStep_ = lastTimeSteps_.Back();
 }
 
+void Engine::UpdateMetrics()
+{
+    auto* metrics = GetSubsystem<Metrics>();
+    if (!metrics)
+        return;
+
+    auto* graphics = GetSubsystem<Graphics>();
+    auto* renderer = GetSubsystem<Renderer>();
+    if (graphics)
+        metrics->Add(METRIC_DRAW_CALLS, graphics->GetNumBatches());
+    if (renderer)
+    {
+        metrics->Add(METRIC_BATCHES, renderer->GetNumBatches());
+        metrics->Add(METRIC_PRIMITIVES, renderer->GetNumPrimitives());
+    }
+
+    auto* cache = GetSubsystem<ResourceCache>();
+    if (cache)
+        metrics->Set(METRIC_RESOURCE_MEMORY, (double)cache->GetTotalMemoryUse());
+}
+
 VariantMap Engine::ParseParameters(const Vector<String>& arguments)
 {
     VariantMap ret;
@@ -946,6 +1006,11 @@ VariantMap Engine::ParseParameters(const Vector<String>& arguments)
             }
             else if (argument == "touch")
                 ret[EP_TOUCH_EMULATION] = true;
+            else if (argument == "trace" && !value.Empty())
+            {
+                ret[EP_PROFILER_CAPTURE] = value;
+                ++i;
+            }
 #ifdef URHO3D_TESTING
             else if (argument == "timeout" && !value.Empty())
             {
@@ -984,6 +1049,12 @@ void Engine::HandleExitRequested(StringHash eventType, VariantMap& eventData)
 
 void Engine::DoExit()
 {
+    if (!profilerCaptureFileName_.Empty())
+    {
+        SaveProfilerCapture(profilerCaptureFileName_);
+        profilerCaptureFileName_.Clear();
+    }
+
     auto* graphics = GetSubsystem<Graphics>();
     if (graphics)
         graphics->Close();
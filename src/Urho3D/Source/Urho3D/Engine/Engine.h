@@ -70,6 +70,8 @@ public:
     void Exit();
     /// Dump profiling information to the log.
     void DumpProfiler();
+    /// End the profiler's trace capture and save it to a file as Chrome trace JSON. Return true if successful.
+    bool SaveProfilerCapture(const String& fileName);
     /// Dump information of all resources to the log.
     void DumpResources(bool dumpFileName = false);
     /// Dump information of all memory allocations to the log. Supported in MSVC debug mode only.
@@ -111,6 +113,8 @@ public:
     void Render();
     /// Get the timestep for the next frame and sleep for frame limiting if necessary.
     void ApplyFrameLimit();
+    /// Feed the built-in rendering and resource metrics for the frame.
+    void UpdateMetrics();
 
     /// Parse the engine startup parameters map from command line arguments.
     static VariantMap ParseParameters(const Vector<String>& arguments);
@@ -146,6 +150,8 @@ private:
     /// Time out counter for testing.
     long long timeOut_;
 #endif
+    /// File to save the profiler's trace capture to on exit, if a capture was started by the startup parameters.
+    String profilerCaptureFileName_;
     /// Auto-exit flag.
     bool autoExit_;
     /// Initialized flag.
@@ -37,6 +37,7 @@ static const String EP_FRAME_LIMITER = "FrameLimiter";
 static const String EP_FULL_SCREEN = "FullScreen";
 static const String EP_HEADLESS = "Headless";
 static const String EP_HIGH_DPI = "HighDPI";
+static const String EP_LOG_ASYNC = "LogAsync";
 static const String EP_LOG_LEVEL = "LogLevel";
 static const String EP_LOG_NAME = "LogName";
 static const String EP_LOG_QUIET = "LogQuiet";
@@ -46,6 +47,7 @@ static const String EP_MONITOR = "Monitor";
 static const String EP_MULTI_SAMPLE = "MultiSample";
 static const String EP_ORIENTATIONS = "Orientations";
 static const String EP_PACKAGE_CACHE_DIR = "PackageCacheDir";
+static const String EP_PROFILER_CAPTURE = "ProfilerCapture";
 static const String EP_RENDER_PATH = "RenderPath";
 static const String EP_REFRESH_RATE = "RefreshRate";
 static const String EP_RESOURCE_PACKAGES = "ResourcePackages";
@@ -79,7 +79,7 @@ void AnimationController::OnSetEnabled()
     if (scene)
     {
         if (IsEnabledEffective())
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimationController, HandleScenePostUpdate));
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_TYPED_HANDLER(AnimationController, HandleScenePostUpdate));
         else
             UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
     }
@@ -839,7 +839,7 @@ VariantVector AnimationController::GetNodeAnimationStatesAttr() const
 void AnimationController::OnSceneSet(Scene* scene)
 {
     if (scene && IsEnabledEffective())
-        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimationController, HandleScenePostUpdate));
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_TYPED_HANDLER(AnimationController, HandleScenePostUpdate));
     else if (!scene)
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
 }
@@ -908,11 +908,9 @@ void AnimationController::FindAnimation(const String& name, unsigned& index, Ani
     }
 }
 
-void AnimationController::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+void AnimationController::HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData)
 {
-    using namespace ScenePostUpdate;
-
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(eventData.timeStep_);
 }
 
 }
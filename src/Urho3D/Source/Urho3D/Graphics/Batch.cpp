@@ -22,6 +22,8 @@
 
 #include "../Precompiled.h"
 
+#include "../Container/FrameAllocator.h"
+#include "../Container/Sort.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/Geometry.h"
 #include "../Graphics/Graphics.h"
@@ -40,6 +42,9 @@
 namespace Urho3D
 {
 
+/// Minimum number of batches to sort with radix sort instead of comparison sort.
+static const unsigned RADIX_SORT_THRESHOLD = 256;
+
 inline bool CompareBatchesState(Batch* lhs, Batch* rhs)
 {
     if (lhs->renderOrder_ != rhs->renderOrder_)
@@ -80,6 +85,93 @@ inline bool CompareBatchGroupOrder(BatchGroup* lhs, BatchGroup* rhs)
     return lhs->renderOrder_ < rhs->renderOrder_;
 }
 
+/// Return a radix sort key for a float that sorts in the same order as the float.
+inline unsigned long long GetFloatSortKey(float value)
+{
+    unsigned bits;
+    memcpy(&bits, &value, sizeof bits);
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/// Batch with a radix sort key.
+struct BatchSortItem
+{
+    /// Sort key.
+    unsigned long long key_;
+    /// Batch.
+    Batch* batch_;
+};
+
+/// Sort batches by a key with a stable radix sort. The key is read once per batch into the item buffer, so that the radix sort passes do not touch the batches.
+template <class T> void RadixSortBatches(PODVector<Batch*>& batches, FramePODVector<BatchSortItem>& items, FramePODVector<BatchSortItem>& temp, T getKey)
+{
+    for (unsigned i = 0; i < batches.Size(); ++i)
+    {
+        items[i].key_ = getKey(batches[i]);
+        items[i].batch_ = batches[i];
+    }
+
+    RadixSort(items.Begin(), items.End(), temp.Begin(), [](const BatchSortItem& item) { return item.key_; });
+
+    for (unsigned i = 0; i < batches.Size(); ++i)
+        batches[i] = items[i].batch_;
+}
+
+/// Sort batches in the order of CompareBatchesState. Large queues are sorted with stable radix sorts from the least significant key.
+inline void SortBatchesState(PODVector<Batch*>& batches)
+{
+    if (batches.Size() < RADIX_SORT_THRESHOLD)
+    {
+        Sort(batches.Begin(), batches.End(), CompareBatchesState);
+        return;
+    }
+
+    FramePODVector<BatchSortItem> items;
+    FramePODVector<BatchSortItem> temp;
+    items.Resize(batches.Size());
+    temp.Resize(batches.Size());
+    RadixSortBatches(batches, items, temp, [](Batch* batch) { return GetFloatSortKey(batch->distance_); });
+    RadixSortBatches(batches, items, temp, [](Batch* batch) { return batch->sortKey_; });
+    RadixSortBatches(batches, items, temp, [](Batch* batch) { return (unsigned long long)batch->renderOrder_; });
+}
+
+/// Sort batches in the order of CompareBatchesFrontToBack. Large queues are sorted with stable radix sorts from the least significant key.
+inline void SortBatchesFrontToBack(PODVector<Batch*>& batches)
+{
+    if (batches.Size() < RADIX_SORT_THRESHOLD)
+    {
+        Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+        return;
+    }
+
+    FramePODVector<BatchSortItem> items;
+    FramePODVector<BatchSortItem> temp;
+    items.Resize(batches.Size());
+    temp.Resize(batches.Size());
+    RadixSortBatches(batches, items, temp, [](Batch* batch) { return batch->sortKey_; });
+    RadixSortBatches(batches, items, temp, [](Batch* batch)
+        { return ((unsigned long long)batch->renderOrder_ << 32u) | GetFloatSortKey(batch->distance_); });
+}
+
+/// Sort batches in the order of CompareBatchesBackToFront. Large queues are sorted with stable radix sorts from the least significant key.
+inline void SortBatchesBackToFront(PODVector<Batch*>& batches)
+{
+    if (batches.Size() < RADIX_SORT_THRESHOLD)
+    {
+        Sort(batches.Begin(), batches.End(), CompareBatchesBackToFront);
+        return;
+    }
+
+    FramePODVector<BatchSortItem> items;
+    FramePODVector<BatchSortItem> temp;
+    items.Resize(batches.Size());
+    temp.Resize(batches.Size());
+    RadixSortBatches(batches, items, temp, [](Batch* batch) { return batch->sortKey_; });
+    // Invert the distance key for descending order
+    RadixSortBatches(batches, items, temp, [](Batch* batch)
+        { return ((unsigned long long)batch->renderOrder_ << 32u) | (~GetFloatSortKey(batch->distance_) & 0xffffffffu); });
+}
+
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer)
 {
     Camera* shadowCamera = queue->shadowSplits_[split].shadowCamera_;
@@ -535,7 +627,7 @@ void Batch::Prepare(View* view, Camera* camera, bool setModelTransform, bool all
                  graphics->NeedParameterUpdate(SP_LIGHT, lightQueue_))
         {
             Vector4 vertexLights[MAX_VERTEX_LIGHTS * 3];
-            const PODVector<Light*>& lights = lightQueue_->vertexLights_;
+            const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& lights = lightQueue_->vertexLights_;
 
             for (unsigned i = 0; i < lights.Size(); ++i)
             {
@@ -732,7 +824,7 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.Size(); ++i)
         sortedBatches_[i] = &batches_[i];
 
-    Sort(sortedBatches_.Begin(), sortedBatches_.End(), CompareBatchesBackToFront);
+    SortBatchesBackToFront(sortedBatches_);
 
     sortedBatchGroups_.Resize(batchGroups_.Size());
 
@@ -784,10 +876,10 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
     // method is also time consuming, so just sort with state having priority
 #ifdef GL_ES_VERSION_2_0
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    SortBatchesState(batches);
 #else
     // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+    SortBatchesFrontToBack(batches);
 
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -835,7 +927,7 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
     geometryRemapping_.Clear();
 
     // Finally sort again with the rewritten ID's
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    SortBatchesState(batches);
 #endif
 }
 
@@ -304,7 +304,7 @@ struct LightBatchQueue
     /// Shadow map split queues.
     Vector<ShadowBatchQueue> shadowSplits_;
     /// Per-vertex lights.
-    PODVector<Light*> vertexLights_;
+    SmallVector<Light*, DRAWABLE_INLINE_LIGHTS> vertexLights_;
     /// Light volume draw calls.
     PODVector<Batch> volumeBatches_;
 };
@@ -1146,7 +1146,7 @@ void DecalSet::UpdateEventSubscription(bool checkAllDecals)
 
     if (enabled && !subscribed_)
     {
-        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(DecalSet, HandleScenePostUpdate));
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_TYPED_HANDLER(DecalSet, HandleScenePostUpdate));
         subscribed_ = true;
     }
     else if (!enabled && subscribed_)
@@ -1156,11 +1156,9 @@ void DecalSet::UpdateEventSubscription(bool checkAllDecals)
     }
 }
 
-void DecalSet::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+void DecalSet::HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData)
 {
-    using namespace ScenePostUpdate;
-
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
+    float timeStep = eventData.timeStep_;
 
     for (List<Decal>::Iterator i = decals_.Begin(); i != decals_.End();)
     {
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/SmallVector.h"
 #include "../Graphics/GraphicsDefs.h"
 #include "../Math/BoundingBox.h"
 #include "../Scene/Component.h"
@@ -40,6 +41,8 @@ static const unsigned DEFAULT_LIGHTMASK = M_MAX_UNSIGNED;
 static const unsigned DEFAULT_SHADOWMASK = M_MAX_UNSIGNED;
 static const unsigned DEFAULT_ZONEMASK = M_MAX_UNSIGNED;
 static const int MAX_VERTEX_LIGHTS = 4;
+/// Number of per-pixel and per-vertex lights a drawable stores without heap allocation.
+static const unsigned DRAWABLE_INLINE_LIGHTS = 4;
 static const float ANIMATION_LOD_BASESCALE = 2500.0f;
 
 class Camera;
@@ -269,11 +272,17 @@ public:
     /// Return whether has a base pass.
     bool HasBasePass(unsigned batchIndex) const { return (basePassFlags_ & (1u << batchIndex)) != 0; }
 
-    /// Return per-pixel lights.
-    const PODVector<Light*>& GetLights() const { return lights_; }
+    /// Return per-pixel lights. Returns a copy, as the lights are stored inline; use GetLightList() to avoid it.
+    PODVector<Light*> GetLights() const { return PODVector<Light*>(lights_.Buffer(), lights_.Size()); }
 
-    /// Return per-vertex lights.
-    const PODVector<Light*>& GetVertexLights() const { return vertexLights_; }
+    /// Return per-vertex lights. Returns a copy, as the lights are stored inline; use GetVertexLightList() to avoid it.
+    PODVector<Light*> GetVertexLights() const { return PODVector<Light*>(vertexLights_.Buffer(), vertexLights_.Size()); }
+
+    /// Return per-pixel lights without copying.
+    const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& GetLightList() const { return lights_; }
+
+    /// Return per-vertex lights without copying.
+    const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& GetVertexLightList() const { return vertexLights_; }
 
     /// Return the first added per-pixel light.
     Light* GetFirstLight() const { return firstLight_; }
@@ -378,13 +387,13 @@ protected:
     /// Maximum per-pixel lights.
     unsigned maxLights_;
     /// List of cameras from which is seen on the current frame.
-    PODVector<Camera*> viewCameras_;
+    SmallVector<Camera*, 2> viewCameras_;
     /// First per-pixel light added this frame.
     Light* firstLight_;
     /// Per-pixel lights affecting this drawable.
-    PODVector<Light*> lights_;
+    SmallVector<Light*, DRAWABLE_INLINE_LIGHTS> lights_;
     /// Per-vertex lights affecting this drawable.
-    PODVector<Light*> vertexLights_;
+    SmallVector<Light*, DRAWABLE_INLINE_LIGHTS> vertexLights_;
 };
 
 inline bool CompareDrawables(Drawable* lhs, Drawable* rhs)
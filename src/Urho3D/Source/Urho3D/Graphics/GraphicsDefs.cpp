@@ -33,62 +33,62 @@ namespace Urho3D
 // The extern keyword is required when building Urho3D.dll for Windows platform
 // The keyword is not required for other platforms but it does no harm, aside from warning from static analyzer
 
-extern URHO3D_API const StringHash VSP_AMBIENTSTARTCOLOR("AmbientStartColor");
-extern URHO3D_API const StringHash VSP_AMBIENTENDCOLOR("AmbientEndColor");
-extern URHO3D_API const StringHash VSP_BILLBOARDROT("BillboardRot");
-extern URHO3D_API const StringHash VSP_CAMERAPOS("CameraPos");
-extern URHO3D_API const StringHash VSP_CLIPPLANE("ClipPlane");
-extern URHO3D_API const StringHash VSP_NEARCLIP("NearClip");
-extern URHO3D_API const StringHash VSP_FARCLIP("FarClip");
-extern URHO3D_API const StringHash VSP_DEPTHMODE("DepthMode");
-extern URHO3D_API const StringHash VSP_DELTATIME("DeltaTime");
-extern URHO3D_API const StringHash VSP_ELAPSEDTIME("ElapsedTime");
-extern URHO3D_API const StringHash VSP_FRUSTUMSIZE("FrustumSize");
-extern URHO3D_API const StringHash VSP_GBUFFEROFFSETS("GBufferOffsets");
-extern URHO3D_API const StringHash VSP_LIGHTDIR("LightDir");
-extern URHO3D_API const StringHash VSP_LIGHTPOS("LightPos");
-extern URHO3D_API const StringHash VSP_NORMALOFFSETSCALE("NormalOffsetScale");
-extern URHO3D_API const StringHash VSP_MODEL("Model");
-extern URHO3D_API const StringHash VSP_VIEW("View");
-extern URHO3D_API const StringHash VSP_VIEWINV("ViewInv");
-extern URHO3D_API const StringHash VSP_VIEWPROJ("ViewProj");
-extern URHO3D_API const StringHash VSP_UOFFSET("UOffset");
-extern URHO3D_API const StringHash VSP_VOFFSET("VOffset");
-extern URHO3D_API const StringHash VSP_ZONE("Zone");
-extern URHO3D_API const StringHash VSP_LIGHTMATRICES("LightMatrices");
-extern URHO3D_API const StringHash VSP_SKINMATRICES("SkinMatrices");
-extern URHO3D_API const StringHash VSP_VERTEXLIGHTS("VertexLights");
-extern URHO3D_API const StringHash PSP_AMBIENTCOLOR("AmbientColor");
-extern URHO3D_API const StringHash PSP_CAMERAPOS("CameraPosPS");
-extern URHO3D_API const StringHash PSP_DELTATIME("DeltaTimePS");
-extern URHO3D_API const StringHash PSP_DEPTHRECONSTRUCT("DepthReconstruct");
-extern URHO3D_API const StringHash PSP_ELAPSEDTIME("ElapsedTimePS");
-extern URHO3D_API const StringHash PSP_FOGCOLOR("FogColor");
-extern URHO3D_API const StringHash PSP_FOGPARAMS("FogParams");
-extern URHO3D_API const StringHash PSP_GBUFFERINVSIZE("GBufferInvSize");
-extern URHO3D_API const StringHash PSP_LIGHTCOLOR("LightColor");
-extern URHO3D_API const StringHash PSP_LIGHTDIR("LightDirPS");
-extern URHO3D_API const StringHash PSP_LIGHTPOS("LightPosPS");
-extern URHO3D_API const StringHash PSP_NORMALOFFSETSCALE("NormalOffsetScalePS");
-extern URHO3D_API const StringHash PSP_MATDIFFCOLOR("MatDiffColor");
-extern URHO3D_API const StringHash PSP_MATEMISSIVECOLOR("MatEmissiveColor");
-extern URHO3D_API const StringHash PSP_MATENVMAPCOLOR("MatEnvMapColor");
-extern URHO3D_API const StringHash PSP_MATSPECCOLOR("MatSpecColor");
-extern URHO3D_API const StringHash PSP_NEARCLIP("NearClipPS");
-extern URHO3D_API const StringHash PSP_FARCLIP("FarClipPS");
-extern URHO3D_API const StringHash PSP_SHADOWCUBEADJUST("ShadowCubeAdjust");
-extern URHO3D_API const StringHash PSP_SHADOWDEPTHFADE("ShadowDepthFade");
-extern URHO3D_API const StringHash PSP_SHADOWINTENSITY("ShadowIntensity");
-extern URHO3D_API const StringHash PSP_SHADOWMAPINVSIZE("ShadowMapInvSize");
-extern URHO3D_API const StringHash PSP_SHADOWSPLITS("ShadowSplits");
-extern URHO3D_API const StringHash PSP_LIGHTMATRICES("LightMatricesPS");
-extern URHO3D_API const StringHash PSP_VSMSHADOWPARAMS("VSMShadowParams");
-extern URHO3D_API const StringHash PSP_ROUGHNESS("Roughness");
-extern URHO3D_API const StringHash PSP_METALLIC("Metallic");
-extern URHO3D_API const StringHash PSP_LIGHTRAD("LightRad");
-extern URHO3D_API const StringHash PSP_LIGHTLENGTH("LightLength");
-extern URHO3D_API const StringHash PSP_ZONEMIN("ZoneMin");
-extern URHO3D_API const StringHash PSP_ZONEMAX("ZoneMax");
+extern URHO3D_API const StringHash VSP_AMBIENTSTARTCOLOR(URHO3D_STRINGHASH("AmbientStartColor"));
+extern URHO3D_API const StringHash VSP_AMBIENTENDCOLOR(URHO3D_STRINGHASH("AmbientEndColor"));
+extern URHO3D_API const StringHash VSP_BILLBOARDROT(URHO3D_STRINGHASH("BillboardRot"));
+extern URHO3D_API const StringHash VSP_CAMERAPOS(URHO3D_STRINGHASH("CameraPos"));
+extern URHO3D_API const StringHash VSP_CLIPPLANE(URHO3D_STRINGHASH("ClipPlane"));
+extern URHO3D_API const StringHash VSP_NEARCLIP(URHO3D_STRINGHASH("NearClip"));
+extern URHO3D_API const StringHash VSP_FARCLIP(URHO3D_STRINGHASH("FarClip"));
+extern URHO3D_API const StringHash VSP_DEPTHMODE(URHO3D_STRINGHASH("DepthMode"));
+extern URHO3D_API const StringHash VSP_DELTATIME(URHO3D_STRINGHASH("DeltaTime"));
+extern URHO3D_API const StringHash VSP_ELAPSEDTIME(URHO3D_STRINGHASH("ElapsedTime"));
+extern URHO3D_API const StringHash VSP_FRUSTUMSIZE(URHO3D_STRINGHASH("FrustumSize"));
+extern URHO3D_API const StringHash VSP_GBUFFEROFFSETS(URHO3D_STRINGHASH("GBufferOffsets"));
+extern URHO3D_API const StringHash VSP_LIGHTDIR(URHO3D_STRINGHASH("LightDir"));
+extern URHO3D_API const StringHash VSP_LIGHTPOS(URHO3D_STRINGHASH("LightPos"));
+extern URHO3D_API const StringHash VSP_NORMALOFFSETSCALE(URHO3D_STRINGHASH("NormalOffsetScale"));
+extern URHO3D_API const StringHash VSP_MODEL(URHO3D_STRINGHASH("Model"));
+extern URHO3D_API const StringHash VSP_VIEW(URHO3D_STRINGHASH("View"));
+extern URHO3D_API const StringHash VSP_VIEWINV(URHO3D_STRINGHASH("ViewInv"));
+extern URHO3D_API const StringHash VSP_VIEWPROJ(URHO3D_STRINGHASH("ViewProj"));
+extern URHO3D_API const StringHash VSP_UOFFSET(URHO3D_STRINGHASH("UOffset"));
+extern URHO3D_API const StringHash VSP_VOFFSET(URHO3D_STRINGHASH("VOffset"));
+extern URHO3D_API const StringHash VSP_ZONE(URHO3D_STRINGHASH("Zone"));
+extern URHO3D_API const StringHash VSP_LIGHTMATRICES(URHO3D_STRINGHASH("LightMatrices"));
+extern URHO3D_API const StringHash VSP_SKINMATRICES(URHO3D_STRINGHASH("SkinMatrices"));
+extern URHO3D_API const StringHash VSP_VERTEXLIGHTS(URHO3D_STRINGHASH("VertexLights"));
+extern URHO3D_API const StringHash PSP_AMBIENTCOLOR(URHO3D_STRINGHASH("AmbientColor"));
+extern URHO3D_API const StringHash PSP_CAMERAPOS(URHO3D_STRINGHASH("CameraPosPS"));
+extern URHO3D_API const StringHash PSP_DELTATIME(URHO3D_STRINGHASH("DeltaTimePS"));
+extern URHO3D_API const StringHash PSP_DEPTHRECONSTRUCT(URHO3D_STRINGHASH("DepthReconstruct"));
+extern URHO3D_API const StringHash PSP_ELAPSEDTIME(URHO3D_STRINGHASH("ElapsedTimePS"));
+extern URHO3D_API const StringHash PSP_FOGCOLOR(URHO3D_STRINGHASH("FogColor"));
+extern URHO3D_API const StringHash PSP_FOGPARAMS(URHO3D_STRINGHASH("FogParams"));
+extern URHO3D_API const StringHash PSP_GBUFFERINVSIZE(URHO3D_STRINGHASH("GBufferInvSize"));
+extern URHO3D_API const StringHash PSP_LIGHTCOLOR(URHO3D_STRINGHASH("LightColor"));
+extern URHO3D_API const StringHash PSP_LIGHTDIR(URHO3D_STRINGHASH("LightDirPS"));
+extern URHO3D_API const StringHash PSP_LIGHTPOS(URHO3D_STRINGHASH("LightPosPS"));
+extern URHO3D_API const StringHash PSP_NORMALOFFSETSCALE(URHO3D_STRINGHASH("NormalOffsetScalePS"));
+extern URHO3D_API const StringHash PSP_MATDIFFCOLOR(URHO3D_STRINGHASH("MatDiffColor"));
+extern URHO3D_API const StringHash PSP_MATEMISSIVECOLOR(URHO3D_STRINGHASH("MatEmissiveColor"));
+extern URHO3D_API const StringHash PSP_MATENVMAPCOLOR(URHO3D_STRINGHASH("MatEnvMapColor"));
+extern URHO3D_API const StringHash PSP_MATSPECCOLOR(URHO3D_STRINGHASH("MatSpecColor"));
+extern URHO3D_API const StringHash PSP_NEARCLIP(URHO3D_STRINGHASH("NearClipPS"));
+extern URHO3D_API const StringHash PSP_FARCLIP(URHO3D_STRINGHASH("FarClipPS"));
+extern URHO3D_API const StringHash PSP_SHADOWCUBEADJUST(URHO3D_STRINGHASH("ShadowCubeAdjust"));
+extern URHO3D_API const StringHash PSP_SHADOWDEPTHFADE(URHO3D_STRINGHASH("ShadowDepthFade"));
+extern URHO3D_API const StringHash PSP_SHADOWINTENSITY(URHO3D_STRINGHASH("ShadowIntensity"));
+extern URHO3D_API const StringHash PSP_SHADOWMAPINVSIZE(URHO3D_STRINGHASH("ShadowMapInvSize"));
+extern URHO3D_API const StringHash PSP_SHADOWSPLITS(URHO3D_STRINGHASH("ShadowSplits"));
+extern URHO3D_API const StringHash PSP_LIGHTMATRICES(URHO3D_STRINGHASH("LightMatricesPS"));
+extern URHO3D_API const StringHash PSP_VSMSHADOWPARAMS(URHO3D_STRINGHASH("VSMShadowParams"));
+extern URHO3D_API const StringHash PSP_ROUGHNESS(URHO3D_STRINGHASH("Roughness"));
+extern URHO3D_API const StringHash PSP_METALLIC(URHO3D_STRINGHASH("Metallic"));
+extern URHO3D_API const StringHash PSP_LIGHTRAD(URHO3D_STRINGHASH("LightRad"));
+extern URHO3D_API const StringHash PSP_LIGHTLENGTH(URHO3D_STRINGHASH("LightLength"));
+extern URHO3D_API const StringHash PSP_ZONEMIN(URHO3D_STRINGHASH("ZoneMin"));
+extern URHO3D_API const StringHash PSP_ZONEMAX(URHO3D_STRINGHASH("ZoneMax"));
 
 extern URHO3D_API const Vector3 DOT_SCALE(1 / 3.0f, 1 / 3.0f, 1 / 3.0f);
 
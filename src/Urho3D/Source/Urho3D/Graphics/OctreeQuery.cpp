@@ -23,6 +23,7 @@
 #include "../Precompiled.h"
 
 #include "../Graphics/OctreeQuery.h"
+#include "../Math/BatchMath.h"
 
 #include "../DebugNew.h"
 
@@ -111,10 +112,41 @@ void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool in
 
         if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
         {
-            if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+            if (inside)
                 result_.Push(drawable);
+            else
+                AddCandidate(drawable);
         }
     }
+
+    TestCandidates();
+}
+
+void FrustumOctreeQuery::TestCandidates()
+{
+    if (!numCandidates_)
+        return;
+
+    Vector3 centers[FRUSTUM_QUERY_BATCH_SIZE];
+    Vector3 halfSizes[FRUSTUM_QUERY_BATCH_SIZE];
+    unsigned visibleMask[FRUSTUM_QUERY_BATCH_SIZE / 32];
+
+    for (unsigned i = 0; i < numCandidates_; ++i)
+    {
+        const BoundingBox& box = candidates_[i]->GetWorldBoundingBox();
+        centers[i] = box.Center();
+        halfSizes[i] = centers[i] - box.min_;
+    }
+
+    CullBoundingBoxes(frustum_, centers, halfSizes, numCandidates_, visibleMask);
+
+    for (unsigned i = 0; i < numCandidates_; ++i)
+    {
+        if (visibleMask[i >> 5u] & (1u << (i & 31u)))
+            result_.Push(candidates_[i]);
+    }
+
+    numCandidates_ = 0;
 }
 
 
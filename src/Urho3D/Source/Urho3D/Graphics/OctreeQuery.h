@@ -34,6 +34,9 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Number of drawables frustum tested at once by frustum octree queries.
+static const unsigned FRUSTUM_QUERY_BATCH_SIZE = 64;
+
 /// Base class for octree queries.
 class URHO3D_API OctreeQuery
 {
@@ -138,7 +141,8 @@ public:
     FrustumOctreeQuery(PODVector<Drawable*>& result, const Frustum& frustum, unsigned char drawableFlags = DRAWABLE_ANY,
         unsigned viewMask = DEFAULT_VIEWMASK) :
         OctreeQuery(result, drawableFlags, viewMask),
-        frustum_(frustum)
+        frustum_(frustum),
+        numCandidates_(0)
     {
     }
 
@@ -149,6 +153,24 @@ public:
 
     /// Frustum.
     Frustum frustum_;
+
+protected:
+    /// Queue a drawable that passed the query filters for the frustum test. The queue is tested when full.
+    void AddCandidate(Drawable* drawable)
+    {
+        candidates_[numCandidates_++] = drawable;
+        if (numCandidates_ == FRUSTUM_QUERY_BATCH_SIZE)
+            TestCandidates();
+    }
+
+    /// Frustum test the queued drawables four at a time and add the visible ones to the result. Call at the end of TestDrawables().
+    void TestCandidates();
+
+private:
+    /// Drawables queued for the frustum test.
+    Drawable* candidates_[FRUSTUM_QUERY_BATCH_SIZE];
+    /// Number of queued drawables.
+    unsigned numCandidates_;
 };
 
 /// General octree query result. Used for Lua bindings only.
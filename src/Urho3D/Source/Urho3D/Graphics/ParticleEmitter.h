@@ -28,6 +28,7 @@ namespace Urho3D
 {
 
 class ParticleEffect;
+class SceneUpdateEventData;
 
 /// One particle in the particle system.
 struct Particle
@@ -126,7 +127,7 @@ protected:
 
 private:
     /// Handle scene post-update event.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Handle live reload of the particle effect.
     void HandleEffectReloadFinished(StringHash eventType, VariantMap& eventData);
 
@@ -34,6 +34,7 @@ enum TrailType
 };
 
 class IndexBuffer;
+class SceneUpdateEventData;
 class VertexBuffer;
 
 /// Trail is consisting of series of tails. Two connected points make a tail.
@@ -189,7 +190,7 @@ protected:
 
 private:
     /// Handle scene post-update event.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData);
 
     /// Resize RibbonTrail vertex and index buffers.
     void UpdateBufferSize();
@@ -76,10 +76,14 @@ public:
             if (drawable->GetCastShadows() && (drawable->GetDrawableFlags() & drawableFlags_) &&
                 (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside)
                     result_.Push(drawable);
+                else
+                    AddCandidate(drawable);
             }
         }
+
+        TestCandidates();
     }
 };
 
@@ -105,10 +109,14 @@ public:
             if ((flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder())) &&
                 (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside)
                     result_.Push(drawable);
+                else
+                    AddCandidate(drawable);
             }
         }
+
+        TestCandidates();
     }
 };
 
@@ -147,10 +155,14 @@ public:
 
             if ((drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
             {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
+                if (inside)
                     result_.Push(drawable);
+                else
+                    AddCandidate(drawable);
             }
         }
+
+        TestCandidates();
     }
 
     /// Occlusion buffer.
@@ -886,29 +898,8 @@ void View::GetDrawables()
             result.maxZ_ = 0.0f;
         }
 
-        int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-        int drawablesPerItem = tempDrawables.Size() / numWorkItems;
-
-        PODVector<Drawable*>::Iterator start = tempDrawables.Begin();
-        // Create a work item for each thread
-        for (int i = 0; i < numWorkItems; ++i)
-        {
-            SharedPtr<WorkItem> item = queue->GetFreeItem();
-            item->priority_ = M_MAX_UNSIGNED;
-            item->workFunction_ = CheckVisibilityWork;
-            item->aux_ = this;
-
-            PODVector<Drawable*>::Iterator end = tempDrawables.End();
-            if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                end = start + drawablesPerItem;
-
-            item->start_ = &(*start);
-            item->end_ = &(*end);
-            queue->AddWorkItem(item);
-
-            start = end;
-        }
-
+        // Results are collected per thread index, so the chunk count does not matter
+        queue->ParallelFor(tempDrawables.Begin().ptr_, tempDrawables.End().ptr_, CheckVisibilityWork, this);
         queue->Complete(M_MAX_UNSIGNED);
     }
 
@@ -1073,7 +1064,7 @@ void View::GetLightBatches()
                     FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
 
                     // Loop through shadow casters
-                    for (PODVector<Drawable*>::ConstIterator k = query.shadowCasters_.Begin() + query.shadowCasterBegin_[j];
+                    for (FramePODVector<Drawable*>::ConstIterator k = query.shadowCasters_.Begin() + query.shadowCasterBegin_[j];
                          k < query.shadowCasters_.Begin() + query.shadowCasterEnd_[j]; ++k)
                     {
                         Drawable* drawable = *k;
@@ -1113,7 +1104,7 @@ void View::GetLightBatches()
                 }
 
                 // Process lit geometries
-                for (PODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
+                for (FramePODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
                 {
                     Drawable* drawable = *j;
                     drawable->AddLight(light);
@@ -1149,7 +1140,7 @@ void View::GetLightBatches()
             else
             {
                 // Add the vertex light to lit drawables. It will be processed later during base pass batch generation
-                for (PODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
+                for (FramePODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
                 {
                     Drawable* drawable = *j;
                     drawable->AddVertexLight(light);
@@ -1167,7 +1158,7 @@ void View::GetLightBatches()
         {
             Drawable* drawable = *i;
             drawable->LimitLights();
-            const PODVector<Light*>& lights = drawable->GetLights();
+            const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& lights = drawable->GetLightList();
 
             for (unsigned i = 0; i < lights.Size(); ++i)
             {
@@ -1230,7 +1221,7 @@ void View::GetBaseBatches()
 
                 if (info.vertexLights_)
                 {
-                    const PODVector<Light*>& drawableVertexLights = drawable->GetVertexLights();
+                    const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& drawableVertexLights = drawable->GetVertexLightList();
                     if (drawableVertexLights.Size() && !vertexLightsProcessed)
                     {
                         // Limit vertex lights. If this is a deferred opaque batch, remove converted per-pixel lights,
@@ -1336,26 +1327,8 @@ void View::UpdateGeometries()
                 }
             }
 
-            int numWorkItems = queue->GetNumThreads() + 1; // Worker threads + main thread
-            int drawablesPerItem = threadedGeometries_.Size() / numWorkItems;
-
-            PODVector<Drawable*>::Iterator start = threadedGeometries_.Begin();
-            for (int i = 0; i < numWorkItems; ++i)
-            {
-                PODVector<Drawable*>::Iterator end = threadedGeometries_.End();
-                if (i < numWorkItems - 1 && end - start > drawablesPerItem)
-                    end = start + drawablesPerItem;
-
-                SharedPtr<WorkItem> item = queue->GetFreeItem();
-                item->priority_ = M_MAX_UNSIGNED;
-                item->workFunction_ = UpdateDrawableGeometriesWork;
-                item->aux_ = const_cast<FrameInfo*>(&frame_);
-                item->start_ = &(*start);
-                item->end_ = &(*end);
-                queue->AddWorkItem(item);
-
-                start = end;
-            }
+            queue->ParallelFor(threadedGeometries_.Begin().ptr_, threadedGeometries_.End().ptr_, UpdateDrawableGeometriesWork,
+                const_cast<FrameInfo*>(&frame_));
         }
 
         // While the work queue is processed, update non-threaded geometries
@@ -1375,7 +1348,7 @@ void View::GetLitBatches(Drawable* drawable, LightBatchQueue& lightQueue, BatchQ
     const Vector<SourceBatch>& batches = drawable->GetBatches();
 
     bool allowLitBase =
-        useLitBase_ && !lightQueue.negative_ && light == drawable->GetFirstLight() && drawable->GetVertexLights().Empty() &&
+        useLitBase_ && !lightQueue.negative_ && light == drawable->GetFirstLight() && drawable->GetVertexLightList().Empty() &&
         !zone->GetAmbientGradient();
 
     for (unsigned i = 0; i < batches.Size(); ++i)
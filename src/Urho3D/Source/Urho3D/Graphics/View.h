@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FrameAllocator.h"
 #include "../Container/HashSet.h"
 #include "../Container/List.h"
 #include "../Core/Object.h"
@@ -56,10 +57,10 @@ struct LightQueryResult
 {
     /// Light.
     Light* light_;
-    /// Lit geometries.
-    PODVector<Drawable*> litGeometries_;
-    /// Shadow casters.
-    PODVector<Drawable*> shadowCasters_;
+    /// Lit geometries. Allocated from the frame allocator of the worker thread processing the light.
+    FramePODVector<Drawable*> litGeometries_;
+    /// Shadow casters. Allocated from the frame allocator of the worker thread processing the light.
+    FramePODVector<Drawable*> shadowCasters_;
     /// Shadow cameras.
     Camera* shadowCameras_[MAX_LIGHT_SPLITS];
     /// Shadow caster start indices.
@@ -300,10 +301,10 @@ private:
     }
 
     /// Return hash code for a vertex light queue.
-    unsigned long long GetVertexLightQueueHash(const PODVector<Light*>& vertexLights)
+    unsigned long long GetVertexLightQueueHash(const SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>& vertexLights)
     {
         unsigned long long hash = 0;
-        for (PODVector<Light*>::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
+        for (SmallVector<Light*, DRAWABLE_INLINE_LIGHTS>::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
             hash += (unsigned long long)(*i);
         return hash;
     }
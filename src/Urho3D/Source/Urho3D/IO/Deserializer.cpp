@@ -30,6 +30,8 @@ namespace Urho3D
 {
 
 static const float invQ = 1.0f / 32767.0f;
+/// Square root of two. Scales the smallest three quaternion components back from +-0.5.
+static const float sqrt2 = 1.41421356f;
 
 Deserializer::Deserializer() :
     position_(0),
@@ -209,6 +211,30 @@ Quaternion Deserializer::ReadPackedQuaternion()
     return ret;
 }
 
+Quaternion Deserializer::ReadSmallestThreeQuaternion()
+{
+    unsigned long long packed = ReadUInt();
+    packed |= (unsigned long long)ReadUShort() << 32u;
+
+    unsigned largest = (unsigned)(packed >> 45u) & 3u;
+    float components[4];
+    float sumSquared = 0.0f;
+    for (unsigned i = 4; i-- > 0;)
+    {
+        if (i != largest)
+        {
+            components[i] = ((packed & 0x7fffu) * invQ - 0.5f) * sqrt2;
+            sumSquared += components[i] * components[i];
+            packed >>= 15u;
+        }
+    }
+    components[largest] = sqrtf(Max(1.0f - sumSquared, 0.0f));
+
+    Quaternion ret(components[0], components[1], components[2], components[3]);
+    ret.Normalize();
+    return ret;
+}
+
 Matrix3 Deserializer::ReadMatrix3()
 {
     float data[9];
@@ -103,6 +103,8 @@ public:
     Quaternion ReadQuaternion();
     /// Read a quaternion with each component packed in 16 bits.
     Quaternion ReadPackedQuaternion();
+    /// Read a quaternion stored as the index of its largest component and the three other components in 15 bits each.
+    Quaternion ReadSmallestThreeQuaternion();
     /// Read a Matrix3.
     Matrix3 ReadMatrix3();
     /// Read a Matrix3x4.
@@ -22,6 +22,7 @@
 
 #include "../Precompiled.h"
 
+#include "../Core/Condition.h"
 #include "../Core/Context.h"
 #include "../Core/CoreEvents.h"
 #include "../Core/ProcessUtils.h"
@@ -30,7 +31,9 @@
 #include "../IO/File.h"
 #include "../IO/IOEvents.h"
 #include "../IO/Log.h"
+#include "../Math/MathDefs.h"
 
+#include <cstdarg>
 #include <cstdio>
 
 #ifdef __ANDROID__
@@ -58,8 +61,359 @@ const char* logLevelPrefixes[] =
 static Log* logInstance = nullptr;
 static bool threadErrorDisplayed = false;
 
+/// Print a formatted log message to the platform output.
+static void PrintLogMessage(int level, const String& formattedMessage, const String& message, bool quiet)
+{
+#if defined(__ANDROID__)
+    int androidLevel = ANDROID_LOG_VERBOSE + level;
+    __android_log_print(androidLevel, "Urho3D", "%s", message.CString());
+#elif defined(IOS) || defined(TVOS)
+    SDL_IOS_LogMessage(message.CString());
+#else
+    if (quiet)
+    {
+        // If in quiet mode, still print the error message to the standard error stream
+        if (level == LOG_ERROR)
+            PrintUnicodeLine(formattedMessage, true);
+    }
+    else
+        PrintUnicodeLine(formattedMessage, level == LOG_ERROR);
+#endif
+}
+
+/// Print a raw log message to the platform output.
+static void PrintRawLogMessage(const String& message, bool error, bool quiet)
+{
+#if defined(__ANDROID__)
+    if (quiet)
+    {
+        if (error)
+            __android_log_print(ANDROID_LOG_ERROR, "Urho3D", "%s", message.CString());
+    }
+    else
+        __android_log_print(error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "Urho3D", "%s", message.CString());
+#elif defined(IOS) || defined(TVOS)
+    SDL_IOS_LogMessage(message.CString());
+#else
+    if (quiet)
+    {
+        // If in quiet mode, still print the error message to the standard error stream
+        if (error)
+            PrintUnicode(message, true);
+    }
+    else
+        PrintUnicode(message, error);
+#endif
+}
+
+#ifdef URHO3D_THREADING
+
+/// Inline text capacity of an asynchronous log queue slot. Longer messages are stored in a separate allocation.
+static const unsigned LOG_SLOT_TEXT_SIZE = 232;
+
+/// Whether the current thread is an asynchronous log writer thread.
+static thread_local bool isWriterThread = false;
+
+/// Slot of the asynchronous log queue.
+struct LogQueueSlot
+{
+    /// Sequence number telling whether the slot is free for a producer or filled for the writer.
+    std::atomic<unsigned> sequence_;
+    /// Message level, LOG_RAW for raw messages.
+    int level_;
+    /// Error flag for raw messages.
+    bool error_;
+    /// Message length.
+    unsigned length_;
+    /// Message text if it did not fit inline.
+    char* longText_;
+    /// Inline message text.
+    char text_[LOG_SLOT_TEXT_SIZE];
+};
+
+/// Writer thread of the asynchronous log. Owns a bounded lock-free multi-producer queue that is consumed only by the thread itself.
+class LogWriter : public Thread
+{
+public:
+    /// Construct with owner and number of slots, which must be a power of two.
+    LogWriter(Log* owner, unsigned numSlots) :
+        owner_(owner),
+        slots_(new LogQueueSlot[numSlots]),
+        mask_(numSlots - 1),
+        enqueuePos_(0),
+        writtenPos_(0),
+        dequeuePos_(0),
+        sleeping_(false),
+        writingNow_(false)
+    {
+        for (unsigned i = 0; i < numSlots; ++i)
+            slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    /// Destruct. Stop the thread after writing the remaining messages.
+    ~LogWriter() override
+    {
+        shouldRun_ = false;
+        wakeCondition_.Set();
+        Stop();
+        delete[] slots_;
+    }
+
+    /// Write messages until stopped.
+    void ThreadFunction() override
+    {
+        isWriterThread = true;
+
+        while (shouldRun_)
+        {
+            if (WriteMessages())
+                continue;
+
+            // Announce sleeping before checking the queue once more, so that a producer either sees the flag or its message is seen here
+            sleeping_.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasMessages() && shouldRun_)
+                wakeCondition_.Wait();
+            sleeping_.store(false);
+        }
+
+        WriteMessages();
+    }
+
+    /// Push a message.
+    void Push(int level, bool error, const String& message)
+    {
+        // The writer thread would wait on itself for queue space, so write its own messages right away
+        if (isWriterThread)
+        {
+            WriteNow(level, error, message);
+            return;
+        }
+
+        unsigned pos;
+        LogQueueSlot* slot = Claim(level, error, pos);
+        if (!slot)
+            return;
+
+        char* dest = slot->text_;
+        if (message.Length() >= LOG_SLOT_TEXT_SIZE)
+            dest = slot->longText_ = new char[message.Length() + 1];
+        memcpy(dest, message.CString(), message.Length() + 1);
+        slot->length_ = message.Length();
+        Publish(slot, pos);
+    }
+
+    /// Format and push a message.
+    void Push(int level, bool error, const char* format, va_list args)
+    {
+        // Format the same way as the synchronous mode. Short messages stay in the string's inline buffer
+        String message;
+        message.AppendWithFormatArgs(format, args);
+        Push(level, error, message);
+    }
+
+    /// Wait until all messages pushed so far have been written.
+    void Flush()
+    {
+        unsigned target = enqueuePos_.load();
+        while ((int)(writtenPos_.load() - target) < 0)
+        {
+            wakeCondition_.Set();
+            Time::Sleep(0);
+        }
+    }
+
+private:
+    /// Claim a free slot and return its queue position, applying the overflow policy when the queue is full. Return null if the message is dropped.
+    LogQueueSlot* Claim(int level, bool error, unsigned& pos)
+    {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            LogQueueSlot* slot = &slots_[pos & mask_];
+            int diff = (int)(slot->sequence_.load(std::memory_order_acquire) - pos);
+            if (!diff)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot->level_ = level;
+                    slot->error_ = error;
+                    slot->longText_ = nullptr;
+                    return slot;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Queue is full
+                if (owner_->overflowPolicy_ == LOG_OVERFLOW_DROP && level != LOG_ERROR && !error)
+                {
+                    ++owner_->numDropped_;
+                    return nullptr;
+                }
+                wakeCondition_.Set();
+                Time::Sleep(0);
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+            else
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Hand a filled slot over to the writer and wake it if sleeping.
+    void Publish(LogQueueSlot* slot, unsigned pos)
+    {
+        slot->sequence_.store(pos + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed))
+            wakeCondition_.Set();
+    }
+
+    /// Return whether the next slot has been filled.
+    bool HasMessages() const
+    {
+        return slots_[dequeuePos_ & mask_].sequence_.load(std::memory_order_acquire) == dequeuePos_ + 1;
+    }
+
+    /// Write all filled messages. Return true if any were written.
+    bool WriteMessages()
+    {
+        if (!HasMessages())
+            return false;
+
+        String timeStamp = GetTimeStampPrefix();
+        bool sendEvents = owner_->sendEvents_.load(std::memory_order_relaxed);
+        List<StoredLogMessage> writtenMessages;
+        String lastMessage;
+
+        // Only the file is locked during the writes, so that other threads and the main thread's log events are not
+        // held up by file I/O
+        {
+            MutexLock fileLock(owner_->fileMutex_);
+
+            while (HasMessages())
+            {
+                LogQueueSlot& slot = slots_[dequeuePos_ & mask_];
+                String message(slot.longText_ ? slot.longText_ : slot.text_, slot.length_);
+                delete[] slot.longText_;
+                int level = slot.level_;
+                bool error = slot.error_;
+                slot.sequence_.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+                ++dequeuePos_;
+
+                WriteMessage(level, error, message, timeStamp, sendEvents, writtenMessages);
+                lastMessage = message;
+            }
+
+            // Flush once per batch instead of once per message
+            if (owner_->logFile_)
+                owner_->logFile_->Flush();
+        }
+
+        StoreWrittenMessages(lastMessage, writtenMessages);
+        writtenPos_.store(dequeuePos_);
+        return true;
+    }
+
+    /// Write a message logged by the writer thread itself without queuing it. Messages logged meanwhile are dropped to prevent recursion.
+    void WriteNow(int level, bool error, const String& message)
+    {
+        if (writingNow_)
+            return;
+
+        writingNow_ = true;
+        List<StoredLogMessage> writtenMessages;
+        {
+            MutexLock fileLock(owner_->fileMutex_);
+            WriteMessage(level, error, message, GetTimeStampPrefix(), owner_->sendEvents_.load(std::memory_order_relaxed),
+                writtenMessages);
+            if (owner_->logFile_)
+                owner_->logFile_->Flush();
+        }
+        StoreWrittenMessages(message, writtenMessages);
+        writingNow_ = false;
+    }
+
+    /// Return the timestamp to prefix messages with, or empty if timestamps are disabled.
+    String GetTimeStampPrefix() const
+    {
+        return owner_->timeStamp_ ? "[" + Time::GetTimeStamp() + "] " : String::EMPTY;
+    }
+
+    /// Output a message to the platform output and the log file, and keep it for the log message event if necessary. Called with the file mutex held.
+    void WriteMessage(int level, bool error, const String& message, const String& timeStamp, bool sendEvents,
+        List<StoredLogMessage>& writtenMessages)
+    {
+        File* logFile = owner_->logFile_;
+
+        if (level == LOG_RAW)
+        {
+            PrintRawLogMessage(message, error, owner_->quiet_);
+            if (logFile)
+                logFile->Write(message.CString(), message.Length());
+            if (sendEvents)
+                writtenMessages.Push(StoredLogMessage(message, LOG_RAW, error));
+        }
+        else
+        {
+            String formattedMessage = timeStamp + logLevelPrefixes[level];
+            formattedMessage += ": " + message;
+            PrintLogMessage(level, formattedMessage, message, owner_->quiet_);
+            if (logFile)
+                logFile->WriteLine(formattedMessage);
+            if (sendEvents)
+                writtenMessages.Push(StoredLogMessage(formattedMessage, level, false));
+        }
+    }
+
+    /// Store the last written message and the messages waiting for their log message events.
+    void StoreWrittenMessages(const String& lastMessage, const List<StoredLogMessage>& writtenMessages)
+    {
+        MutexLock lock(owner_->logMutex_);
+        owner_->lastMessage_ = lastMessage;
+        for (List<StoredLogMessage>::ConstIterator i = writtenMessages.Begin(); i != writtenMessages.End(); ++i)
+            owner_->threadMessages_.Push(*i);
+    }
+
+    /// Owner log.
+    Log* owner_;
+    /// Queue slots.
+    LogQueueSlot* slots_;
+    /// Slot index mask.
+    unsigned mask_;
+    /// Next position to claim by producers.
+    std::atomic<unsigned> enqueuePos_;
+    /// Position up to which messages have been written.
+    std::atomic<unsigned> writtenPos_;
+    /// Next position to write. Only accessed by the writer thread.
+    unsigned dequeuePos_;
+    /// Whether the writer thread is about to sleep or sleeping.
+    std::atomic<bool> sleeping_;
+    /// Whether the writer thread is writing one of its own messages. Only accessed by the writer thread.
+    bool writingNow_;
+    /// Condition for waking up the writer thread.
+    Condition wakeCondition_;
+};
+
+#else
+
+/// Placeholder writer when threading is disabled. Asynchronous mode can not be enabled.
+class LogWriter
+{
+public:
+    /// Push a message.
+    void Push(int level, bool error, const String& message) { }
+    /// Format and push a message.
+    void Push(int level, bool error, const char* format, va_list args) { }
+    /// Wait until all messages have been written.
+    void Flush() { }
+};
+
+#endif
+
 Log::Log(Context* context) :
     Object(context),
+    writer_(nullptr),
+    numPushing_(0),
 #ifdef _DEBUG
     level_(LOG_DEBUG),
 #else
@@ -67,7 +421,10 @@ Log::Log(Context* context) :
 #endif
     timeStamp_(true),
     inWrite_(false),
-    quiet_(false)
+    quiet_(false),
+    overflowPolicy_(LOG_OVERFLOW_DROP),
+    numDropped_(0),
+    sendEvents_(false)
 {
     logInstance = this;
 
@@ -76,6 +433,8 @@ Log::Log(Context* context) :
 
 Log::~Log()
 {
+    // Write the remaining queued messages before the log goes away
+    StopWriter();
     logInstance = nullptr;
 }
 
@@ -92,20 +451,26 @@ void Log::Open(const String& fileName)
             Close();
     }
 
-    logFile_ = new File(context_);
-    if (logFile_->Open(fileName, FILE_WRITE))
+    SharedPtr<File> logFile(new File(context_));
+    if (logFile->Open(fileName, FILE_WRITE))
+    {
+        {
+            MutexLock lock(fileMutex_);
+            logFile_ = logFile;
+        }
         Write(LOG_INFO, "Opened log file " + fileName);
+    }
     else
-    {
-        logFile_.Reset();
         Write(LOG_ERROR, "Failed to create log file " + fileName);
-    }
 #endif
 }
 
 void Log::Close()
 {
 #if !defined(__ANDROID__) && !defined(IOS) && !defined(TVOS)
+    Flush();
+
+    MutexLock lock(fileMutex_);
     if (logFile_ && logFile_->IsOpen())
     {
         logFile_->Close();
@@ -135,6 +500,48 @@ void Log::SetQuiet(bool quiet)
     quiet_ = quiet;
 }
 
+void Log::SetAsync(bool enable, unsigned queueSize)
+{
+#ifdef URHO3D_THREADING
+    if (enable == IsAsync())
+        return;
+
+    if (enable)
+    {
+        sendEvents_ = HasMessageReceivers();
+        auto* writer = new LogWriter(this, NextPowerOfTwo(Max(queueSize, 2U)));
+        writer->Run();
+        writer_ = writer;
+    }
+    else
+    {
+        StopWriter();
+        SendWrittenMessages();
+    }
+#else
+    if (enable)
+        URHO3D_LOGWARNING("Asynchronous logging requires threading support");
+#endif
+}
+
+void Log::SetOverflowPolicy(LogOverflowPolicy policy)
+{
+    overflowPolicy_ = policy;
+}
+
+void Log::Flush()
+{
+    LogWriter* writer = writer_.load();
+    if (writer)
+        writer->Flush();
+}
+
+String Log::GetLastMessage() const
+{
+    MutexLock lock(logMutex_);
+    return lastMessage_;
+}
+
 void Log::Write(int level, const String& message)
 {
     // Special case for LOG_RAW level
@@ -148,6 +555,15 @@ void Log::Write(int level, const String& message)
     if (level < LOG_TRACE || level >= LOG_NONE)
         return;
 
+    // In asynchronous mode queue the message from any thread, unless excluded or currently sending a log event. If asynchronous
+    // mode was disabled meanwhile, continue in synchronous mode
+    if (logInstance && logInstance->IsAsync())
+    {
+        if (logInstance->level_ > level || (Thread::IsMainThread() && logInstance->inWrite_) ||
+            logInstance->PushAsync(level, false, message))
+            return;
+    }
+
     // If not in the main thread, store message for later processing
     if (!Thread::IsMainThread())
     {
@@ -171,21 +587,7 @@ void Log::Write(int level, const String& message)
     if (logInstance->timeStamp_)
         formattedMessage = "[" + Time::GetTimeStamp() + "] " + formattedMessage;
 
-#if defined(__ANDROID__)
-    int androidLevel = ANDROID_LOG_VERBOSE + level;
-    __android_log_print(androidLevel, "Urho3D", "%s", message.CString());
-#elif defined(IOS) || defined(TVOS)
-    SDL_IOS_LogMessage(message.CString());
-#else
-    if (logInstance->quiet_)
-    {
-        // If in quiet mode, still print the error message to the standard error stream
-        if (level == LOG_ERROR)
-            PrintUnicodeLine(formattedMessage, true);
-    }
-    else
-        PrintUnicodeLine(formattedMessage, level == LOG_ERROR);
-#endif
+    PrintLogMessage(level, formattedMessage, message, logInstance->quiet_);
 
     if (logInstance->logFile_)
     {
@@ -205,8 +607,36 @@ void Log::Write(int level, const String& message)
     logInstance->inWrite_ = false;
 }
 
+void Log::WriteFormat(int level, const char* format, ...)
+{
+    // Check the level first to avoid formatting excluded messages
+    if (!logInstance || level < LOG_TRACE || level >= LOG_NONE || logInstance->level_ > level)
+        return;
+
+    va_list args;
+    va_start(args, format);
+    bool handled = false;
+    if (logInstance->IsAsync())
+        handled = (Thread::IsMainThread() && logInstance->inWrite_) || logInstance->PushAsync(level, format, args);
+    if (!handled)
+    {
+        String message;
+        message.AppendWithFormatArgs(format, args);
+        Write(level, message);
+    }
+    va_end(args);
+}
+
 void Log::WriteRaw(const String& message, bool error)
 {
+    // In asynchronous mode queue the message from any thread, unless currently sending a log event. If asynchronous mode was
+    // disabled meanwhile, continue in synchronous mode
+    if (logInstance && logInstance->IsAsync())
+    {
+        if ((Thread::IsMainThread() && logInstance->inWrite_) || logInstance->PushAsync(LOG_RAW, error, message))
+            return;
+    }
+
     // If not in the main thread, store message for later processing
     if (!Thread::IsMainThread())
     {
@@ -225,26 +655,7 @@ void Log::WriteRaw(const String& message, bool error)
 
     logInstance->lastMessage_ = message;
 
-#if defined(__ANDROID__)
-    if (logInstance->quiet_)
-    {
-        if (error)
-            __android_log_print(ANDROID_LOG_ERROR, "Urho3D", "%s", message.CString());
-    }
-    else
-        __android_log_print(error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "Urho3D", "%s", message.CString());
-#elif defined(IOS) || defined(TVOS)
-    SDL_IOS_LogMessage(message.CString());
-#else
-    if (logInstance->quiet_)
-    {
-        // If in quiet mode, still print the error message to the standard error stream
-        if (error)
-            PrintUnicode(message, true);
-    }
-    else
-        PrintUnicode(message, error);
-#endif
+    PrintRawLogMessage(message, error, logInstance->quiet_);
 
     if (logInstance->logFile_)
     {
@@ -277,20 +688,92 @@ void Log::HandleEndFrame(StringHash eventType, VariantMap& eventData)
         return;
     }
 
-    MutexLock lock(logMutex_);
+    if (IsAsync())
+    {
+        sendEvents_ = HasMessageReceivers();
+        SendWrittenMessages();
+        return;
+    }
 
-    // Process messages accumulated from other threads (if any)
-    while (!threadMessages_.Empty())
+    // Process messages accumulated from other threads (if any). Take them out first to not hold the mutex while writing
+    List<StoredLogMessage> messages;
     {
-        const StoredLogMessage& stored = threadMessages_.Front();
+        MutexLock lock(logMutex_);
+        messages.Swap(threadMessages_);
+    }
 
-        if (stored.level_ != LOG_RAW)
-            Write(stored.level_, stored.message_);
+    for (List<StoredLogMessage>::ConstIterator i = messages.Begin(); i != messages.End(); ++i)
+    {
+        if (i->level_ != LOG_RAW)
+            Write(i->level_, i->message_);
         else
-            WriteRaw(stored.message_, stored.error_);
+            WriteRaw(i->message_, i->error_);
+    }
+}
 
-        threadMessages_.PopFront();
+void Log::SendWrittenMessages()
+{
+    List<StoredLogMessage> messages;
+    {
+        MutexLock lock(logMutex_);
+        messages.Swap(threadMessages_);
     }
+
+    using namespace LogMessage;
+
+    inWrite_ = true;
+
+    for (List<StoredLogMessage>::ConstIterator i = messages.Begin(); i != messages.End(); ++i)
+    {
+        VariantMap& eventData = GetEventDataMap();
+        eventData[P_MESSAGE] = i->message_;
+        if (i->level_ != LOG_RAW)
+            eventData[P_LEVEL] = i->level_;
+        else
+            eventData[P_LEVEL] = i->error_ ? LOG_ERROR : LOG_INFO;
+        SendEvent(E_LOGMESSAGE, eventData);
+    }
+
+    inWrite_ = false;
+}
+
+bool Log::HasMessageReceivers() const
+{
+    return context_->GetEventReceivers(E_LOGMESSAGE) || context_->GetEventReceivers(const_cast<Log*>(this), E_LOGMESSAGE);
+}
+
+bool Log::PushAsync(int level, bool error, const String& message)
+{
+    // Announce the push before loading the writer, so that StopWriter() waits for it to finish
+    ++numPushing_;
+    LogWriter* writer = writer_.load();
+    if (writer)
+        writer->Push(level, error, message);
+    --numPushing_;
+    return writer != nullptr;
+}
+
+bool Log::PushAsync(int level, const char* format, va_list args)
+{
+    ++numPushing_;
+    LogWriter* writer = writer_.load();
+    if (writer)
+        writer->Push(level, false, format, args);
+    --numPushing_;
+    return writer != nullptr;
+}
+
+void Log::StopWriter()
+{
+    // Take the writer away from new pushes first, then wait for the pushes in progress before the remaining messages are
+    // written and the writer thread stopped
+    LogWriter* writer = writer_.exchange(nullptr);
+    if (!writer)
+        return;
+
+    while (numPushing_.load())
+        Time::Sleep(0);
+    delete writer;
 }
 
 }
@@ -27,6 +27,8 @@
 #include "../Core/Object.h"
 #include "../Core/StringUtils.h"
 
+#include <atomic>
+
 namespace Urho3D
 {
 
@@ -45,7 +47,17 @@ static const int LOG_ERROR = 4;
 /// Disable all log messages.
 static const int LOG_NONE = 5;
 
+/// Policy for messages written while the asynchronous log queue is full.
+enum LogOverflowPolicy
+{
+    /// Drop the message and count it. Errors are never dropped, they wait for space instead.
+    LOG_OVERFLOW_DROP = 0,
+    /// Wait for the writer thread to free space.
+    LOG_OVERFLOW_BLOCK
+};
+
 class File;
+class LogWriter;
 
 /// Stored log message from another thread.
 struct StoredLogMessage
@@ -90,6 +102,12 @@ public:
     void SetTimeStamp(bool enable);
     /// Set quiet mode ie. only print error entries to standard error stream (which is normally redirected to console also). Output to log file is not affected by this mode.
     void SetQuiet(bool quiet);
+    /// Set asynchronous mode. When enabled, messages from all threads go to a lock-free queue with the specified number of slots, and a writer thread formats and outputs them. Log message events are then sent at the end of the frame. Should be set before other threads start logging. Requires threading support.
+    void SetAsync(bool enable, unsigned queueSize = 4096);
+    /// Set policy for messages written while the asynchronous queue is full.
+    void SetOverflowPolicy(LogOverflowPolicy policy);
+    /// Wait until all messages in the asynchronous queue have been written. No-op in synchronous mode.
+    void Flush();
 
     /// Return logging level.
     int GetLevel() const { return level_; }
@@ -98,24 +116,53 @@ public:
     bool GetTimeStamp() const { return timeStamp_; }
 
     /// Return last log message.
-    String GetLastMessage() const { return lastMessage_; }
+    String GetLastMessage() const;
 
     /// Return whether log is in quiet mode (only errors printed to standard error stream).
     bool IsQuiet() const { return quiet_; }
 
+    /// Return whether asynchronous mode is enabled.
+    bool IsAsync() const { return writer_.load() != nullptr; }
+
+    /// Return policy for messages written while the asynchronous queue is full.
+    LogOverflowPolicy GetOverflowPolicy() const { return overflowPolicy_; }
+
+    /// Return number of messages dropped because the asynchronous queue was full.
+    unsigned GetNumDroppedMessages() const { return numDropped_; }
+
     /// Write to the log. If logging level is higher than the level of the message, the message is ignored.
     static void Write(int level, const String& message);
+    /// Write a printf-style formatted message to the log. The level is checked before formatting, and in asynchronous mode the message is formatted directly into the queue.
+    static void WriteFormat(int level, const char* format, ...);
     /// Write raw output to the log.
     static void WriteRaw(const String& message, bool error = false);
 
 private:
+    friend class LogWriter;
+
     /// Handle end of frame. Process the threaded log messages.
     void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Send log message events for messages already written by the writer thread.
+    void SendWrittenMessages();
+    /// Return whether log message events have receivers.
+    bool HasMessageReceivers() const;
+    /// Push a message to the asynchronous queue. Return false if asynchronous mode is not enabled.
+    bool PushAsync(int level, bool error, const String& message);
+    /// Format and push a message to the asynchronous queue. Return false without using the arguments if asynchronous mode is not enabled.
+    bool PushAsync(int level, const char* format, va_list args);
+    /// Stop the writer thread after writing the remaining queued messages, once no other thread is pushing to it.
+    void StopWriter();
 
     /// Mutex for threaded operation.
-    Mutex logMutex_;
-    /// Log messages from other threads.
+    mutable Mutex logMutex_;
+    /// Mutex for the log file, held by the writer thread while writing it and when opening or closing it.
+    Mutex fileMutex_;
+    /// Log messages from other threads. In asynchronous mode, messages already written that wait for their log message event.
     List<StoredLogMessage> threadMessages_;
+    /// Asynchronous writer thread and queue.
+    std::atomic<LogWriter*> writer_;
+    /// Number of threads currently pushing to the asynchronous queue.
+    std::atomic<int> numPushing_;
     /// Log file.
     SharedPtr<File> logFile_;
     /// Last log message.
@@ -128,6 +175,12 @@ private:
     bool inWrite_;
     /// Quiet mode flag.
     bool quiet_;
+    /// Policy for messages written while the asynchronous queue is full.
+    LogOverflowPolicy overflowPolicy_;
+    /// Number of messages dropped because the asynchronous queue was full.
+    std::atomic<unsigned> numDropped_;
+    /// Whether the writer thread should keep written messages for log message events.
+    std::atomic<bool> sendEvents_;
 };
 
 #ifdef URHO3D_LOGGING
@@ -137,11 +190,11 @@ private:
 #define URHO3D_LOGWARNING(message) Urho3D::Log::Write(Urho3D::LOG_WARNING, message)
 #define URHO3D_LOGERROR(message) Urho3D::Log::Write(Urho3D::LOG_ERROR, message)
 #define URHO3D_LOGRAW(message) Urho3D::Log::WriteRaw(message)
-#define URHO3D_LOGTRACEF(format, ...) Urho3D::Log::Write(Urho3D::LOG_TRACE, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGDEBUGF(format, ...) Urho3D::Log::Write(Urho3D::LOG_DEBUG, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGINFOF(format, ...) Urho3D::Log::Write(Urho3D::LOG_INFO, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGWARNINGF(format, ...) Urho3D::Log::Write(Urho3D::LOG_WARNING, Urho3D::ToString(format, ##__VA_ARGS__))
-#define URHO3D_LOGERRORF(format, ...) Urho3D::Log::Write(Urho3D::LOG_ERROR, Urho3D::ToString(format, ##__VA_ARGS__))
+#define URHO3D_LOGTRACEF(format, ...) Urho3D::Log::WriteFormat(Urho3D::LOG_TRACE, format, ##__VA_ARGS__)
+#define URHO3D_LOGDEBUGF(format, ...) Urho3D::Log::WriteFormat(Urho3D::LOG_DEBUG, format, ##__VA_ARGS__)
+#define URHO3D_LOGINFOF(format, ...) Urho3D::Log::WriteFormat(Urho3D::LOG_INFO, format, ##__VA_ARGS__)
+#define URHO3D_LOGWARNINGF(format, ...) Urho3D::Log::WriteFormat(Urho3D::LOG_WARNING, format, ##__VA_ARGS__)
+#define URHO3D_LOGERRORF(format, ...) Urho3D::Log::WriteFormat(Urho3D::LOG_ERROR, format, ##__VA_ARGS__)
 #define URHO3D_LOGRAWF(format, ...) Urho3D::Log::WriteRaw(Urho3D::ToString(format, ##__VA_ARGS__))
 #else
 #define URHO3D_LOGTRACE(message) ((void)0)
@@ -30,6 +30,8 @@ namespace Urho3D
 {
 
 static const float q = 32767.0f;
+/// Half of the square root of two. Smallest three quaternion components multiplied by it are within +-0.5.
+static const float halfSqrt2 = 0.70710678f;
 
 Serializer::~Serializer() = default;
 
@@ -151,6 +153,34 @@ bool Serializer::WritePackedQuaternion(const Quaternion& value)
     return Write(&coords[0], sizeof coords) == sizeof coords;
 }
 
+bool Serializer::WriteSmallestThreeQuaternion(const Quaternion& value)
+{
+    Quaternion norm = value.Normalized();
+    float components[4] = {norm.w_, norm.x_, norm.y_, norm.z_};
+
+    unsigned largest = 0;
+    for (unsigned i = 1; i < 4; ++i)
+    {
+        if (Abs(components[i]) > Abs(components[largest]))
+            largest = i;
+    }
+
+    // The largest component is restored from the unit length, with its sign made positive by negating the quaternion if necessary.
+    // The other components are within +-1/sqrt(2)
+    float scale = components[largest] < 0.0f ? -halfSqrt2 : halfSqrt2;
+    unsigned long long packed = largest;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            auto quantized = (unsigned)Round((Clamp(components[i] * scale, -0.5f, 0.5f) + 0.5f) * q);
+            packed = (packed << 15u) | quantized;
+        }
+    }
+
+    return WriteUInt((unsigned)packed) && WriteUShort((unsigned short)(packed >> 32u));
+}
+
 bool Serializer::WriteMatrix3(const Matrix3& value)
 {
     return Write(value.Data(), sizeof value) == sizeof value;
@@ -92,6 +92,8 @@ public:
     bool WriteQuaternion(const Quaternion& value);
     /// Write a quaternion with each component packed in 16 bits.
     bool WritePackedQuaternion(const Quaternion& value);
+    /// Write a normalized quaternion in 48 bits as the index of its largest component and the three other components in 15 bits each.
+    bool WriteSmallestThreeQuaternion(const Quaternion& value);
     /// Write a Matrix3.
     bool WriteMatrix3(const Matrix3& value);
     /// Write a Matrix3x4.
@@ -62,10 +62,10 @@ namespace Urho3D
 {
 
 const int SCREEN_JOYSTICK_START_ID = 0x40000000;
-const StringHash VAR_BUTTON_KEY_BINDING("VAR_BUTTON_KEY_BINDING");
-const StringHash VAR_BUTTON_MOUSE_BUTTON_BINDING("VAR_BUTTON_MOUSE_BUTTON_BINDING");
-const StringHash VAR_LAST_KEYSYM("VAR_LAST_KEYSYM");
-const StringHash VAR_SCREEN_JOYSTICK_ID("VAR_SCREEN_JOYSTICK_ID");
+const StringHash VAR_BUTTON_KEY_BINDING(URHO3D_STRINGHASH("VAR_BUTTON_KEY_BINDING"));
+const StringHash VAR_BUTTON_MOUSE_BUTTON_BINDING(URHO3D_STRINGHASH("VAR_BUTTON_MOUSE_BUTTON_BINDING"));
+const StringHash VAR_LAST_KEYSYM(URHO3D_STRINGHASH("VAR_LAST_KEYSYM"));
+const StringHash VAR_SCREEN_JOYSTICK_ID(URHO3D_STRINGHASH("VAR_SCREEN_JOYSTICK_ID"));
 
 const unsigned TOUCHID_MAX = 32;
 
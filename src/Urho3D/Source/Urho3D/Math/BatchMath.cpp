@@ -0,0 +1,874 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "../Precompiled.h"
+
+#include "../Core/ProcessUtils.h"
+#include "../Math/BatchMath.h"
+
+#ifdef URHO3D_SSE
+#include <emmintrin.h>
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define URHO3D_AVX_KERNELS
+// AVX kernels are compiled for their instruction sets regardless of the build flags, and selected at runtime
+#if defined(_MSC_VER) && !defined(__clang__)
+#define URHO3D_TARGET_AVX2
+#define URHO3D_TARGET_AVX512
+#else
+#define URHO3D_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define URHO3D_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+#endif
+#endif
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+static void TransformPointsScalar(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = transform * src[i];
+}
+
+static void TransformNormalsScalar(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = (transform.ToMatrix3() * src[i]).Normalized();
+}
+
+static void TransformBoundingBoxesScalar(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = src[i].Transformed(transform);
+}
+
+static void ComposeTransformsScalar(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest,
+    unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = Matrix3x4(translations[i], rotations[i], scales[i]);
+}
+
+static void SlerpQuaternionsScalar(const Quaternion* from, const Quaternion* to, float t, Quaternion* dest, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        dest[i] = from[i].Slerp(to[i], t);
+}
+
+static void CullBoundingBoxesScalar(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes, unsigned start,
+    unsigned count, unsigned* visibleMask)
+{
+    for (unsigned i = start; i < count; ++i)
+    {
+        bool visible = true;
+        for (const auto& plane : frustum.planes_)
+        {
+            float dist = plane.normal_.DotProduct(centers[i]) + plane.d_;
+            float absDist = plane.absNormal_.DotProduct(halfSizes[i]);
+            if (dist < -absDist)
+            {
+                visible = false;
+                break;
+            }
+        }
+
+        if (visible)
+            visibleMask[i >> 5u] |= 1u << (i & 31u);
+    }
+}
+
+static void CullSpheresScalar(const Frustum& frustum, const Sphere* spheres, unsigned start, unsigned count, unsigned* visibleMask)
+{
+    for (unsigned i = start; i < count; ++i)
+    {
+        if (frustum.IsInsideFast(spheres[i]) != OUTSIDE)
+            visibleMask[i >> 5u] |= 1u << (i & 31u);
+    }
+}
+
+#ifdef URHO3D_SSE
+/// Load four consecutive Vector3's and transpose them to vectors of x, y and z components.
+static inline void LoadVector3x4(const Vector3* src, __m128& x, __m128& y, __m128& z)
+{
+    const float* ptr = &src->x_;
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    __m128 a = _mm_loadu_ps(ptr);
+    __m128 b = _mm_loadu_ps(ptr + 4);
+    __m128 c = _mm_loadu_ps(ptr + 8);
+    x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/// Transpose vectors of x, y and z components and store them as four consecutive Vector3's.
+static inline void StoreVector3x4(Vector3* dest, __m128 x, __m128 y, __m128 z)
+{
+    float* ptr = &dest->x_;
+    _mm_storeu_ps(ptr, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(ptr + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(ptr + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+/// Return a * b + c.
+static inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+{
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+
+/// Return sine of angles between 0 and pi/2 with a Taylor polynomial.
+static inline __m128 SinHalfPi(__m128 x)
+{
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_set1_ps(-1.0f / 39916800.0f);
+    p = MulAdd(p, x2, _mm_set1_ps(1.0f / 362880.0f));
+    p = MulAdd(p, x2, _mm_set1_ps(-1.0f / 5040.0f));
+    p = MulAdd(p, x2, _mm_set1_ps(1.0f / 120.0f));
+    p = MulAdd(p, x2, _mm_set1_ps(-1.0f / 6.0f));
+    p = MulAdd(p, x2, _mm_set1_ps(1.0f));
+    return _mm_mul_ps(p, x);
+}
+
+/// Return arc cosine of values between 0 and 1 with the Abramowitz and Stegun approximation 4.4.46.
+static inline __m128 AcosUnit(__m128 x)
+{
+    __m128 p = _mm_set1_ps(-0.0012624911f);
+    p = MulAdd(p, x, _mm_set1_ps(0.0066700901f));
+    p = MulAdd(p, x, _mm_set1_ps(-0.0170881256f));
+    p = MulAdd(p, x, _mm_set1_ps(0.0308918810f));
+    p = MulAdd(p, x, _mm_set1_ps(-0.0501743046f));
+    p = MulAdd(p, x, _mm_set1_ps(0.0889789874f));
+    p = MulAdd(p, x, _mm_set1_ps(-0.2145988016f));
+    p = MulAdd(p, x, _mm_set1_ps(1.5707963050f));
+    return _mm_mul_ps(p, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), x)));
+}
+
+static void TransformPointsSSE(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const __m128 m00 = _mm_set1_ps(transform.m00_), m01 = _mm_set1_ps(transform.m01_), m02 = _mm_set1_ps(transform.m02_),
+        m03 = _mm_set1_ps(transform.m03_);
+    const __m128 m10 = _mm_set1_ps(transform.m10_), m11 = _mm_set1_ps(transform.m11_), m12 = _mm_set1_ps(transform.m12_),
+        m13 = _mm_set1_ps(transform.m13_);
+    const __m128 m20 = _mm_set1_ps(transform.m20_), m21 = _mm_set1_ps(transform.m21_), m22 = _mm_set1_ps(transform.m22_),
+        m23 = _mm_set1_ps(transform.m23_);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        LoadVector3x4(src + i, x, y, z);
+        __m128 rx = MulAdd(m00, x, MulAdd(m01, y, MulAdd(m02, z, m03)));
+        __m128 ry = MulAdd(m10, x, MulAdd(m11, y, MulAdd(m12, z, m13)));
+        __m128 rz = MulAdd(m20, x, MulAdd(m21, y, MulAdd(m22, z, m23)));
+        StoreVector3x4(dest + i, rx, ry, rz);
+    }
+
+    TransformPointsScalar(transform, src + i, dest + i, count - i);
+}
+
+static void TransformNormalsSSE(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const __m128 m00 = _mm_set1_ps(transform.m00_), m01 = _mm_set1_ps(transform.m01_), m02 = _mm_set1_ps(transform.m02_);
+    const __m128 m10 = _mm_set1_ps(transform.m10_), m11 = _mm_set1_ps(transform.m11_), m12 = _mm_set1_ps(transform.m12_);
+    const __m128 m20 = _mm_set1_ps(transform.m20_), m21 = _mm_set1_ps(transform.m21_), m22 = _mm_set1_ps(transform.m22_);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        LoadVector3x4(src + i, x, y, z);
+        __m128 rx = MulAdd(m00, x, MulAdd(m01, y, _mm_mul_ps(m02, z)));
+        __m128 ry = MulAdd(m10, x, MulAdd(m11, y, _mm_mul_ps(m12, z)));
+        __m128 rz = MulAdd(m20, x, MulAdd(m21, y, _mm_mul_ps(m22, z)));
+        // Leave zero-length normals unchanged like Vector3::Normalized()
+        __m128 lenSquared = MulAdd(rx, rx, MulAdd(ry, ry, _mm_mul_ps(rz, rz)));
+        __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(lenSquared));
+        invLen = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(lenSquared, _mm_setzero_ps()), invLen),
+            _mm_andnot_ps(_mm_cmpgt_ps(lenSquared, _mm_setzero_ps()), one));
+        StoreVector3x4(dest + i, _mm_mul_ps(rx, invLen), _mm_mul_ps(ry, invLen), _mm_mul_ps(rz, invLen));
+    }
+
+    TransformNormalsScalar(transform, src + i, dest + i, count - i);
+}
+
+static void TransformBoundingBoxesSSE(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count)
+{
+    // Boxes are processed one at a time with the matrix columns kept in registers, as the min and max vectors are already padded to four floats
+    const __m128 absMask = _mm_castsi128_ps(_mm_set_epi32(0, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF));
+    const __m128 c0 = _mm_set_ps(0.0f, transform.m20_, transform.m10_, transform.m00_);
+    const __m128 c1 = _mm_set_ps(0.0f, transform.m21_, transform.m11_, transform.m01_);
+    const __m128 c2 = _mm_set_ps(0.0f, transform.m22_, transform.m12_, transform.m02_);
+    const __m128 c3 = _mm_set_ps(0.0f, transform.m23_, transform.m13_, transform.m03_);
+    const __m128 a0 = _mm_and_ps(c0, absMask);
+    const __m128 a1 = _mm_and_ps(c1, absMask);
+    const __m128 a2 = _mm_and_ps(c2, absMask);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        __m128 minPt = _mm_loadu_ps(&src[i].min_.x_);
+        __m128 maxPt = _mm_loadu_ps(&src[i].max_.x_);
+        __m128 center = _mm_mul_ps(_mm_add_ps(minPt, maxPt), half);
+        __m128 halfSize = _mm_sub_ps(center, minPt);
+
+        __m128 newCenter = MulAdd(c0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0)),
+            MulAdd(c1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1)),
+            MulAdd(c2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2)), c3)));
+        __m128 newHalfSize = MulAdd(a0, _mm_shuffle_ps(halfSize, halfSize, _MM_SHUFFLE(0, 0, 0, 0)),
+            MulAdd(a1, _mm_shuffle_ps(halfSize, halfSize, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_mul_ps(a2, _mm_shuffle_ps(halfSize, halfSize, _MM_SHUFFLE(2, 2, 2, 2)))));
+
+        _mm_storeu_ps(&dest[i].min_.x_, _mm_sub_ps(newCenter, newHalfSize));
+        _mm_storeu_ps(&dest[i].max_.x_, _mm_add_ps(newCenter, newHalfSize));
+    }
+}
+
+static void ComposeTransformsSSE(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest,
+    unsigned count)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 qw = _mm_loadu_ps(&rotations[i].w_);
+        __m128 qx = _mm_loadu_ps(&rotations[i + 1].w_);
+        __m128 qy = _mm_loadu_ps(&rotations[i + 2].w_);
+        __m128 qz = _mm_loadu_ps(&rotations[i + 3].w_);
+        _MM_TRANSPOSE4_PS(qw, qx, qy, qz);
+        __m128 tx, ty, tz, sx, sy, sz;
+        LoadVector3x4(translations + i, tx, ty, tz);
+        LoadVector3x4(scales + i, sx, sy, sz);
+
+        __m128 x2 = _mm_mul_ps(qx, two);
+        __m128 y2 = _mm_mul_ps(qy, two);
+        __m128 z2 = _mm_mul_ps(qz, two);
+        __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2), zz = _mm_mul_ps(qz, z2);
+        __m128 xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+        __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2), wz = _mm_mul_ps(qw, z2);
+
+        // Rotation matrix columns are multiplied by the scale
+        __m128 r0 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, yy), zz), sx);
+        __m128 r1 = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+        __m128 r2 = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+        __m128 r3 = tx;
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&dest[i].m00_, r0);
+        _mm_storeu_ps(&dest[i + 1].m00_, r1);
+        _mm_storeu_ps(&dest[i + 2].m00_, r2);
+        _mm_storeu_ps(&dest[i + 3].m00_, r3);
+
+        r0 = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+        r1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx), zz), sy);
+        r2 = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+        r3 = ty;
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&dest[i].m10_, r0);
+        _mm_storeu_ps(&dest[i + 1].m10_, r1);
+        _mm_storeu_ps(&dest[i + 2].m10_, r2);
+        _mm_storeu_ps(&dest[i + 3].m10_, r3);
+
+        r0 = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+        r1 = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+        r2 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx), yy), sz);
+        r3 = tz;
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&dest[i].m20_, r0);
+        _mm_storeu_ps(&dest[i + 1].m20_, r1);
+        _mm_storeu_ps(&dest[i + 2].m20_, r2);
+        _mm_storeu_ps(&dest[i + 3].m20_, r3);
+    }
+
+    ComposeTransformsScalar(translations + i, rotations + i, scales + i, dest + i, count - i);
+}
+
+static void SlerpQuaternionsSSE(const Quaternion* from, const Quaternion* to, float t, Quaternion* dest, unsigned count)
+{
+    unsigned i = 0;
+
+    // The sine approximation covers the angles produced by interpolation factors between 0 and 1
+    if (t >= 0.0f && t <= 1.0f)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+        const __m128 tv = _mm_set1_ps(t);
+        const __m128 invT = _mm_set1_ps(1.0f - t);
+        const __m128 minSin = _mm_set1_ps(0.001f);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 aw = _mm_loadu_ps(&from[i].w_);
+            __m128 ax = _mm_loadu_ps(&from[i + 1].w_);
+            __m128 ay = _mm_loadu_ps(&from[i + 2].w_);
+            __m128 az = _mm_loadu_ps(&from[i + 3].w_);
+            _MM_TRANSPOSE4_PS(aw, ax, ay, az);
+            __m128 bw = _mm_loadu_ps(&to[i].w_);
+            __m128 bx = _mm_loadu_ps(&to[i + 1].w_);
+            __m128 by = _mm_loadu_ps(&to[i + 2].w_);
+            __m128 bz = _mm_loadu_ps(&to[i + 3].w_);
+            _MM_TRANSPOSE4_PS(bw, bx, by, bz);
+
+            // Take the shortest path by flipping the sign of the second weight when the dot product is negative
+            __m128 cosAngle = MulAdd(aw, bw, MulAdd(ax, bx, MulAdd(ay, by, _mm_mul_ps(az, bz))));
+            __m128 sign = _mm_and_ps(cosAngle, signMask);
+            cosAngle = _mm_min_ps(_mm_xor_ps(cosAngle, sign), one);
+
+            __m128 angle = AcosUnit(cosAngle);
+            __m128 sinAngle = SinHalfPi(angle);
+            __m128 useSlerp = _mm_cmpgt_ps(sinAngle, minSin);
+            __m128 invSinAngle = _mm_div_ps(one, _mm_max_ps(sinAngle, minSin));
+            __m128 t1 = _mm_mul_ps(SinHalfPi(_mm_mul_ps(invT, angle)), invSinAngle);
+            __m128 t2 = _mm_mul_ps(SinHalfPi(_mm_mul_ps(tv, angle)), invSinAngle);
+            t1 = _mm_or_ps(_mm_and_ps(useSlerp, t1), _mm_andnot_ps(useSlerp, invT));
+            t2 = _mm_xor_ps(_mm_or_ps(_mm_and_ps(useSlerp, t2), _mm_andnot_ps(useSlerp, tv)), sign);
+
+            __m128 rw = MulAdd(aw, t1, _mm_mul_ps(bw, t2));
+            __m128 rx = MulAdd(ax, t1, _mm_mul_ps(bx, t2));
+            __m128 ry = MulAdd(ay, t1, _mm_mul_ps(by, t2));
+            __m128 rz = MulAdd(az, t1, _mm_mul_ps(bz, t2));
+            _MM_TRANSPOSE4_PS(rw, rx, ry, rz);
+            _mm_storeu_ps(&dest[i].w_, rw);
+            _mm_storeu_ps(&dest[i + 1].w_, rx);
+            _mm_storeu_ps(&dest[i + 2].w_, ry);
+            _mm_storeu_ps(&dest[i + 3].w_, rz);
+        }
+    }
+
+    SlerpQuaternionsScalar(from + i, to + i, t, dest + i, count - i);
+}
+
+static void CullBoundingBoxesSSE(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes, unsigned start,
+    unsigned count, unsigned* visibleMask)
+{
+    // Broadcast the plane normals, absolute normals and distances once
+    __m128 planes[NUM_FRUSTUM_PLANES][7];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm_set1_ps(plane.absNormal_.x_);
+        planes[j][4] = _mm_set1_ps(plane.absNormal_.y_);
+        planes[j][5] = _mm_set1_ps(plane.absNormal_.z_);
+        planes[j][6] = _mm_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 cx, cy, cz, hx, hy, hz;
+        LoadVector3x4(centers + i, cx, cy, cz);
+        LoadVector3x4(halfSizes + i, hx, hy, hz);
+
+        // Test all planes without early out, accumulating the lanes that are outside any plane
+        __m128 outside = _mm_setzero_ps();
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m128* plane = planes[j];
+            __m128 dist = _mm_add_ps(MulAdd(plane[2], cz, MulAdd(plane[1], cy, _mm_mul_ps(plane[0], cx))), plane[6]);
+            __m128 absDist = MulAdd(plane[5], hz, MulAdd(plane[4], hy, _mm_mul_ps(plane[3], hx)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, absDist), _mm_setzero_ps()));
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~_mm_movemask_ps(outside) & 0xf) << (i & 31u);
+    }
+
+    CullBoundingBoxesScalar(frustum, centers, halfSizes, i, count, visibleMask);
+}
+
+static void CullSpheresSSE(const Frustum& frustum, const Sphere* spheres, unsigned start, unsigned count, unsigned* visibleMask)
+{
+    static_assert(sizeof(Sphere) == 4 * sizeof(float), "Sphere must consist of the center and radius only");
+
+    __m128 planes[NUM_FRUSTUM_PLANES][4];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 4 <= count; i += 4)
+    {
+        // A sphere is a center followed by the radius, so four of them transpose to x, y, z and radius vectors
+        __m128 cx = _mm_loadu_ps(&spheres[i].center_.x_);
+        __m128 cy = _mm_loadu_ps(&spheres[i + 1].center_.x_);
+        __m128 cz = _mm_loadu_ps(&spheres[i + 2].center_.x_);
+        __m128 radius = _mm_loadu_ps(&spheres[i + 3].center_.x_);
+        _MM_TRANSPOSE4_PS(cx, cy, cz, radius);
+
+        __m128 outside = _mm_setzero_ps();
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m128* plane = planes[j];
+            __m128 dist = _mm_add_ps(MulAdd(plane[2], cz, MulAdd(plane[1], cy, _mm_mul_ps(plane[0], cx))), plane[3]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~_mm_movemask_ps(outside) & 0xf) << (i & 31u);
+    }
+
+    CullSpheresScalar(frustum, spheres, i, count, visibleMask);
+}
+#endif
+
+#ifdef URHO3D_AVX_KERNELS
+/// Load eight consecutive Vector3's and transpose them to vectors of x, y and z components. Each 128-bit lane is shuffled like in LoadVector3x4(), the low lane holding the first four.
+static inline URHO3D_TARGET_AVX2 void LoadVector3x8(const Vector3* src, __m256& x, __m256& y, __m256& z)
+{
+    const float* ptr = &src->x_;
+    __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr)), _mm_loadu_ps(ptr + 12), 1);
+    __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4)), _mm_loadu_ps(ptr + 16), 1);
+    __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 8)), _mm_loadu_ps(ptr + 20), 1);
+    x = _mm256_shuffle_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/// Transpose vectors of x, y and z components and store them as eight consecutive Vector3's.
+static inline URHO3D_TARGET_AVX2 void StoreVector3x8(Vector3* dest, __m256 x, __m256 y, __m256 z)
+{
+    float* ptr = &dest->x_;
+    __m256 a = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storeu_ps(ptr, _mm256_castps256_ps128(a));
+    _mm_storeu_ps(ptr + 4, _mm256_castps256_ps128(b));
+    _mm_storeu_ps(ptr + 8, _mm256_castps256_ps128(c));
+    _mm_storeu_ps(ptr + 12, _mm256_extractf128_ps(a, 1));
+    _mm_storeu_ps(ptr + 16, _mm256_extractf128_ps(b, 1));
+    _mm_storeu_ps(ptr + 20, _mm256_extractf128_ps(c, 1));
+}
+
+/// Transpose the 4x4 matrix in each 128-bit lane of four vectors.
+static inline URHO3D_TARGET_AVX2 void Transpose4x4x2(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+static URHO3D_TARGET_AVX2 void TransformPointsAVX2(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const __m256 m00 = _mm256_set1_ps(transform.m00_), m01 = _mm256_set1_ps(transform.m01_), m02 = _mm256_set1_ps(transform.m02_),
+        m03 = _mm256_set1_ps(transform.m03_);
+    const __m256 m10 = _mm256_set1_ps(transform.m10_), m11 = _mm256_set1_ps(transform.m11_), m12 = _mm256_set1_ps(transform.m12_),
+        m13 = _mm256_set1_ps(transform.m13_);
+    const __m256 m20 = _mm256_set1_ps(transform.m20_), m21 = _mm256_set1_ps(transform.m21_), m22 = _mm256_set1_ps(transform.m22_),
+        m23 = _mm256_set1_ps(transform.m23_);
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y, z;
+        LoadVector3x8(src + i, x, y, z);
+        __m256 rx = _mm256_fmadd_ps(m00, x, _mm256_fmadd_ps(m01, y, _mm256_fmadd_ps(m02, z, m03)));
+        __m256 ry = _mm256_fmadd_ps(m10, x, _mm256_fmadd_ps(m11, y, _mm256_fmadd_ps(m12, z, m13)));
+        __m256 rz = _mm256_fmadd_ps(m20, x, _mm256_fmadd_ps(m21, y, _mm256_fmadd_ps(m22, z, m23)));
+        StoreVector3x8(dest + i, rx, ry, rz);
+    }
+
+    TransformPointsSSE(transform, src + i, dest + i, count - i);
+}
+
+static URHO3D_TARGET_AVX2 void TransformNormalsAVX2(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const __m256 m00 = _mm256_set1_ps(transform.m00_), m01 = _mm256_set1_ps(transform.m01_), m02 = _mm256_set1_ps(transform.m02_);
+    const __m256 m10 = _mm256_set1_ps(transform.m10_), m11 = _mm256_set1_ps(transform.m11_), m12 = _mm256_set1_ps(transform.m12_);
+    const __m256 m20 = _mm256_set1_ps(transform.m20_), m21 = _mm256_set1_ps(transform.m21_), m22 = _mm256_set1_ps(transform.m22_);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y, z;
+        LoadVector3x8(src + i, x, y, z);
+        __m256 rx = _mm256_fmadd_ps(m00, x, _mm256_fmadd_ps(m01, y, _mm256_mul_ps(m02, z)));
+        __m256 ry = _mm256_fmadd_ps(m10, x, _mm256_fmadd_ps(m11, y, _mm256_mul_ps(m12, z)));
+        __m256 rz = _mm256_fmadd_ps(m20, x, _mm256_fmadd_ps(m21, y, _mm256_mul_ps(m22, z)));
+        __m256 lenSquared = _mm256_fmadd_ps(rx, rx, _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rz, rz)));
+        __m256 invLen = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(lenSquared)),
+            _mm256_cmp_ps(lenSquared, _mm256_setzero_ps(), _CMP_GT_OQ));
+        StoreVector3x8(dest + i, _mm256_mul_ps(rx, invLen), _mm256_mul_ps(ry, invLen), _mm256_mul_ps(rz, invLen));
+    }
+
+    TransformNormalsSSE(transform, src + i, dest + i, count - i);
+}
+
+static URHO3D_TARGET_AVX2 void CullBoundingBoxesAVX2(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes,
+    unsigned start, unsigned count, unsigned* visibleMask)
+{
+    __m256 planes[NUM_FRUSTUM_PLANES][7];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm256_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm256_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm256_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm256_set1_ps(plane.absNormal_.x_);
+        planes[j][4] = _mm256_set1_ps(plane.absNormal_.y_);
+        planes[j][5] = _mm256_set1_ps(plane.absNormal_.z_);
+        planes[j][6] = _mm256_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 cx, cy, cz, hx, hy, hz;
+        LoadVector3x8(centers + i, cx, cy, cz);
+        LoadVector3x8(halfSizes + i, hx, hy, hz);
+
+        __m256 outside = _mm256_setzero_ps();
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m256* plane = planes[j];
+            __m256 dist = _mm256_fmadd_ps(plane[2], cz, _mm256_fmadd_ps(plane[1], cy, _mm256_fmadd_ps(plane[0], cx, plane[6])));
+            __m256 absDist = _mm256_fmadd_ps(plane[5], hz, _mm256_fmadd_ps(plane[4], hy, _mm256_mul_ps(plane[3], hx)));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dist, absDist), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~_mm256_movemask_ps(outside) & 0xff) << (i & 31u);
+    }
+
+    CullBoundingBoxesSSE(frustum, centers, halfSizes, i, count, visibleMask);
+}
+
+static URHO3D_TARGET_AVX2 void CullSpheresAVX2(const Frustum& frustum, const Sphere* spheres, unsigned start, unsigned count,
+    unsigned* visibleMask)
+{
+    __m256 planes[NUM_FRUSTUM_PLANES][4];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm256_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm256_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm256_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm256_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 8 <= count; i += 8)
+    {
+        // The low lanes hold the first four spheres and the high lanes the next four
+        const float* ptr = &spheres[i].center_.x_;
+        __m256 cx = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr)), _mm_loadu_ps(ptr + 16), 1);
+        __m256 cy = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4)), _mm_loadu_ps(ptr + 20), 1);
+        __m256 cz = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 8)), _mm_loadu_ps(ptr + 24), 1);
+        __m256 radius = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 12)), _mm_loadu_ps(ptr + 28), 1);
+        Transpose4x4x2(cx, cy, cz, radius);
+
+        __m256 outside = _mm256_setzero_ps();
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m256* plane = planes[j];
+            __m256 dist = _mm256_fmadd_ps(plane[2], cz, _mm256_fmadd_ps(plane[1], cy, _mm256_fmadd_ps(plane[0], cx, plane[3])));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~_mm256_movemask_ps(outside) & 0xff) << (i & 31u);
+    }
+
+    CullSpheresSSE(frustum, spheres, i, count, visibleMask);
+}
+
+/// Load four floats from each of four addresses to the 128-bit lanes of a vector.
+static inline URHO3D_TARGET_AVX512 __m512 LoadLanes(const float* a, const float* b, const float* c, const float* d)
+{
+    __m512 result = _mm512_castps128_ps512(_mm_loadu_ps(a));
+    result = _mm512_insertf32x4(result, _mm_loadu_ps(b), 1);
+    result = _mm512_insertf32x4(result, _mm_loadu_ps(c), 2);
+    return _mm512_insertf32x4(result, _mm_loadu_ps(d), 3);
+}
+
+/// Store the 128-bit lanes of a vector to four addresses.
+static inline URHO3D_TARGET_AVX512 void StoreLanes(float* a, float* b, float* c, float* d, __m512 value)
+{
+    _mm_storeu_ps(a, _mm512_castps512_ps128(value));
+    _mm_storeu_ps(b, _mm512_extractf32x4_ps(value, 1));
+    _mm_storeu_ps(c, _mm512_extractf32x4_ps(value, 2));
+    _mm_storeu_ps(d, _mm512_extractf32x4_ps(value, 3));
+}
+
+/// Load sixteen consecutive Vector3's and transpose them to vectors of x, y and z components. Each 128-bit lane holds four of them.
+static inline URHO3D_TARGET_AVX512 void LoadVector3x16(const Vector3* src, __m512& x, __m512& y, __m512& z)
+{
+    const float* ptr = &src->x_;
+    __m512 a = LoadLanes(ptr, ptr + 12, ptr + 24, ptr + 36);
+    __m512 b = LoadLanes(ptr + 4, ptr + 16, ptr + 28, ptr + 40);
+    __m512 c = LoadLanes(ptr + 8, ptr + 20, ptr + 32, ptr + 44);
+    x = _mm512_shuffle_ps(_mm512_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm512_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm512_shuffle_ps(_mm512_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm512_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm512_shuffle_ps(_mm512_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm512_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/// Transpose vectors of x, y and z components and store them as sixteen consecutive Vector3's.
+static inline URHO3D_TARGET_AVX512 void StoreVector3x16(Vector3* dest, __m512 x, __m512 y, __m512 z)
+{
+    float* ptr = &dest->x_;
+    __m512 a = _mm512_shuffle_ps(_mm512_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm512_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    __m512 b = _mm512_shuffle_ps(_mm512_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm512_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    __m512 c = _mm512_shuffle_ps(_mm512_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm512_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    StoreLanes(ptr, ptr + 12, ptr + 24, ptr + 36, a);
+    StoreLanes(ptr + 4, ptr + 16, ptr + 28, ptr + 40, b);
+    StoreLanes(ptr + 8, ptr + 20, ptr + 32, ptr + 44, c);
+}
+
+static URHO3D_TARGET_AVX512 void TransformPointsAVX512(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    const __m512 m00 = _mm512_set1_ps(transform.m00_), m01 = _mm512_set1_ps(transform.m01_), m02 = _mm512_set1_ps(transform.m02_),
+        m03 = _mm512_set1_ps(transform.m03_);
+    const __m512 m10 = _mm512_set1_ps(transform.m10_), m11 = _mm512_set1_ps(transform.m11_), m12 = _mm512_set1_ps(transform.m12_),
+        m13 = _mm512_set1_ps(transform.m13_);
+    const __m512 m20 = _mm512_set1_ps(transform.m20_), m21 = _mm512_set1_ps(transform.m21_), m22 = _mm512_set1_ps(transform.m22_),
+        m23 = _mm512_set1_ps(transform.m23_);
+
+    unsigned i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 x, y, z;
+        LoadVector3x16(src + i, x, y, z);
+        __m512 rx = _mm512_fmadd_ps(m00, x, _mm512_fmadd_ps(m01, y, _mm512_fmadd_ps(m02, z, m03)));
+        __m512 ry = _mm512_fmadd_ps(m10, x, _mm512_fmadd_ps(m11, y, _mm512_fmadd_ps(m12, z, m13)));
+        __m512 rz = _mm512_fmadd_ps(m20, x, _mm512_fmadd_ps(m21, y, _mm512_fmadd_ps(m22, z, m23)));
+        StoreVector3x16(dest + i, rx, ry, rz);
+    }
+
+    TransformPointsAVX2(transform, src + i, dest + i, count - i);
+}
+
+static URHO3D_TARGET_AVX512 void CullBoundingBoxesAVX512(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes,
+    unsigned start, unsigned count, unsigned* visibleMask)
+{
+    __m512 planes[NUM_FRUSTUM_PLANES][7];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm512_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm512_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm512_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm512_set1_ps(plane.absNormal_.x_);
+        planes[j][4] = _mm512_set1_ps(plane.absNormal_.y_);
+        planes[j][5] = _mm512_set1_ps(plane.absNormal_.z_);
+        planes[j][6] = _mm512_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 cx, cy, cz, hx, hy, hz;
+        LoadVector3x16(centers + i, cx, cy, cz);
+        LoadVector3x16(halfSizes + i, hx, hy, hz);
+
+        // Comparisons produce bitmasks directly
+        __mmask16 outside = 0;
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m512* plane = planes[j];
+            __m512 dist = _mm512_fmadd_ps(plane[2], cz, _mm512_fmadd_ps(plane[1], cy, _mm512_fmadd_ps(plane[0], cx, plane[6])));
+            __m512 absDist = _mm512_fmadd_ps(plane[5], hz, _mm512_fmadd_ps(plane[4], hy, _mm512_mul_ps(plane[3], hx)));
+            outside |= _mm512_cmp_ps_mask(_mm512_add_ps(dist, absDist), _mm512_setzero_ps(), _CMP_LT_OQ);
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~outside & 0xffffu) << (i & 31u);
+    }
+
+    CullBoundingBoxesAVX2(frustum, centers, halfSizes, i, count, visibleMask);
+}
+
+static URHO3D_TARGET_AVX512 void CullSpheresAVX512(const Frustum& frustum, const Sphere* spheres, unsigned start, unsigned count,
+    unsigned* visibleMask)
+{
+    __m512 planes[NUM_FRUSTUM_PLANES][4];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = frustum.planes_[j];
+        planes[j][0] = _mm512_set1_ps(plane.normal_.x_);
+        planes[j][1] = _mm512_set1_ps(plane.normal_.y_);
+        planes[j][2] = _mm512_set1_ps(plane.normal_.z_);
+        planes[j][3] = _mm512_set1_ps(plane.d_);
+    }
+
+    unsigned i = start;
+    for (; i + 16 <= count; i += 16)
+    {
+        // Each 128-bit lane holds four consecutive spheres, transposed within the lane
+        const float* ptr = &spheres[i].center_.x_;
+        __m512 r0 = LoadLanes(ptr, ptr + 16, ptr + 32, ptr + 48);
+        __m512 r1 = LoadLanes(ptr + 4, ptr + 20, ptr + 36, ptr + 52);
+        __m512 r2 = LoadLanes(ptr + 8, ptr + 24, ptr + 40, ptr + 56);
+        __m512 r3 = LoadLanes(ptr + 12, ptr + 28, ptr + 44, ptr + 60);
+        __m512 t0 = _mm512_unpacklo_ps(r0, r1);
+        __m512 t1 = _mm512_unpacklo_ps(r2, r3);
+        __m512 t2 = _mm512_unpackhi_ps(r0, r1);
+        __m512 t3 = _mm512_unpackhi_ps(r2, r3);
+        __m512 cx = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        __m512 cy = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        __m512 cz = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        __m512 radius = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+        __mmask16 outside = 0;
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m512* plane = planes[j];
+            __m512 dist = _mm512_fmadd_ps(plane[2], cz, _mm512_fmadd_ps(plane[1], cy, _mm512_fmadd_ps(plane[0], cx, plane[3])));
+            outside |= _mm512_cmp_ps_mask(_mm512_add_ps(dist, radius), _mm512_setzero_ps(), _CMP_LT_OQ);
+        }
+
+        visibleMask[i >> 5u] |= (unsigned)(~outside & 0xffffu) << (i & 31u);
+    }
+
+    CullSpheresAVX2(frustum, spheres, i, count, visibleMask);
+}
+#endif
+
+/// Batch math kernel functions for a SIMD level.
+struct BatchMathKernels
+{
+    /// Point transform.
+    void (*transformPoints_)(const Matrix3x4&, const Vector3*, Vector3*, unsigned);
+    /// Normal transform.
+    void (*transformNormals_)(const Matrix3x4&, const Vector3*, Vector3*, unsigned);
+    /// Bounding box transform.
+    void (*transformBoundingBoxes_)(const Matrix3x4&, const BoundingBox*, BoundingBox*, unsigned);
+    /// Transform composition.
+    void (*composeTransforms_)(const Vector3*, const Quaternion*, const Vector3*, Matrix3x4*, unsigned);
+    /// Quaternion interpolation.
+    void (*slerpQuaternions_)(const Quaternion*, const Quaternion*, float, Quaternion*, unsigned);
+    /// Bounding box culling of the elements from start to count.
+    void (*cullBoundingBoxes_)(const Frustum&, const Vector3*, const Vector3*, unsigned, unsigned, unsigned*);
+    /// Sphere culling of the elements from start to count.
+    void (*cullSpheres_)(const Frustum&, const Sphere*, unsigned, unsigned, unsigned*);
+};
+
+/// Kernels indexed by SIMD level. Levels without dedicated kernels for an operation use the next lower level's.
+static const BatchMathKernels kernelsByLevel[] =
+{
+    // SIMD_NONE
+    {TransformPointsScalar, TransformNormalsScalar, TransformBoundingBoxesScalar, ComposeTransformsScalar, SlerpQuaternionsScalar,
+        CullBoundingBoxesScalar, CullSpheresScalar},
+#ifdef URHO3D_SSE
+    // SIMD_SSE2
+    {TransformPointsSSE, TransformNormalsSSE, TransformBoundingBoxesSSE, ComposeTransformsSSE, SlerpQuaternionsSSE,
+        CullBoundingBoxesSSE, CullSpheresSSE},
+    // SIMD_SSE41
+    {TransformPointsSSE, TransformNormalsSSE, TransformBoundingBoxesSSE, ComposeTransformsSSE, SlerpQuaternionsSSE,
+        CullBoundingBoxesSSE, CullSpheresSSE},
+#endif
+#ifdef URHO3D_AVX_KERNELS
+    // SIMD_AVX2
+    {TransformPointsAVX2, TransformNormalsAVX2, TransformBoundingBoxesSSE, ComposeTransformsSSE, SlerpQuaternionsSSE,
+        CullBoundingBoxesAVX2, CullSpheresAVX2},
+    // SIMD_AVX512
+    {TransformPointsAVX512, TransformNormalsAVX2, TransformBoundingBoxesSSE, ComposeTransformsSSE, SlerpQuaternionsSSE,
+        CullBoundingBoxesAVX512, CullSpheresAVX512},
+#endif
+};
+
+/// Highest SIMD level with kernels compiled in.
+static const SIMDLevel maxKernelLevel = (SIMDLevel)(sizeof kernelsByLevel / sizeof kernelsByLevel[0] - 1);
+
+/// Selected SIMD level. Initialized at startup to the highest level supported by the CPU.
+static SIMDLevel kernelLevel = Min(GetCPUSIMDLevel(), maxKernelLevel);
+
+void SetBatchMathSIMDLevel(SIMDLevel level)
+{
+    kernelLevel = Clamp(level, SIMD_NONE, Min(GetCPUSIMDLevel(), maxKernelLevel));
+}
+
+SIMDLevel GetBatchMathSIMDLevel()
+{
+    return kernelLevel;
+}
+
+void TransformPoints(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    kernelsByLevel[kernelLevel].transformPoints_(transform, src, dest, count);
+}
+
+void TransformNormals(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count)
+{
+    kernelsByLevel[kernelLevel].transformNormals_(transform, src, dest, count);
+}
+
+void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count)
+{
+    kernelsByLevel[kernelLevel].transformBoundingBoxes_(transform, src, dest, count);
+}
+
+void ComposeTransforms(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest,
+    unsigned count)
+{
+    kernelsByLevel[kernelLevel].composeTransforms_(translations, rotations, scales, dest, count);
+}
+
+void SlerpQuaternions(const Quaternion* from, const Quaternion* to, float t, Quaternion* dest, unsigned count)
+{
+    kernelsByLevel[kernelLevel].slerpQuaternions_(from, to, t, dest, count);
+}
+
+void CullBoundingBoxes(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes, unsigned count,
+    unsigned* visibleMask)
+{
+    for (unsigned i = 0; i < (count + 31) >> 5u; ++i)
+        visibleMask[i] = 0;
+
+    kernelsByLevel[kernelLevel].cullBoundingBoxes_(frustum, centers, halfSizes, 0, count, visibleMask);
+}
+
+void CullSpheres(const Frustum& frustum, const Sphere* spheres, unsigned count, unsigned* visibleMask)
+{
+    for (unsigned i = 0; i < (count + 31) >> 5u; ++i)
+        visibleMask[i] = 0;
+
+    kernelsByLevel[kernelLevel].cullSpheres_(frustum, spheres, 0, count, visibleMask);
+}
+
+}
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2008-2018 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../Core/ProcessUtils.h"
+#include "../Math/BoundingBox.h"
+#include "../Math/Frustum.h"
+#include "../Math/Matrix3x4.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Sphere.h"
+
+namespace Urho3D
+{
+
+/// Select the batch math kernels of a SIMD level, clamped to the highest level supported by the CPU. Operations without a dedicated kernel for the level use the next lower level's. The highest supported level is selected automatically at startup, so this is mainly useful for testing and benchmarking. Must not be called while batch math functions execute in other threads.
+URHO3D_API void SetBatchMathSIMDLevel(SIMDLevel level);
+/// Return the SIMD level of the selected batch math kernels.
+URHO3D_API SIMDLevel GetBatchMathSIMDLevel();
+
+/// Transform an array of points by a matrix. The source and destination may be the same array. With SSE, processes four points at a time, converted to structure-of-arrays form in registers.
+URHO3D_API void TransformPoints(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count);
+/// Transform an array of normals by the rotation and scale part of a matrix and normalize them. Correct for rotations and uniform scaling. The source and destination may be the same array.
+URHO3D_API void TransformNormals(const Matrix3x4& transform, const Vector3* src, Vector3* dest, unsigned count);
+/// Transform an array of bounding boxes by a matrix. The source and destination may be the same array. Same result as BoundingBox::Transformed() for each box.
+URHO3D_API void TransformBoundingBoxes(const Matrix3x4& transform, const BoundingBox* src, BoundingBox* dest, unsigned count);
+/// Compose arrays of translations, rotations and scales into transform matrices. Same result as the Matrix3x4 constructor from translation, rotation and scale for each element.
+URHO3D_API void ComposeTransforms(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix3x4* dest,
+    unsigned count);
+/// Spherically interpolate between two arrays of quaternions with the same interpolation factor. The destination may be the same array as either source. Matches Quaternion::Slerp() to within float precision when t is between 0 and 1.
+URHO3D_API void SlerpQuaternions(const Quaternion* from, const Quaternion* to, float t, Quaternion* dest, unsigned count);
+/// Test an array of bounding boxes, given as centers and half sizes, against a frustum. Write a visibility bitmask with bit (i & 31) of element (i >> 5) set if box i is inside or intersects, as with Frustum::IsInsideFast(). The mask must have room for (count + 31) / 32 elements.
+URHO3D_API void CullBoundingBoxes(const Frustum& frustum, const Vector3* centers, const Vector3* halfSizes, unsigned count,
+    unsigned* visibleMask);
+/// Test an array of spheres against a frustum. Write a visibility bitmask with bit (i & 31) of element (i >> 5) set if sphere i is inside or intersects, as with Frustum::IsInsideFast(). The mask must have room for (count + 31) / 32 elements.
+URHO3D_API void CullSpheres(const Frustum& frustum, const Sphere* spheres, unsigned count, unsigned* visibleMask);
+
+}
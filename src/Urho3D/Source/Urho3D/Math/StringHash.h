@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../Container/Str.h"
+#include "../Math/MathDefs.h"
 
 namespace Urho3D
 {
@@ -43,7 +44,7 @@ public:
     StringHash(const StringHash& rhs) noexcept = default;
 
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) noexcept :
+    constexpr explicit StringHash(unsigned value) noexcept :
         value_(value)
     {
     }
@@ -100,6 +101,17 @@ public:
 
     /// Calculate hash value case-insensitively from a C string.
     static unsigned Calculate(const char* str, unsigned hash = 0);
+    /// Calculate hash value case-insensitively from a character array of known length.
+    static unsigned Calculate(const char* str, unsigned length, unsigned hash);
+
+    /// Calculate hash value case-insensitively from a C string at compile time. Gives the same result as Calculate(). Intended for string literals through URHO3D_STRINGHASH; recurses once per character.
+    static constexpr unsigned CalculateConstexpr(const char* str, unsigned hash = 0)
+    {
+        return *str ? CalculateConstexpr(str + 1, SDBMHash(hash, ToLowerASCII((unsigned char)*str))) : hash;
+    }
+
+    /// Convert an ASCII character to lowercase. Other characters are returned unchanged.
+    static constexpr unsigned char ToLowerASCII(unsigned char c) { return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c; }
 
     /// Get global StringHashRegister. Use for debug purposes only. Return nullptr if URHO3D_HASH_DEBUG is off.
     static StringHashRegister* GetGlobalStringHashRegister();
@@ -112,4 +124,12 @@ private:
     unsigned value_;
 };
 
+#ifdef URHO3D_HASH_DEBUG
+/// Construct a StringHash from a string literal. In hash debug mode the hash is calculated at runtime so that the string is registered for reversing and collision detection.
+#define URHO3D_STRINGHASH(str) Urho3D::StringHash(str)
+#else
+/// Construct a StringHash from a string literal. The hash is calculated at compile time.
+#define URHO3D_STRINGHASH(str) Urho3D::StringHash(Urho3D::StringHash::CalculateConstexpr(str))
+#endif
+
 }
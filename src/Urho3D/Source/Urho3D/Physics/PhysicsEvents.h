@@ -41,6 +41,37 @@ URHO3D_EVENT(E_PHYSICSPOSTSTEP, PhysicsPostStep)
     URHO3D_PARAM(P_TIMESTEP, TimeStep);            // float
 }
 
+/// Typed payload of the physics pre-step and post-step events, sent by both PhysicsWorld and PhysicsWorld2D.
+class URHO3D_API PhysicsStepEventData : public TypedEventData
+{
+public:
+    /// Construct.
+    explicit PhysicsStepEventData(Object* world = nullptr, float timeStep = 0.0f) :
+        world_(world),
+        timeStep_(timeStep)
+    {
+    }
+
+    /// Write the payload to an event data map.
+    void ToVariantMap(VariantMap& eventData) const override
+    {
+        eventData[PhysicsPreStep::P_WORLD] = world_;
+        eventData[PhysicsPreStep::P_TIMESTEP] = timeStep_;
+    }
+
+    /// Read the payload from an event data map.
+    void FromVariantMap(const VariantMap& eventData) override
+    {
+        world_ = static_cast<Object*>(GetParam(eventData, PhysicsPreStep::P_WORLD).GetPtr());
+        timeStep_ = GetParam(eventData, PhysicsPreStep::P_TIMESTEP).GetFloat();
+    }
+
+    /// Physics world.
+    Object* world_;
+    /// Time step.
+    float timeStep_;
+};
+
 /// Physics collision started. Global event sent by the PhysicsWorld.
 URHO3D_EVENT(E_PHYSICSCOLLISIONSTART, PhysicsCollisionStart)
 {
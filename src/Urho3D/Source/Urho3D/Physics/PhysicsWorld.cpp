@@ -782,30 +782,25 @@ void PhysicsWorld::OnSceneSet(Scene* scene)
     if (scene)
     {
         scene_ = GetScene();
-        SubscribeToEvent(scene_, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(scene_, E_SCENESUBSYSTEMUPDATE, URHO3D_TYPED_HANDLER(PhysicsWorld, HandleSceneSubsystemUpdate));
     }
     else
         UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
 }
 
-void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, SceneUpdateEventData& eventData)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace SceneSubsystemUpdate;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(eventData.timeStep_);
 }
 
 void PhysicsWorld::PreStep(float timeStep)
 {
     // Send pre-step event
-    using namespace PhysicsPreStep;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_WORLD] = this;
-    eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPRESTEP, eventData);
+    PhysicsStepEventData eventData(this, timeStep);
+    SendTypedEvent(E_PHYSICSPRESTEP, eventData);
 
     // Start profiling block for the actual simulation step
 #ifdef URHO3D_PROFILING
@@ -826,12 +821,8 @@ void PhysicsWorld::PostStep(float timeStep)
     SendCollisionEvents();
 
     // Send post-step event
-    using namespace PhysicsPostStep;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_WORLD] = this;
-    eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+    PhysicsStepEventData eventData(this, timeStep);
+    SendTypedEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
 void PhysicsWorld::SendCollisionEvents()
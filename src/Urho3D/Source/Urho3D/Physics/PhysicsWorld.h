@@ -51,6 +51,7 @@ class Node;
 class Ray;
 class RigidBody;
 class Scene;
+class SceneUpdateEventData;
 class Serializer;
 class XMLElement;
 
@@ -292,7 +293,7 @@ protected:
 
 private:
     /// Handle the scene subsystem update event, step simulation here.
-    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneSubsystemUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Trigger update before each physics simulation step.
     void PreStep(float timeStep);
     /// Trigger update after each physics simulation step.
@@ -82,6 +82,9 @@ void BackgroundLoader::ThreadFunction()
             SharedPtr<File> file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
             if (file)
             {
+#ifdef URHO3D_PROFILING
+                AutoProfileBlock profileBlock(owner_->GetSubsystem<Profiler>(), "BackgroundLoadResource");
+#endif
                 resource->SetAsyncLoadState(ASYNC_LOADING);
                 success = resource->BeginLoad(*file);
             }
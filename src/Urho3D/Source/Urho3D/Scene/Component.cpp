@@ -186,7 +186,7 @@ void Component::PrepareNetworkUpdate()
 
         OnGetAttribute(attr, networkState_->currentValues_[i]);
 
-        if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
+        if (!NetworkValuesEqual(attr, networkState_->currentValues_[i], networkState_->previousValues_[i]))
         {
             networkState_->previousValues_[i] = networkState_->currentValues_[i];
 
@@ -27,6 +27,9 @@
 namespace Urho3D
 {
 
+class PhysicsStepEventData;
+class SceneUpdateEventData;
+
 /// Bitmask for using the scene update event.
 static const unsigned char USE_UPDATE = 0x1;
 /// Bitmask for using the scene post-update event.
@@ -86,14 +89,14 @@ private:
     /// Subscribe/unsubscribe to update events based on current enabled state and update event mask.
     void UpdateEventSubscription();
     /// Handle scene update event.
-    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Handle scene post-update event.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData);
 #if defined(URHO3D_PHYSICS) || defined(URHO3D_URHO2D)
     /// Handle physics pre-step event.
-    void HandlePhysicsPreStep(StringHash eventType, VariantMap& eventData);
+    void HandlePhysicsPreStep(StringHash eventType, PhysicsStepEventData& eventData);
     /// Handle physics post-step event.
-    void HandlePhysicsPostStep(StringHash eventType, VariantMap& eventData);
+    void HandlePhysicsPostStep(StringHash eventType, PhysicsStepEventData& eventData);
 #endif
     /// Requested event subscription mask.
     unsigned char updateEventMask_;
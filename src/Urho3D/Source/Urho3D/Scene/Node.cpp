@@ -87,8 +87,9 @@ void Node::RegisterObject(Context* context)
     URHO3D_ATTRIBUTE("Variables", VariantMap, vars_, Variant::emptyVariantMap, AM_FILE); // Network replication of vars uses custom data
     URHO3D_ACCESSOR_ATTRIBUTE("Network Position", GetNetPositionAttr, SetNetPositionAttr, Vector3, Vector3::ZERO,
         AM_NET | AM_LATESTDATA | AM_NOEDIT);
-    URHO3D_ACCESSOR_ATTRIBUTE("Network Rotation", GetNetRotationAttr, SetNetRotationAttr, PODVector<unsigned char>, Variant::emptyBuffer,
-        AM_NET | AM_LATESTDATA | AM_NOEDIT);
+    URHO3D_ACCESSOR_ATTRIBUTE("Network Rotation", GetNetRotationAttr, SetNetRotationAttr, Quaternion, Quaternion::IDENTITY,
+        AM_NET | AM_LATESTDATA | AM_NOEDIT)
+        .SetMetadata(AttributeMetadata::P_QUANTIZATION, AQ_SMALLEST_THREE);
     URHO3D_ACCESSOR_ATTRIBUTE("Network Parent Node", GetNetParentAttr, SetNetParentAttr, PODVector<unsigned char>, Variant::emptyBuffer,
         AM_NET | AM_NOEDIT);
 }
@@ -1455,14 +1456,13 @@ void Node::SetNetPositionAttr(const Vector3& value)
         SetPosition(value);
 }
 
-void Node::SetNetRotationAttr(const PODVector<unsigned char>& value)
+void Node::SetNetRotationAttr(const Quaternion& value)
 {
-    MemoryBuffer buf(value);
     auto* transform = GetComponent<SmoothedTransform>();
     if (transform)
-        transform->SetTargetRotation(buf.ReadPackedQuaternion());
+        transform->SetTargetRotation(value);
     else
-        SetRotation(buf.ReadPackedQuaternion());
+        SetRotation(value);
 }
 
 void Node::SetNetParentAttr(const PODVector<unsigned char>& value)
@@ -1507,11 +1507,9 @@ const Vector3& Node::GetNetPositionAttr() const
     return position_;
 }
 
-const PODVector<unsigned char>& Node::GetNetRotationAttr() const
+const Quaternion& Node::GetNetRotationAttr() const
 {
-    impl_->attrBuffer_.Clear();
-    impl_->attrBuffer_.WritePackedQuaternion(rotation_);
-    return impl_->attrBuffer_.GetBuffer();
+    return rotation_;
 }
 
 const PODVector<unsigned char>& Node::GetNetParentAttr() const
@@ -1715,7 +1713,7 @@ void Node::PrepareNetworkUpdate()
 
         OnGetAttribute(attr, networkState_->currentValues_[i]);
 
-        if (networkState_->currentValues_[i] != networkState_->previousValues_[i])
+        if (!NetworkValuesEqual(attr, networkState_->currentValues_[i], networkState_->previousValues_[i]))
         {
             networkState_->previousValues_[i] = networkState_->currentValues_[i];
 
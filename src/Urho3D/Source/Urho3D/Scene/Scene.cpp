@@ -75,7 +75,7 @@ Scene::Scene(Context* context) :
     SetID(GetFreeNodeID(REPLICATED));
     NodeAdded(this);
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(Scene, HandleUpdate));
+    SubscribeToEvent(E_UPDATE, URHO3D_TYPED_HANDLER(Scene, HandleUpdate));
     SubscribeToEvent(E_RESOURCEBACKGROUNDLOADED, URHO3D_HANDLER(Scene, HandleResourceBackgroundLoaded));
 }
 
@@ -771,20 +771,16 @@ void Scene::Update(float timeStep)
 
     timeStep *= timeScale_;
 
-    using namespace SceneUpdate;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_SCENE] = this;
-    eventData[P_TIMESTEP] = timeStep;
+    SceneUpdateEventData eventData(this, timeStep);
 
     // Update variable timestep logic
-    SendEvent(E_SCENEUPDATE, eventData);
+    SendTypedEvent(E_SCENEUPDATE, eventData);
 
     // Update scene attribute animation.
-    SendEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
+    SendTypedEvent(E_ATTRIBUTEANIMATIONUPDATE, eventData);
 
     // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
-    SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
+    SendTypedEvent(E_SCENESUBSYSTEMUPDATE, eventData);
 
     // Update transform smoothing
     {
@@ -801,7 +797,7 @@ void Scene::Update(float timeStep)
     }
 
     // Post-update variable timestep logic
-    SendEvent(E_SCENEPOSTUPDATE, eventData);
+    SendTypedEvent(E_SCENEPOSTUPDATE, eventData);
 
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
@@ -1161,13 +1157,12 @@ void Scene::MarkReplicationDirty(Node* node)
     }
 }
 
-void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void Scene::HandleUpdate(StringHash eventType, UpdateEventData& eventData)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace Update;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(eventData.timeStep_);
 }
 
 void Scene::HandleResourceBackgroundLoaded(StringHash eventType, VariantMap& eventData)
@@ -1527,6 +1522,22 @@ void Scene::PreloadResourcesJSON(const JSONValue& value)
 #endif
 }
 
+void SceneUpdateEventData::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace SceneUpdate;
+
+    eventData[P_SCENE] = scene_;
+    eventData[P_TIMESTEP] = timeStep_;
+}
+
+void SceneUpdateEventData::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace SceneUpdate;
+
+    scene_ = static_cast<Scene*>(GetParam(eventData, P_SCENE).GetPtr());
+    timeStep_ = GetParam(eventData, P_TIMESTEP).GetFloat();
+}
+
 void RegisterSceneLibrary(Context* context)
 {
     ValueAnimation::RegisterObject(context);
@@ -27,6 +27,8 @@
 namespace Urho3D
 {
 
+class Scene;
+
 /// Variable timestep scene update.
 URHO3D_EVENT(E_SCENEUPDATE, SceneUpdate)
 {
@@ -212,4 +214,26 @@ URHO3D_EVENT(E_INTERCEPTNETWORKUPDATE, InterceptNetworkUpdate)
     URHO3D_PARAM(P_VALUE, Value);                  // Variant
 }
 
+/// Typed payload of the scene update, scene subsystem update, scene attribute animation update and scene post-update events.
+class URHO3D_API SceneUpdateEventData : public TypedEventData
+{
+public:
+    /// Construct.
+    explicit SceneUpdateEventData(Scene* scene = nullptr, float timeStep = 0.0f) :
+        scene_(scene),
+        timeStep_(timeStep)
+    {
+    }
+
+    /// Write the payload to an event data map.
+    void ToVariantMap(VariantMap& eventData) const override;
+    /// Read the payload from an event data map.
+    void FromVariantMap(const VariantMap& eventData) override;
+
+    /// Scene.
+    Scene* scene_;
+    /// Time step, scaled by the scene time scale.
+    float timeStep_;
+};
+
 }
@@ -25,6 +25,7 @@
 #include "../Core/Context.h"
 #include "../IO/Deserializer.h"
 #include "../IO/Log.h"
+#include "../IO/MemoryBuffer.h"
 #include "../IO/Serializer.h"
 #include "../Resource/XMLElement.h"
 #include "../Resource/JSONValue.h"
@@ -37,6 +38,14 @@
 namespace Urho3D
 {
 
+namespace AttributeMetadata
+{
+
+extern URHO3D_API const StringHash P_QUANTIZATION(URHO3D_STRINGHASH("Quantization"));
+extern URHO3D_API const StringHash P_QUANTIZATION_RANGE(URHO3D_STRINGHASH("QuantizationRange"));
+
+}
+
 static unsigned RemapAttributeIndex(const Vector<AttributeInfo>* attributes, const AttributeInfo& netAttr, unsigned netAttrIndex)
 {
     if (!attributes)
@@ -53,6 +62,215 @@ static unsigned RemapAttributeIndex(const Vector<AttributeInfo>* attributes, con
     return netAttrIndex; // Could not remap
 }
 
+/// Return the quantized encoding of an attribute, or AQ_NONE if the declared encoding does not apply to its type. Return the fixed point range if applicable.
+static AttributeQuantization GetAttributeQuantization(const AttributeInfo& attr, float& range)
+{
+    if (attr.metadata_.Empty())
+        return AQ_NONE;
+
+    switch (attr.GetMetadata(AttributeMetadata::P_QUANTIZATION).GetInt())
+    {
+    case AQ_HALF:
+        switch (attr.type_)
+        {
+        case VAR_FLOAT:
+        case VAR_VECTOR2:
+        case VAR_VECTOR3:
+        case VAR_VECTOR4:
+        case VAR_QUATERNION:
+        case VAR_COLOR:
+            return AQ_HALF;
+
+        default:
+            return AQ_NONE;
+        }
+
+    case AQ_SMALLEST_THREE:
+        return attr.type_ == VAR_QUATERNION ? AQ_SMALLEST_THREE : AQ_NONE;
+
+    case AQ_FIXED:
+        range = attr.GetMetadata(AttributeMetadata::P_QUANTIZATION_RANGE).GetFloat();
+        if (range > 0.0f && (attr.type_ == VAR_FLOAT || attr.type_ == VAR_VECTOR2 || attr.type_ == VAR_VECTOR3))
+            return AQ_FIXED;
+        return AQ_NONE;
+
+    default:
+        return AQ_NONE;
+    }
+}
+
+/// Return number of float components in a value type.
+static unsigned GetNumFloatComponents(VariantType type)
+{
+    switch (type)
+    {
+    case VAR_FLOAT:
+        return 1;
+
+    case VAR_VECTOR2:
+        return 2;
+
+    case VAR_VECTOR3:
+        return 3;
+
+    default:
+        return 4;
+    }
+}
+
+/// Copy the float components of a value.
+static void GetFloatComponents(const Variant& value, VariantType type, float* dest)
+{
+    const float* data;
+    float floatValue;
+
+    switch (type)
+    {
+    case VAR_FLOAT:
+        floatValue = value.GetFloat();
+        data = &floatValue;
+        break;
+
+    case VAR_VECTOR2:
+        data = value.GetVector2().Data();
+        break;
+
+    case VAR_VECTOR3:
+        data = value.GetVector3().Data();
+        break;
+
+    case VAR_VECTOR4:
+        data = value.GetVector4().Data();
+        break;
+
+    case VAR_QUATERNION:
+        data = value.GetQuaternion().Data();
+        break;
+
+    default:
+        data = value.GetColor().Data();
+        break;
+    }
+
+    for (unsigned i = 0; i < GetNumFloatComponents(type); ++i)
+        dest[i] = data[i];
+}
+
+/// Construct a value from float components.
+static Variant MakeVariantFromFloatComponents(VariantType type, const float* data)
+{
+    switch (type)
+    {
+    case VAR_FLOAT:
+        return data[0];
+
+    case VAR_VECTOR2:
+        return Vector2(data);
+
+    case VAR_VECTOR3:
+        return Vector3(data);
+
+    case VAR_VECTOR4:
+        return Vector4(data);
+
+    case VAR_QUATERNION:
+        return Quaternion(data).Normalized();
+
+    default:
+        return Color(data);
+    }
+}
+
+/// Write an attribute value for binary serialization or network replication, quantized if the attribute metadata declares it.
+static bool WriteAttributeData(Serializer& dest, const AttributeInfo& attr, const Variant& value)
+{
+    float range = 0.0f;
+    AttributeQuantization quantization = GetAttributeQuantization(attr, range);
+    if (quantization == AQ_NONE)
+        return dest.WriteVariantData(value);
+    if (quantization == AQ_SMALLEST_THREE)
+        return dest.WriteSmallestThreeQuaternion(value.GetQuaternion());
+
+    float components[4];
+    unsigned numComponents = GetNumFloatComponents(attr.type_);
+    GetFloatComponents(value, attr.type_, components);
+
+    unsigned short quantized[4];
+    if (quantization == AQ_HALF)
+    {
+        for (unsigned i = 0; i < numComponents; ++i)
+            quantized[i] = FloatToHalf(components[i]);
+    }
+    else
+    {
+        float scale = 32767.0f / range;
+        for (unsigned i = 0; i < numComponents; ++i)
+            quantized[i] = (unsigned short)(short)Round(Clamp(components[i], -range, range) * scale);
+    }
+
+    unsigned size = numComponents * sizeof(unsigned short);
+    return dest.Write(quantized, size) == size;
+}
+
+/// Read an attribute value written by WriteAttributeData(). Return false if the quantized data is truncated.
+static bool ReadAttributeData(Deserializer& source, const AttributeInfo& attr, Variant& value)
+{
+    float range = 0.0f;
+    AttributeQuantization quantization = GetAttributeQuantization(attr, range);
+    if (quantization == AQ_NONE)
+    {
+        value = source.ReadVariant(attr.type_);
+        return true;
+    }
+
+    unsigned numComponents = GetNumFloatComponents(attr.type_);
+    unsigned size = quantization == AQ_SMALLEST_THREE ? 6 : numComponents * (unsigned)sizeof(unsigned short);
+    if (source.GetPosition() + size > source.GetSize())
+        return false;
+
+    if (quantization == AQ_SMALLEST_THREE)
+    {
+        value = source.ReadSmallestThreeQuaternion();
+        return true;
+    }
+
+    unsigned short quantized[4];
+    if (source.Read(quantized, size) != size)
+        return false;
+
+    float components[4];
+    if (quantization == AQ_HALF)
+    {
+        for (unsigned i = 0; i < numComponents; ++i)
+            components[i] = HalfToFloat(quantized[i]);
+    }
+    else
+    {
+        float scale = range / 32767.0f;
+        for (unsigned i = 0; i < numComponents; ++i)
+            components[i] = (short)quantized[i] * scale;
+    }
+
+    value = MakeVariantFromFloatComponents(attr.type_, components);
+    return true;
+}
+
+bool Serializable::NetworkValuesEqual(const AttributeInfo& attr, const Variant& lhs, const Variant& rhs)
+{
+    float range = 0.0f;
+    if (GetAttributeQuantization(attr, range) == AQ_NONE || lhs.GetType() != rhs.GetType())
+        return lhs == rhs;
+
+    // The quantized encodings take at most 8 bytes
+    unsigned char lhsData[8];
+    unsigned char rhsData[8];
+    MemoryBuffer lhsBuffer(lhsData, sizeof lhsData);
+    MemoryBuffer rhsBuffer(rhsData, sizeof rhsData);
+    WriteAttributeData(lhsBuffer, attr, lhs);
+    WriteAttributeData(rhsBuffer, attr, rhs);
+    return lhsBuffer.GetPosition() == rhsBuffer.GetPosition() && !memcmp(lhsData, rhsData, lhsBuffer.GetPosition());
+}
+
 Serializable::Serializable(Context* context) :
     Object(context),
     setInstanceDefault_(false),
@@ -308,7 +526,12 @@ bool Serializable::Load(Deserializer& source)
             return false;
         }
 
-        Variant varValue = source.ReadVariant(attr.type_);
+        Variant varValue;
+        if (!ReadAttributeData(source, attr, varValue))
+        {
+            URHO3D_LOGERROR("Could not load " + GetTypeName() + ", attribute " + attr.name_ + " is truncated");
+            return false;
+        }
         OnSetAttribute(attr, varValue);
     }
 
@@ -331,7 +554,7 @@ bool Serializable::Save(Serializer& dest) const
 
         OnGetAttribute(attr, value);
 
-        if (!dest.WriteVariantData(value))
+        if (!WriteAttributeData(dest, attr, value))
         {
             URHO3D_LOGERROR("Could not save " + GetTypeName() + ", writing to stream failed");
             return false;
@@ -764,7 +987,7 @@ void Serializable::WriteInitialDeltaUpdate(Serializer& dest, unsigned char timeS
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteAttributeData(dest, attributes->At(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -790,7 +1013,7 @@ void Serializable::WriteDeltaUpdate(Serializer& dest, const DirtyBits& attribute
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributeBits.IsSet(i))
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteAttributeData(dest, attributes->At(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -813,7 +1036,7 @@ void Serializable::WriteLatestDataUpdate(Serializer& dest, unsigned char timeSta
     for (unsigned i = 0; i < numAttributes; ++i)
     {
         if (attributes->At(i).mode_ & AM_LATESTDATA)
-            dest.WriteVariantData(networkState_->currentValues_[i]);
+            WriteAttributeData(dest, attributes->At(i), networkState_->currentValues_[i]);
     }
 }
 
@@ -836,9 +1059,16 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
         if (attributeBits.IsSet(i))
         {
             const AttributeInfo& attr = attributes->At(i);
+            Variant value;
+            if (!ReadAttributeData(source, attr, value))
+            {
+                URHO3D_LOGERROR("Truncated network update for " + GetTypeName() + " attribute " + attr.name_);
+                break;
+            }
+
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, value);
                 changed = true;
             }
             else
@@ -850,7 +1080,7 @@ bool Serializable::ReadDeltaUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = value;
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
@@ -876,9 +1106,16 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
         const AttributeInfo& attr = attributes->At(i);
         if (attr.mode_ & AM_LATESTDATA)
         {
+            Variant value;
+            if (!ReadAttributeData(source, attr, value))
+            {
+                URHO3D_LOGERROR("Truncated network update for " + GetTypeName() + " attribute " + attr.name_);
+                break;
+            }
+
             if (!(interceptMask & (1ULL << i)))
             {
-                OnSetAttribute(attr, source.ReadVariant(attr.type_));
+                OnSetAttribute(attr, value);
                 changed = true;
             }
             else
@@ -890,7 +1127,7 @@ bool Serializable::ReadLatestDataUpdate(Deserializer& source)
                 eventData[P_TIMESTAMP] = (unsigned)timeStamp;
                 eventData[P_INDEX] = RemapAttributeIndex(GetAttributes(), attr, i);
                 eventData[P_NAME] = attr.name_;
-                eventData[P_VALUE] = source.ReadVariant(attr.type_);
+                eventData[P_VALUE] = value;
                 SendEvent(E_INTERCEPTNETWORKUPDATE, eventData);
             }
         }
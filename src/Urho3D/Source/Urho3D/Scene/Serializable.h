@@ -131,6 +131,9 @@ public:
     NetworkState* GetNetworkState() const { return networkState_.Get(); }
 
 protected:
+    /// Return whether two values of an attribute are equal once encoded for network replication. Quantized attributes compare their quantized encodings, so that changes the encoding can not represent do not mark the attribute dirty.
+    static bool NetworkValuesEqual(const AttributeInfo& attr, const Variant& lhs, const Variant& rhs);
+
     /// Network attribute state.
     UniquePtr<NetworkState> networkState_;
 
@@ -219,11 +222,28 @@ SharedPtr<AttributeAccessor> MakeVariantAttributeAccessor(TGetFunction getFuncti
     [](const ClassName& self, Urho3D::Variant& value) { value = static_cast<int>(self.getFunction()); }, \
     [](ClassName& self, const Urho3D::Variant& value) { self.setFunction(static_cast<typeName>(value.Get<int>())); })
 
+/// Compact encoding of attribute values in binary serialization and network replication, declared with the P_QUANTIZATION attribute metadata. Changing the encoding of an attribute invalidates binary files saved with the previous encoding.
+enum AttributeQuantization
+{
+    /// Full precision.
+    AQ_NONE = 0,
+    /// 16-bit half floats, for float, Vector2, Vector3, Vector4, Quaternion and Color attributes. About three significant digits and magnitudes up to 65504.
+    AQ_HALF,
+    /// Smallest three components of a normalized Quaternion attribute in 15 bits each, 6 bytes in total.
+    AQ_SMALLEST_THREE,
+    /// 16-bit fixed point within the range given by the P_QUANTIZATION_RANGE metadata, for float, Vector2 and Vector3 attributes.
+    AQ_FIXED
+};
+
 /// Attribute metadata.
 namespace AttributeMetadata
 {
     /// Names of vector struct elements. StringVector.
     static const StringHash P_VECTOR_STRUCT_ELEMENTS("VectorStructElements");
+    /// Quantized encoding of the attribute in binary serialization and network replication. Int, AttributeQuantization value. Attribute types the encoding does not apply to are written in full precision.
+    extern URHO3D_API const StringHash P_QUANTIZATION;
+    /// Maximum absolute value of fixed point quantized components. Float. Fixed point quantization is not applied without a positive range.
+    extern URHO3D_API const StringHash P_QUANTIZATION_RANGE;
 }
 
 // The following macros need to be used within a class member function such as ClassName::RegisterObject().
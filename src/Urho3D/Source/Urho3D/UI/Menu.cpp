@@ -36,7 +36,7 @@
 namespace Urho3D
 {
 
-const StringHash VAR_SHOW_POPUP("ShowPopup");
+const StringHash VAR_SHOW_POPUP(URHO3D_STRINGHASH("ShowPopup"));
 extern StringHash VAR_ORIGIN;
 
 extern const char* UI_CATEGORY;
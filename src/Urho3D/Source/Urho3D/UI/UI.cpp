@@ -73,9 +73,9 @@ namespace Urho3D
 {
 
 StringHash VAR_ORIGIN("Origin");
-const StringHash VAR_ORIGINAL_PARENT("OriginalParent");
-const StringHash VAR_ORIGINAL_CHILD_INDEX("OriginalChildIndex");
-const StringHash VAR_PARENT_CHANGED("ParentChanged");
+const StringHash VAR_ORIGINAL_PARENT(URHO3D_STRINGHASH("OriginalParent"));
+const StringHash VAR_ORIGINAL_CHILD_INDEX(URHO3D_STRINGHASH("OriginalChildIndex"));
+const StringHash VAR_PARENT_CHANGED(URHO3D_STRINGHASH("ParentChanged"));
 
 const float DEFAULT_DOUBLECLICK_INTERVAL = 0.5f;
 const float DEFAULT_DRAGBEGIN_INTERVAL = 0.5f;
@@ -50,6 +50,7 @@ namespace Spriter
 }
 
 class AnimationSet2D;
+class SceneUpdateEventData;
 
 /// Animated sprite component, it uses to play animation created by Spine (http://www.esotericsoftware.com) and Spriter (http://www.brashmonkey.com/).
 class URHO3D_API AnimatedSprite2D : public StaticSprite2D
@@ -102,7 +103,7 @@ protected:
     /// Handle update vertices.
     void UpdateSourceBatches() override;
     /// Handle scene post update.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Update animation.
     void UpdateAnimation(float timeStep);
 #ifdef URHO3D_SPINE
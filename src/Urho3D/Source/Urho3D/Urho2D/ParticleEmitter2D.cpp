@@ -80,7 +80,7 @@ void ParticleEmitter2D::OnSetEnabled()
     if (scene)
     {
         if (IsEnabledEffective())
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ParticleEmitter2D, HandleScenePostUpdate));
+            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_TYPED_HANDLER(ParticleEmitter2D, HandleScenePostUpdate));
         else
             UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
     }
@@ -174,6 +174,20 @@ void ParticleEmitter2D::SetEmitting(bool enable)
     }
 }
 
+void ParticleEmitter2D::RemoveAllParticles()
+{
+    numParticles_ = 0;
+    sourceBatchesDirty_ = true;
+}
+
+void ParticleEmitter2D::Reset()
+{
+    RemoveAllParticles();
+    emitting_ = true;
+    emitParticleTime_ = 0.0f;
+    emissionTime_ = effect_ ? effect_->GetDuration() : 0.0f;
+}
+
 ResourceRef ParticleEmitter2D::GetSpriteAttr() const
 {
     return Sprite2D::SaveToResourceRef(sprite_);
@@ -184,7 +198,7 @@ void ParticleEmitter2D::OnSceneSet(Scene* scene)
     Drawable2D::OnSceneSet(scene);
 
     if (scene && IsEnabledEffective())
-        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(ParticleEmitter2D, HandleScenePostUpdate));
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_TYPED_HANDLER(ParticleEmitter2D, HandleScenePostUpdate));
     else if (!scene)
         UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
 }
@@ -272,12 +286,11 @@ void ParticleEmitter2D::UpdateMaterial()
         sourceBatches_[0].material_ = nullptr;
 }
 
-void ParticleEmitter2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+void ParticleEmitter2D::HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData)
 {
-    using namespace ScenePostUpdate;
     bool hasParticles = numParticles_ > 0;
     bool emitting = emissionTime_ > 0.0f;
-    float timeStep = eventData[P_TIMESTEP].GetFloat();
+    float timeStep = eventData.timeStep_;
     Update(timeStep);
 
     if (emitting && emissionTime_ == 0.0f)
@@ -28,6 +28,7 @@ namespace Urho3D
 {
 
 class ParticleEffect2D;
+class SceneUpdateEventData;
 class Sprite2D;
 
 /// 2D particle.
@@ -98,6 +99,10 @@ public:
     void SetMaxParticles(unsigned maxParticles);
     /// Set whether should be emitting. If the state was changed, also resets the emission period timer.
     void SetEmitting(bool enable);
+    /// Remove all current particles.
+    void RemoveAllParticles();
+    /// Reset the particle emitter completely. Removes current particles, sets emitting state on, and restarts the effect's emission period.
+    void Reset();
 
     /// Return particle effect.
     ParticleEffect2D* GetEffect() const;
@@ -133,7 +138,7 @@ private:
     /// Update material.
     void UpdateMaterial();
     /// Handle scene post update.
-    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleScenePostUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Update.
     void Update(float timeStep);
     /// Emit particle.
@@ -31,6 +31,11 @@
 namespace Urho3D
 {
 
+class CollisionShape2D;
+class Node;
+class PhysicsWorld2D;
+class RigidBody2D;
+
 /// Physics update contact. Global event sent by PhysicsWorld2D.
 URHO3D_EVENT(E_PHYSICSUPDATECONTACT2D, PhysicsUpdateContact2D)
 {
@@ -105,4 +110,54 @@ URHO3D_EVENT(E_NODEENDCONTACT2D, NodeEndContact2D)
     URHO3D_PARAM(P_OTHERSHAPE, OtherShape);        // CollisionShape2D pointer
 }
 
+/// Typed payload of the physics begin contact and end contact events. Objects are held by weak pointers, as receivers may remove them during the event.
+class URHO3D_API PhysicsContact2DEventData : public TypedEventData
+{
+public:
+    /// Write the payload to an event data map.
+    void ToVariantMap(VariantMap& eventData) const override;
+    /// Read the payload from an event data map.
+    void FromVariantMap(const VariantMap& eventData) override;
+
+    /// Physics world.
+    WeakPtr<PhysicsWorld2D> world_;
+    /// Rigid body A.
+    WeakPtr<RigidBody2D> bodyA_;
+    /// Rigid body B.
+    WeakPtr<RigidBody2D> bodyB_;
+    /// Node A.
+    WeakPtr<Node> nodeA_;
+    /// Node B.
+    WeakPtr<Node> nodeB_;
+    /// Collision shape A.
+    WeakPtr<CollisionShape2D> shapeA_;
+    /// Collision shape B.
+    WeakPtr<CollisionShape2D> shapeB_;
+    /// Contact points, in the same format as the event data buffer. Valid only during the event.
+    const PODVector<unsigned char>* contacts_{};
+};
+
+/// Typed payload of the node begin contact and end contact events. Objects are held by weak pointers, as receivers may remove them during the event.
+class URHO3D_API NodeContact2DEventData : public TypedEventData
+{
+public:
+    /// Write the payload to an event data map.
+    void ToVariantMap(VariantMap& eventData) const override;
+    /// Read the payload from an event data map.
+    void FromVariantMap(const VariantMap& eventData) override;
+
+    /// Rigid body of the node.
+    WeakPtr<RigidBody2D> body_;
+    /// Other node.
+    WeakPtr<Node> otherNode_;
+    /// Rigid body of the other node.
+    WeakPtr<RigidBody2D> otherBody_;
+    /// Collision shape of the node.
+    WeakPtr<CollisionShape2D> shape_;
+    /// Collision shape of the other node.
+    WeakPtr<CollisionShape2D> otherShape_;
+    /// Contact points, in the same format as the event data buffer. Valid only during the event.
+    const PODVector<unsigned char>* contacts_{};
+};
+
 }
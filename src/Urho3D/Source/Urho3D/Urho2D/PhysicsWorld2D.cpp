@@ -280,12 +280,8 @@ void PhysicsWorld2D::Update(float timeStep)
 {
     URHO3D_PROFILE(UpdatePhysics2D);
 
-    using namespace PhysicsPreStep;
-
-    VariantMap& eventData = GetEventDataMap();
-    eventData[P_WORLD] = this;
-    eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPRESTEP, eventData);
+    PhysicsStepEventData eventData(this, timeStep);
+    SendTypedEvent(E_PHYSICSPRESTEP, eventData);
 
     physicsStepping_ = true;
     world_->Step(timeStep, velocityIterations_, positionIterations_);
@@ -328,8 +324,7 @@ void PhysicsWorld2D::Update(float timeStep)
     SendBeginContactEvents();
     SendEndContactEvents();
 
-    using namespace PhysicsPostStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+    SendTypedEvent(E_PHYSICSPOSTSTEP, eventData);
 }
 
 void PhysicsWorld2D::DrawDebugGeometry()
@@ -706,18 +701,17 @@ void PhysicsWorld2D::OnSceneSet(Scene* scene)
 {
     // Subscribe to the scene subsystem update, which will trigger the physics simulation step
     if (scene)
-        SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_HANDLER(PhysicsWorld2D, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(scene, E_SCENESUBSYSTEMUPDATE, URHO3D_TYPED_HANDLER(PhysicsWorld2D, HandleSceneSubsystemUpdate));
     else
         UnsubscribeFromEvent(E_SCENESUBSYSTEMUPDATE);
 }
 
-void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData)
+void PhysicsWorld2D::HandleSceneSubsystemUpdate(StringHash eventType, SceneUpdateEventData& eventData)
 {
     if (!updateEnabled_)
         return;
 
-    using namespace SceneSubsystemUpdate;
-    Update(eventData[P_TIMESTEP].GetFloat());
+    Update(eventData.timeStep_);
 }
 
 void PhysicsWorld2D::SendBeginContactEvents()
@@ -725,46 +719,45 @@ void PhysicsWorld2D::SendBeginContactEvents()
     if (beginContactInfos_.Empty())
         return;
 
-    using namespace PhysicsBeginContact2D;
-    VariantMap& eventData = GetEventDataMap();
-    VariantMap nodeEventData;
-    eventData[P_WORLD] = this;
+    PhysicsContact2DEventData eventData;
+    NodeContact2DEventData nodeEventData;
+    eventData.world_ = this;
 
     for (unsigned i = 0; i < beginContactInfos_.Size(); ++i)
     {
         ContactInfo& contactInfo = beginContactInfos_[i];
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
+        eventData.bodyA_ = contactInfo.bodyA_.Get();
+        eventData.bodyB_ = contactInfo.bodyB_.Get();
+        eventData.nodeA_ = contactInfo.nodeA_.Get();
+        eventData.nodeB_ = contactInfo.nodeB_.Get();
+        eventData.contacts_ = &contactInfo.Serialize(contacts_);
+        eventData.shapeA_ = contactInfo.shapeA_.Get();
+        eventData.shapeB_ = contactInfo.shapeB_.Get();
 
-        SendEvent(E_PHYSICSBEGINCONTACT2D, eventData);
+        SendTypedEvent(E_PHYSICSBEGINCONTACT2D, eventData);
 
-        nodeEventData[NodeBeginContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodeEventData.contacts_ = eventData.contacts_;
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodeEventData.body_ = contactInfo.bodyA_.Get();
+            nodeEventData.otherNode_ = contactInfo.nodeB_.Get();
+            nodeEventData.otherBody_ = contactInfo.bodyB_.Get();
+            nodeEventData.shape_ = contactInfo.shapeA_.Get();
+            nodeEventData.otherShape_ = contactInfo.shapeB_.Get();
 
-            contactInfo.nodeA_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
+            contactInfo.nodeA_->SendTypedEvent(E_NODEBEGINCONTACT2D, nodeEventData);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeBeginContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeBeginContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeBeginContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodeEventData.body_ = contactInfo.bodyB_.Get();
+            nodeEventData.otherNode_ = contactInfo.nodeA_.Get();
+            nodeEventData.otherBody_ = contactInfo.bodyA_.Get();
+            nodeEventData.shape_ = contactInfo.shapeB_.Get();
+            nodeEventData.otherShape_ = contactInfo.shapeA_.Get();
 
-            contactInfo.nodeB_->SendEvent(E_NODEBEGINCONTACT2D, nodeEventData);
+            contactInfo.nodeB_->SendTypedEvent(E_NODEBEGINCONTACT2D, nodeEventData);
         }
     }
 
@@ -776,46 +769,45 @@ void PhysicsWorld2D::SendEndContactEvents()
     if (endContactInfos_.Empty())
         return;
 
-    using namespace PhysicsEndContact2D;
-    VariantMap& eventData = GetEventDataMap();
-    VariantMap nodeEventData;
-    eventData[P_WORLD] = this;
+    PhysicsContact2DEventData eventData;
+    NodeContact2DEventData nodeEventData;
+    eventData.world_ = this;
 
     for (unsigned i = 0; i < endContactInfos_.Size(); ++i)
     {
         ContactInfo& contactInfo = endContactInfos_[i];
-        eventData[P_BODYA] = contactInfo.bodyA_.Get();
-        eventData[P_BODYB] = contactInfo.bodyB_.Get();
-        eventData[P_NODEA] = contactInfo.nodeA_.Get();
-        eventData[P_NODEB] = contactInfo.nodeB_.Get();
-        eventData[P_CONTACTS] = contactInfo.Serialize(contacts_);
-        eventData[P_SHAPEA] = contactInfo.shapeA_.Get();
-        eventData[P_SHAPEB] = contactInfo.shapeB_.Get();
+        eventData.bodyA_ = contactInfo.bodyA_.Get();
+        eventData.bodyB_ = contactInfo.bodyB_.Get();
+        eventData.nodeA_ = contactInfo.nodeA_.Get();
+        eventData.nodeB_ = contactInfo.nodeB_.Get();
+        eventData.contacts_ = &contactInfo.Serialize(contacts_);
+        eventData.shapeA_ = contactInfo.shapeA_.Get();
+        eventData.shapeB_ = contactInfo.shapeB_.Get();
 
-        SendEvent(E_PHYSICSENDCONTACT2D, eventData);
+        SendTypedEvent(E_PHYSICSENDCONTACT2D, eventData);
 
-        nodeEventData[NodeEndContact2D::P_CONTACTS] = contactInfo.Serialize(contacts_);
+        nodeEventData.contacts_ = eventData.contacts_;
 
         if (contactInfo.nodeA_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeB_.Get();
+            nodeEventData.body_ = contactInfo.bodyA_.Get();
+            nodeEventData.otherNode_ = contactInfo.nodeB_.Get();
+            nodeEventData.otherBody_ = contactInfo.bodyB_.Get();
+            nodeEventData.shape_ = contactInfo.shapeA_.Get();
+            nodeEventData.otherShape_ = contactInfo.shapeB_.Get();
 
-            contactInfo.nodeA_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
+            contactInfo.nodeA_->SendTypedEvent(E_NODEENDCONTACT2D, nodeEventData);
         }
 
         if (contactInfo.nodeB_)
         {
-            nodeEventData[NodeEndContact2D::P_BODY] = contactInfo.bodyB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERNODE] = contactInfo.nodeA_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERBODY] = contactInfo.bodyA_.Get();
-            nodeEventData[NodeEndContact2D::P_SHAPE] = contactInfo.shapeB_.Get();
-            nodeEventData[NodeEndContact2D::P_OTHERSHAPE] = contactInfo.shapeA_.Get();
+            nodeEventData.body_ = contactInfo.bodyB_.Get();
+            nodeEventData.otherNode_ = contactInfo.nodeA_.Get();
+            nodeEventData.otherBody_ = contactInfo.bodyA_.Get();
+            nodeEventData.shape_ = contactInfo.shapeB_.Get();
+            nodeEventData.otherShape_ = contactInfo.shapeA_.Get();
 
-            contactInfo.nodeB_->SendEvent(E_NODEENDCONTACT2D, nodeEventData);
+            contactInfo.nodeB_->SendTypedEvent(E_NODEENDCONTACT2D, nodeEventData);
         }
     }
 
@@ -858,4 +850,56 @@ const Urho3D::PODVector<unsigned char>& PhysicsWorld2D::ContactInfo::Serialize(V
     return buffer.GetBuffer();
 }
 
+void PhysicsContact2DEventData::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace PhysicsBeginContact2D;
+
+    eventData[P_WORLD] = world_.Get();
+    eventData[P_BODYA] = bodyA_.Get();
+    eventData[P_BODYB] = bodyB_.Get();
+    eventData[P_NODEA] = nodeA_.Get();
+    eventData[P_NODEB] = nodeB_.Get();
+    eventData[P_CONTACTS] = contacts_ ? *contacts_ : Variant::emptyBuffer;
+    eventData[P_SHAPEA] = shapeA_.Get();
+    eventData[P_SHAPEB] = shapeB_.Get();
+}
+
+void PhysicsContact2DEventData::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace PhysicsBeginContact2D;
+
+    world_ = static_cast<PhysicsWorld2D*>(GetParam(eventData, P_WORLD).GetPtr());
+    bodyA_ = static_cast<RigidBody2D*>(GetParam(eventData, P_BODYA).GetPtr());
+    bodyB_ = static_cast<RigidBody2D*>(GetParam(eventData, P_BODYB).GetPtr());
+    nodeA_ = static_cast<Node*>(GetParam(eventData, P_NODEA).GetPtr());
+    nodeB_ = static_cast<Node*>(GetParam(eventData, P_NODEB).GetPtr());
+    contacts_ = &GetParam(eventData, P_CONTACTS).GetBuffer();
+    shapeA_ = static_cast<CollisionShape2D*>(GetParam(eventData, P_SHAPEA).GetPtr());
+    shapeB_ = static_cast<CollisionShape2D*>(GetParam(eventData, P_SHAPEB).GetPtr());
+}
+
+void NodeContact2DEventData::ToVariantMap(VariantMap& eventData) const
+{
+    using namespace NodeBeginContact2D;
+
+    eventData[P_BODY] = body_.Get();
+    eventData[P_OTHERNODE] = otherNode_.Get();
+    eventData[P_OTHERBODY] = otherBody_.Get();
+    eventData[P_CONTACTS] = contacts_ ? *contacts_ : Variant::emptyBuffer;
+    eventData[P_SHAPE] = shape_.Get();
+    eventData[P_OTHERSHAPE] = otherShape_.Get();
+}
+
+void NodeContact2DEventData::FromVariantMap(const VariantMap& eventData)
+{
+    using namespace NodeBeginContact2D;
+
+    body_ = static_cast<RigidBody2D*>(GetParam(eventData, P_BODY).GetPtr());
+    otherNode_ = static_cast<Node*>(GetParam(eventData, P_OTHERNODE).GetPtr());
+    otherBody_ = static_cast<RigidBody2D*>(GetParam(eventData, P_OTHERBODY).GetPtr());
+    contacts_ = &GetParam(eventData, P_CONTACTS).GetBuffer();
+    shape_ = static_cast<CollisionShape2D*>(GetParam(eventData, P_SHAPE).GetPtr());
+    otherShape_ = static_cast<CollisionShape2D*>(GetParam(eventData, P_OTHERSHAPE).GetPtr());
+}
+
 }
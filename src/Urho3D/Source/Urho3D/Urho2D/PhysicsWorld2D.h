@@ -33,6 +33,7 @@ namespace Urho3D
 class Camera;
 class CollisionShape2D;
 class RigidBody2D;
+class SceneUpdateEventData;
 
 /// 2D Physics raycast hit.
 struct URHO3D_API PhysicsRaycastResult2D
@@ -210,7 +211,7 @@ protected:
     void OnSceneSet(Scene* scene) override;
 
     /// Handle the scene subsystem update event, step simulation here.
-    void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneSubsystemUpdate(StringHash eventType, SceneUpdateEventData& eventData);
     /// Send begin contact events.
     void SendBeginContactEvents();
     /// Send end contact events.
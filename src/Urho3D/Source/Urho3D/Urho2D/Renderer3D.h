@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "../Container/FrameAllocator.h"
 #include "../Graphics/Drawable.h"
 #include "../Math/Frustum.h"
 
@@ -52,8 +53,8 @@ struct ViewBatchInfo3D
     SharedPtr<VertexBuffer> vertexBuffer_;
     /// Batch updated frame number.
     unsigned batchUpdatedFrameNumber_;
-    /// Source batches.
-    PODVector<const SourceBatch3D*> sourceBatches_;
+    /// Source batches. Rebuilt every frame in frame allocator memory.
+    FramePODVector<const SourceBatch3D*> sourceBatches_;
     /// Batch count;
     unsigned batchCount_;
     /// Distances.